@@ -37,40 +37,175 @@
 
 #include <string.h>
 
+/* Output is accumulated and written out in blocks of about this size,
+ * rather than with one stream write per element.
+ */
+#define DUMP_BUFFER_SIZE (64 * 1024)
+
+/* The binary format is the same tree as the XML one, written as this
+ * magic followed by a sequence of records.  Each record is a single
+ * byte, followed by strings stored as their length (32 bit, little
+ * endian) and their UTF-8 data, without a terminating nul:
+ *
+ *   '<' name         start of an element
+ *   '=' name value   attribute of the current element
+ *   '>'              end of the current element
+ */
+#define DUMP_BINARY_MAGIC "GIDUMP\0\1"
+#define DUMP_BINARY_MAGIC_LEN 8
+
+typedef struct {
+  GOutputStream *stream;
+  GString *buffer;
+  gboolean binary;
+  guint depth;
+  gboolean in_start_tag;
+} DumpOutput;
+
 static void
-escaped_printf (GOutputStream *out, const char *fmt, ...) G_GNUC_PRINTF (2, 3);
+dump_output_init (DumpOutput *out, GOutputStream *stream, gboolean binary)
+{
+  out->stream = stream;
+  out->buffer = g_string_sized_new (DUMP_BUFFER_SIZE);
+  out->binary = binary;
+  out->depth = 0;
+  out->in_start_tag = FALSE;
+}
 
 static void
-escaped_printf (GOutputStream *out, const char *fmt, ...)
+dump_output_write_header (DumpOutput *out)
+{
+  if (out->binary)
+    g_string_append_len (out->buffer, DUMP_BINARY_MAGIC, DUMP_BINARY_MAGIC_LEN);
+  else
+    g_string_append (out->buffer, "<?xml version=\"1.0\"?>\n");
+}
+
+static gboolean
+dump_output_flush (DumpOutput *out, GError **error)
 {
-  char *str;
-  va_list args;
   gsize written;
+  gboolean ret = TRUE;
+
+  if (out->buffer->len > 0)
+    ret = g_output_stream_write_all (out->stream, out->buffer->str, out->buffer->len,
+                                     &written, NULL, error);
+  g_string_truncate (out->buffer, 0);
+
+  return ret;
+}
+
+static void
+dump_output_free (DumpOutput *out)
+{
+  g_string_free (out->buffer, TRUE);
+}
+
+static void
+dump_output_maybe_flush (DumpOutput *out)
+{
   GError *error = NULL;
 
-  va_start (args, fmt);
+  if (out->buffer->len < DUMP_BUFFER_SIZE)
+    return;
 
-  str = g_markup_vprintf_escaped (fmt, args);
-  if (!g_output_stream_write_all (out, str, strlen (str), &written, NULL, &error))
+  if (!dump_output_flush (out, &error))
     {
       g_critical ("failed to write to iochannel: %s", error->message);
       g_clear_error (&error);
     }
-  g_free (str);
+}
 
-  va_end (args);
+static void
+dump_binary_string (DumpOutput *out, const char *str)
+{
+  gsize len = strlen (str);
+  guint32 len_le = GUINT32_TO_LE ((guint32) len);
+
+  g_string_append_len (out->buffer, (const char *) &len_le, sizeof (len_le));
+  g_string_append_len (out->buffer, str, len);
 }
 
 static void
-goutput_write (GOutputStream *out, const char *str)
+dump_start_element (DumpOutput *out, const char *name)
 {
-  gsize written;
-  GError *error = NULL;
-  if (!g_output_stream_write_all (out, str, strlen (str), &written, NULL, &error))
+  if (out->binary)
     {
-      g_critical ("failed to write to iochannel: %s", error->message);
-      g_clear_error (&error);
+      g_string_append_c (out->buffer, '<');
+      dump_binary_string (out, name);
+    }
+  else
+    {
+      guint i;
+
+      if (out->in_start_tag)
+        g_string_append (out->buffer, ">\n");
+      for (i = 0; i < out->depth; i++)
+        g_string_append (out->buffer, "  ");
+      g_string_append_c (out->buffer, '<');
+      g_string_append (out->buffer, name);
+      out->in_start_tag = TRUE;
+    }
+
+  out->depth++;
+}
+
+static void
+dump_attribute (DumpOutput *out, const char *name, const char *value)
+{
+  /* What printing it with %s used to give */
+  if (value == NULL)
+    value = "(null)";
+
+  if (out->binary)
+    {
+      g_string_append_c (out->buffer, '=');
+      dump_binary_string (out, name);
+      dump_binary_string (out, value);
+    }
+  else
+    {
+      char *escaped;
+
+      escaped = g_markup_escape_text (value, -1);
+      g_string_append_printf (out->buffer, " %s=\"%s\"", name, escaped);
+      g_free (escaped);
+    }
+}
+
+static void
+dump_attribute_int (DumpOutput *out, const char *name, int value)
+{
+  char str[16];
+
+  g_snprintf (str, sizeof (str), "%d", value);
+  dump_attribute (out, name, str);
+}
+
+static void
+dump_end_element (DumpOutput *out, const char *name)
+{
+  out->depth--;
+
+  if (out->binary)
+    {
+      g_string_append_c (out->buffer, '>');
+    }
+  else if (out->in_start_tag)
+    {
+      g_string_append (out->buffer, "/>\n");
+      out->in_start_tag = FALSE;
+    }
+  else
+    {
+      guint i;
+
+      for (i = 0; i < out->depth; i++)
+        g_string_append (out->buffer, "  ");
+      g_string_append_printf (out->buffer, "</%s>\n", name);
     }
+
+  dump_output_maybe_flush (out);
 }
 
 typedef GType (*GetTypeFunc)(void);
@@ -120,7 +255,7 @@ invoke_error_quark (GModule *self, const char *symbol, GError **error)
 }
 
 static void
-dump_properties (GType type, GOutputStream *out)
+dump_properties (GType type, DumpOutput *out)
 {
   guint i;
   guint n_properties;
@@ -147,14 +282,17 @@ dump_properties (GType type, GOutputStream *out)
       if (prop->owner_type != type)
 	continue;
 
-      escaped_printf (out, "    <property name=\"%s\" type=\"%s\" flags=\"%d\"/>\n",
-		      prop->name, g_type_name (prop->value_type), prop->flags);
+      dump_start_element (out, "property");
+      dump_attribute (out, "name", prop->name);
+      dump_attribute (out, "type", g_type_name (prop->value_type));
+      dump_attribute_int (out, "flags", prop->flags);
+      dump_end_element (out, "property");
     }
   g_free (props);
 }
 
 static void
-dump_signals (GType type, GOutputStream *out)
+dump_signals (GType type, DumpOutput *out)
 {
   guint i;
   guint n_sigs;
@@ -170,51 +308,53 @@ dump_signals (GType type, GOutputStream *out)
       sigid = sig_ids[i];
       g_signal_query (sigid, &query);
 
-      escaped_printf (out, "    <signal name=\"%s\" return=\"%s\"",
-		      query.signal_name, g_type_name (query.return_type));
+      dump_start_element (out, "signal");
+      dump_attribute (out, "name", query.signal_name);
+      dump_attribute (out, "return", g_type_name (query.return_type));
 
       if (query.signal_flags & G_SIGNAL_RUN_FIRST)
-        escaped_printf (out, " when=\"first\"");
+        dump_attribute (out, "when", "first");
       else if (query.signal_flags & G_SIGNAL_RUN_LAST)
-        escaped_printf (out, " when=\"last\"");
+        dump_attribute (out, "when", "last");
       else if (query.signal_flags & G_SIGNAL_RUN_CLEANUP)
-        escaped_printf (out, " when=\"cleanup\"");
+        dump_attribute (out, "when", "cleanup");
 #if GLIB_CHECK_VERSION(2, 29, 15)
       else if (query.signal_flags & G_SIGNAL_MUST_COLLECT)
-        escaped_printf (out, " when=\"must-collect\"");
+        dump_attribute (out, "when", "must-collect");
 #endif
       if (query.signal_flags & G_SIGNAL_NO_RECURSE)
-        escaped_printf (out, " no-recurse=\"1\"");
+        dump_attribute (out, "no-recurse", "1");
 
       if (query.signal_flags & G_SIGNAL_DETAILED)
-        escaped_printf (out, " detailed=\"1\"");
+        dump_attribute (out, "detailed", "1");
 
       if (query.signal_flags & G_SIGNAL_ACTION)
-        escaped_printf (out, " action=\"1\"");
+        dump_attribute (out, "action", "1");
 
       if (query.signal_flags & G_SIGNAL_NO_HOOKS)
-        escaped_printf (out, " no-hooks=\"1\"");
-
-      goutput_write (out, ">\n");
+        dump_attribute (out, "no-hooks", "1");
 
       for (j = 0; j < query.n_params; j++)
 	{
-	  escaped_printf (out, "      <param type=\"%s\"/>\n",
-			  g_type_name (query.param_types[j]));
+	  dump_start_element (out, "param");
+	  dump_attribute (out, "type", g_type_name (query.param_types[j]));
+	  dump_end_element (out, "param");
 	}
-      goutput_write (out, "    </signal>\n");
+      dump_end_element (out, "signal");
     }
+  g_free (sig_ids);
 }
 
 static void
-dump_object_type (GType type, const char *symbol, GOutputStream *out)
+dump_object_type (GType type, const char *symbol, DumpOutput *out)
 {
   guint n_interfaces;
   guint i;
   GType *interfaces;
 
-  escaped_printf (out, "  <class name=\"%s\" get-type=\"%s\"",
-		  g_type_name (type), symbol);
+  dump_start_element (out, "class");
+  dump_attribute (out, "name", g_type_name (type));
+  dump_attribute (out, "get-type", symbol);
   if (type != G_TYPE_OBJECT)
     {
       GString *parent_str;
@@ -233,36 +373,38 @@ dump_object_type (GType type, const char *symbol, GOutputStream *out)
           parent = g_type_parent (parent);
         }
 
-      escaped_printf (out, " parents=\"%s\"", parent_str->str);
+      dump_attribute (out, "parents", parent_str->str);
 
       g_string_free (parent_str, TRUE);
     }
 
   if (G_TYPE_IS_ABSTRACT (type))
-    escaped_printf (out, " abstract=\"1\"");
-  goutput_write (out, ">\n");
+    dump_attribute (out, "abstract", "1");
 
   interfaces = g_type_interfaces (type, &n_interfaces);
   for (i = 0; i < n_interfaces; i++)
     {
       GType itype = interfaces[i];
-      escaped_printf (out, "    <implements name=\"%s\"/>\n",
-		      g_type_name (itype));
+      dump_start_element (out, "implements");
+      dump_attribute (out, "name", g_type_name (itype));
+      dump_end_element (out, "implements");
     }
+  g_free (interfaces);
   dump_properties (type, out);
   dump_signals (type, out);
-  goutput_write (out, "  </class>\n");
+  dump_end_element (out, "class");
 }
 
 static void
-dump_interface_type (GType type, const char *symbol, GOutputStream *out)
+dump_interface_type (GType type, const char *symbol, DumpOutput *out)
 {
   guint n_interfaces;
   guint i;
   GType *interfaces;
 
-  escaped_printf (out, "  <interface name=\"%s\" get-type=\"%s\">\n",
-		  g_type_name (type), symbol);
+  dump_start_element (out, "interface");
+  dump_attribute (out, "name", g_type_name (type));
+  dump_attribute (out, "get-type", symbol);
 
   interfaces = g_type_interface_prerequisites (type, &n_interfaces);
   for (i = 0; i < n_interfaces; i++)
@@ -277,63 +419,75 @@ dump_interface_type (GType type, const char *symbol, GOutputStream *out)
 	   */
 	  continue;
 	}
-      escaped_printf (out, "    <prerequisite name=\"%s\"/>\n",
-		      g_type_name (itype));
+      dump_start_element (out, "prerequisite");
+      dump_attribute (out, "name", g_type_name (itype));
+      dump_end_element (out, "prerequisite");
     }
+  g_free (interfaces);
   dump_properties (type, out);
   dump_signals (type, out);
-  goutput_write (out, "  </interface>\n");
+  dump_end_element (out, "interface");
 }
 
 static void
-dump_boxed_type (GType type, const char *symbol, GOutputStream *out)
+dump_boxed_type (GType type, const char *symbol, DumpOutput *out)
 {
-  escaped_printf (out, "  <boxed name=\"%s\" get-type=\"%s\"/>\n",
-		  g_type_name (type), symbol);
+  dump_start_element (out, "boxed");
+  dump_attribute (out, "name", g_type_name (type));
+  dump_attribute (out, "get-type", symbol);
+  dump_end_element (out, "boxed");
 }
 
 static void
-dump_flags_type (GType type, const char *symbol, GOutputStream *out)
+dump_flags_type (GType type, const char *symbol, DumpOutput *out)
 {
   guint i;
   GFlagsClass *klass;
 
   klass = g_type_class_ref (type);
-  escaped_printf (out, "  <flags name=\"%s\" get-type=\"%s\">\n",
-		  g_type_name (type), symbol);
+  dump_start_element (out, "flags");
+  dump_attribute (out, "name", g_type_name (type));
+  dump_attribute (out, "get-type", symbol);
 
   for (i = 0; i < klass->n_values; i++)
     {
       GFlagsValue *value = &(klass->values[i]);
 
-      escaped_printf (out, "    <member name=\"%s\" nick=\"%s\" value=\"%d\"/>\n",
-		      value->value_name, value->value_nick, value->value);
+      dump_start_element (out, "member");
+      dump_attribute (out, "name", value->value_name);
+      dump_attribute (out, "nick", value->value_nick);
+      dump_attribute_int (out, "value", value->value);
+      dump_end_element (out, "member");
     }
-  goutput_write (out, "  </flags>\n");
+  dump_end_element (out, "flags");
 }
 
 static void
-dump_enum_type (GType type, const char *symbol, GOutputStream *out)
+dump_enum_type (GType type, const char *symbol, DumpOutput *out)
 {
   guint i;
   GEnumClass *klass;
 
   klass = g_type_class_ref (type);
-  escaped_printf (out, "  <enum name=\"%s\" get-type=\"%s\">\n",
-		  g_type_name (type), symbol);
+  dump_start_element (out, "enum");
+  dump_attribute (out, "name", g_type_name (type));
+  dump_attribute (out, "get-type", symbol);
 
   for (i = 0; i < klass->n_values; i++)
     {
       GEnumValue *value = &(klass->values[i]);
 
-      escaped_printf (out, "    <member name=\"%s\" nick=\"%s\" value=\"%d\"/>\n",
-		      value->value_name, value->value_nick, value->value);
+      dump_start_element (out, "member");
+      dump_attribute (out, "name", value->value_name);
+      dump_attribute (out, "nick", value->value_nick);
+      dump_attribute_int (out, "value", value->value);
+      dump_end_element (out, "member");
     }
-  goutput_write (out, "  </enum>");
+  dump_end_element (out, "enum");
 }
 
 static void
-dump_fundamental_type (GType type, const char *symbol, GOutputStream *out)
+dump_fundamental_type (GType type, const char *symbol, DumpOutput *out)
 {
   guint n_interfaces;
   guint i;
@@ -343,14 +497,15 @@ dump_fundamental_type (GType type, const char *symbol, GOutputStream *out)
   gboolean first = TRUE;
 
 
-  escaped_printf (out, "  <fundamental name=\"%s\" get-type=\"%s\"",
-		  g_type_name (type), symbol);
+  dump_start_element (out, "fundamental");
+  dump_attribute (out, "name", g_type_name (type));
+  dump_attribute (out, "get-type", symbol);
 
   if (G_TYPE_IS_ABSTRACT (type))
-    escaped_printf (out, " abstract=\"1\"");
+    dump_attribute (out, "abstract", "1");
 
   if (G_TYPE_IS_INSTANTIATABLE (type))
-    escaped_printf (out, " instantiatable=\"1\"");
+    dump_attribute (out, "instantiatable", "1");
 
   parent = g_type_parent (type);
   parent_str = g_string_new ("");
@@ -367,23 +522,23 @@ dump_fundamental_type (GType type, const char *symbol, GOutputStream *out)
     }
 
   if (parent_str->len > 0)
-    escaped_printf (out, " parents=\"%s\"", parent_str->str);
+    dump_attribute (out, "parents", parent_str->str);
   g_string_free (parent_str, TRUE);
 
-  goutput_write (out, ">\n");
-
   interfaces = g_type_interfaces (type, &n_interfaces);
   for (i = 0; i < n_interfaces; i++)
     {
       GType itype = interfaces[i];
-      escaped_printf (out, "    <implements name=\"%s\"/>\n",
-		      g_type_name (itype));
+      dump_start_element (out, "implements");
+      dump_attribute (out, "name", g_type_name (itype));
+      dump_end_element (out, "implements");
     }
-  goutput_write (out, "  </fundamental>\n");
+  g_free (interfaces);
+  dump_end_element (out, "fundamental");
 }
 
 static void
-dump_type (GType type, const char *symbol, GOutputStream *out)
+dump_type (GType type, const char *symbol, DumpOutput *out)
 {
   switch (g_type_fundamental (type))
     {
@@ -412,15 +567,18 @@ dump_type (GType type, const char *symbol, GOutputStream *out)
 }
 
 static void
-dump_error_quark (GQuark quark, const char *symbol, GOutputStream *out)
+dump_error_quark (GQuark quark, const char *symbol, DumpOutput *out)
 {
-  escaped_printf (out, "  <error-quark function=\"%s\" domain=\"%s\"/>\n",
-		  symbol, g_quark_to_string (quark));
+  dump_start_element (out, "error-quark");
+  dump_attribute (out, "function", symbol);
+  dump_attribute (out, "domain", g_quark_to_string (quark));
+  dump_end_element (out, "error-quark");
 }
 
 /**
  * g_irepository_dump:
- * @arg: Comma-separated pair of input and output filenames
+ * @arg: Comma-separated pair of input and output filenames, optionally
+ *   followed by the output format
  * @error: a %GError
  *
  * Argument specified is a comma-separated pair of filenames; i.e. of
@@ -433,6 +591,12 @@ dump_error_quark (GQuark quark, const char *symbol, GOutputStream *out)
  * The output file should already exist, but be empty.  This function will
  * overwrite its contents.
  *
+ * By default the output is XML.  If the output filename is followed by
+ * ",binary", as in "input.txt,output.dump,binary", the same data is
+ * written in a compact binary format instead, whose records are
+ * length-prefixed rather than escaped and is much cheaper to read back.
+ * A trailing ",xml" selects the default format explicitly.
+ *
  * Returns: %TRUE on success, %FALSE on error
  */
 #ifndef G_IREPOSITORY_COMPILATION
@@ -453,6 +617,9 @@ g_irepository_dump (const char *arg, GError **error)
   GFileOutputStream *output;
   GDataInputStream *in;
   GModule *self;
+  DumpOutput out;
+  gboolean binary = FALSE;
+  char *format;
   gboolean caught_error = FALSE;
 
   self = g_module_open (NULL, 0);
@@ -467,9 +634,33 @@ g_irepository_dump (const char *arg, GError **error)
     }
 
   args = g_strsplit (arg, ",", 2);
+  if (args[0] == NULL || args[1] == NULL)
+    {
+      g_set_error (error,
+		   G_IO_ERROR,
+		   G_IO_ERROR_INVALID_ARGUMENT,
+		   "Invalid dump argument '%s'", arg);
+      g_strfreev (args);
+      return FALSE;
+    }
+
+  /* The output filename may contain commas itself, so only a known
+   * format name is split off its end */
+  format = strrchr (args[1], ',');
+  if (format != NULL)
+    {
+      if (strcmp (format + 1, "binary") == 0)
+        {
+          binary = TRUE;
+          *format = '\0';
+        }
+      else if (strcmp (format + 1, "xml") == 0)
+        *format = '\0';
+    }
 
   input_file = g_file_new_for_path (args[0]);
   output_file = g_file_new_for_path (args[1]);
+  g_strfreev (args);
 
   input = g_file_read (input_file, NULL, error);
   if (input == NULL)
@@ -482,8 +673,9 @@ g_irepository_dump (const char *arg, GError **error)
       return FALSE;
     }
 
-  goutput_write (G_OUTPUT_STREAM (output), "<?xml version=\"1.0\"?>\n");
-  goutput_write (G_OUTPUT_STREAM (output), "<dump>\n");
+  dump_output_init (&out, G_OUTPUT_STREAM (output), binary);
+  dump_output_write_header (&out);
+  dump_start_element (&out, "dump");
 
   output_types = g_hash_table_new (NULL, NULL);
 
@@ -524,7 +716,7 @@ g_irepository_dump (const char *arg, GError **error)
             goto next;
           g_hash_table_insert (output_types, (gpointer) type, (gpointer) type);
 
-          dump_type (type, function, G_OUTPUT_STREAM (output));
+          dump_type (type, function, &out);
         }
       else if (strncmp (line, "error-quark:", strlen ("error-quark:")) == 0)
         {
@@ -540,7 +732,7 @@ g_irepository_dump (const char *arg, GError **error)
               break;
             }
 
-          dump_error_quark (quark, function, G_OUTPUT_STREAM (output));
+          dump_error_quark (quark, function, &out);
         }
 
 
@@ -550,15 +742,20 @@ g_irepository_dump (const char *arg, GError **error)
 
   g_hash_table_destroy (output_types);
 
-  goutput_write (G_OUTPUT_STREAM (output), "</dump>\n");
+  dump_end_element (&out, "dump");
 
   {
     GError **ioerror;
+    gboolean flushed;
     /* Avoid overwriting an earlier set error */
     if (caught_error)
       ioerror = NULL;
     else
       ioerror = error;
+    flushed = dump_output_flush (&out, ioerror);
+    dump_output_free (&out);
+    if (!flushed)
+      return FALSE;
     if (!g_input_stream_close (G_INPUT_STREAM (in), NULL, ioerror))
       return FALSE;
     if (!g_output_stream_close (G_OUTPUT_STREAM (output), NULL, ioerror))
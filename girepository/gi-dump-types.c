@@ -8,9 +8,11 @@ main (int    argc,
 {
   int i;
   GOutputStream *stdout;
+  DumpOutput out;
   GModule *self;
 
   stdout = g_unix_output_stream_new (1, FALSE);
+  dump_output_init (&out, stdout, FALSE);
 
   self = g_module_open (NULL, 0);
 
@@ -26,8 +28,11 @@ main (int    argc,
 	  g_clear_error (&error);
 	}
       else
-	dump_type (type, argv[i], stdout);
+	dump_type (type, argv[i], &out);
     }
 
+  dump_output_flush (&out, NULL);
+  dump_output_free (&out);
+
   return 0;
 }
@@ -57,9 +57,24 @@ _g_info_new_full (GIInfoType     type,
                   guint32        offset)
 {
   GIRealInfo *info;
+  gboolean cacheable;
 
   g_return_val_if_fail (container != NULL || repository != NULL, NULL);
 
+  /* An info can't be shared if its container is on the stack */
+  cacheable = container == NULL ||
+    ((GIRealInfo *) container)->ref_count != INVALID_REFCOUNT;
+
+  if (cacheable)
+    {
+      GIBaseInfo *cached;
+
+      cached = _g_irepository_info_cache_lookup (repository, type, container,
+                                                 typelib, offset);
+      if (cached != NULL)
+        return cached;
+    }
+
   info = g_slice_new (GIRealInfo);
 
   _g_info_init (info, type, repository, container, typelib, offset);
@@ -70,6 +85,9 @@ _g_info_new_full (GIInfoType     type,
 
   g_object_ref (info->repository);
 
+  if (cacheable)
+    return _g_irepository_info_cache_insert (repository, (GIBaseInfo *) info);
+
   return (GIBaseInfo*)info;
 }
 
@@ -154,6 +172,51 @@ _g_info_from_entry (GIRepository *repository,
   return (GIBaseInfo *)result;
 }
 
+G_STATIC_ASSERT (sizeof (GIUnresolvedInfo) <= sizeof (GIRealInfo));
+
+/* Like _g_info_from_entry(), but initializes a stack allocated info;
+ * an unresolved reference gives a stack allocated #GIUnresolvedInfo,
+ * so @info must be large enough for one.
+ */
+void
+_g_info_load_from_entry (GIRealInfo   *info,
+                         GIRepository *repository,
+                         GITypelib    *typelib,
+                         guint16       index)
+{
+  DirEntry *entry = g_typelib_get_dir_entry (typelib, index);
+  GIUnresolvedInfo *unresolved;
+  const gchar *namespace;
+  const gchar *name;
+  GITypelib *entry_typelib;
+  GIInfoType entry_type;
+  guint32 entry_offset;
+
+  if (entry->local)
+    {
+      _g_info_init (info, entry->blob_type, repository, NULL, typelib, entry->offset);
+      return;
+    }
+
+  namespace = g_typelib_get_string (typelib, entry->offset);
+  name = g_typelib_get_string (typelib, entry->name);
+
+  if (_g_irepository_find_entry (repository, namespace, name,
+                                 &entry_typelib, &entry_type, &entry_offset))
+    {
+      _g_info_init (info, entry_type, repository, NULL, entry_typelib, entry_offset);
+      return;
+    }
+
+  memset (info, 0, sizeof (GIRealInfo));
+  unresolved = (GIUnresolvedInfo *) info;
+  unresolved->type = GI_INFO_TYPE_UNRESOLVED;
+  unresolved->ref_count = INVALID_REFCOUNT;
+  unresolved->repository = repository;
+  unresolved->name = name;
+  unresolved->namespace = namespace;
+}
+
 GITypeInfo *
 _g_type_info_new (GIBaseInfo    *container,
                  GITypelib      *typelib,
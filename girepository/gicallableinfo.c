@@ -744,3 +744,249 @@ g_callable_info_invoke (GIFunctionInfo *info,
   g_base_info_unref ((GIBaseInfo *)rinfo);
   return success;
 }
+
+struct _GIPreparedCallable
+{
+  ffi_cif cif;
+  gpointer function;
+  GITypeInfo *return_info;
+  GITypeTag return_tag;
+  gboolean throws;
+  gint n_in_args;
+  gint n_out_args;
+  gint n_invoke_args;
+  ffi_type **atypes;
+  /* One entry per libffi argument, excluding the trailing GError**:
+   * an index into the in arguments if >= 0, otherwise -(index + 1)
+   * into the out arguments.
+   */
+  gint *slots;
+};
+
+/**
+ * g_callable_info_prepare:
+ * @info: a #GICallableInfo
+ * @function: function pointer to call
+ * @is_method: whether the first "in" argument is the instance
+ * @throws: whether @function takes a trailing #GError location
+ * @error: return location for detailed error information, or %NULL
+ *
+ * Computes the libffi call interface and the placement of the "in",
+ * "out" and "inout" arguments of @info once, so that @function can
+ * be called repeatedly with g_prepared_callable_invoke() without
+ * looking at the typelib again. The arguments are interpreted as in
+ * g_callable_info_invoke().
+ *
+ * Returns: (transfer full): a new #GIPreparedCallable, free with
+ *   g_prepared_callable_free(), or %NULL if an error occurred.
+ *
+ * Since: 1.46
+ */
+GIPreparedCallable *
+g_callable_info_prepare (GICallableInfo *info,
+                         gpointer        function,
+                         gboolean        is_method,
+                         gboolean        throws,
+                         GError        **error)
+{
+  GIPreparedCallable *prepared;
+  GIArgInfo ainfo;
+  GITypeInfo tinfo;
+  gint n_args, offset, in_pos, out_pos, i;
+
+  g_return_val_if_fail (info != NULL, NULL);
+  g_return_val_if_fail (GI_IS_CALLABLE_INFO (info), NULL);
+
+  n_args = g_callable_info_get_n_args (info);
+  offset = is_method ? 1 : 0;
+
+  prepared = g_slice_new0 (GIPreparedCallable);
+  prepared->function = function;
+  prepared->throws = throws;
+  prepared->return_info = g_callable_info_get_return_type (info);
+  prepared->return_tag = g_type_info_get_tag (prepared->return_info);
+  prepared->n_invoke_args = n_args + offset + (throws ? 1 : 0);
+  prepared->atypes = g_new (ffi_type *, prepared->n_invoke_args);
+  prepared->slots = g_new (gint, n_args + offset);
+
+  in_pos = 0;
+  out_pos = 0;
+
+  if (is_method)
+    {
+      prepared->atypes[0] = &ffi_type_pointer;
+      prepared->slots[0] = in_pos++;
+    }
+
+  for (i = 0; i < n_args; i++)
+    {
+      g_callable_info_load_arg (info, i, &ainfo);
+      switch (g_arg_info_get_direction (&ainfo))
+        {
+        case GI_DIRECTION_IN:
+          g_arg_info_load_type (&ainfo, &tinfo);
+          prepared->atypes[i + offset] = g_type_info_get_ffi_type (&tinfo);
+          prepared->slots[i + offset] = in_pos++;
+          break;
+        case GI_DIRECTION_OUT:
+          prepared->atypes[i + offset] = &ffi_type_pointer;
+          prepared->slots[i + offset] = -(out_pos + 1);
+          out_pos++;
+          break;
+        case GI_DIRECTION_INOUT:
+          prepared->atypes[i + offset] = &ffi_type_pointer;
+          prepared->slots[i + offset] = in_pos++;
+          out_pos++;
+          break;
+        default:
+          g_assert_not_reached ();
+        }
+    }
+
+  if (throws)
+    prepared->atypes[prepared->n_invoke_args - 1] = &ffi_type_pointer;
+
+  prepared->n_in_args = in_pos;
+  prepared->n_out_args = out_pos;
+
+  if (ffi_prep_cif (&prepared->cif, FFI_DEFAULT_ABI, prepared->n_invoke_args,
+                    g_type_info_get_ffi_type (prepared->return_info),
+                    prepared->atypes) != FFI_OK)
+    {
+      g_set_error (error,
+                   G_INVOKE_ERROR,
+                   G_INVOKE_ERROR_FAILED,
+                   "Could not prepare the call interface for %s",
+                   g_base_info_get_name ((GIBaseInfo *) info));
+      g_prepared_callable_free (prepared);
+      return NULL;
+    }
+
+  return prepared;
+}
+
+/**
+ * g_prepared_callable_invoke:
+ * @prepared: a #GIPreparedCallable
+ * @in_args: (array length=n_in_args): the "in" and "inout" arguments,
+ *   preceded by the instance for methods
+ * @n_in_args: the length of the @in_args array
+ * @out_args: (array length=n_out_args): the "out" and "inout" arguments
+ * @n_out_args: the length of the @out_args array
+ * @return_value: return location for the return value
+ * @error: return location for detailed error information, or %NULL
+ *
+ * Invokes a callable prepared with g_callable_info_prepare() or
+ * g_function_info_prepare(). Only the argument placement and the
+ * call itself are done here; the argument counts must match the
+ * ones of the prepared callable exactly.
+ *
+ * Returns: %TRUE if the function has been invoked, %FALSE if an
+ *   error occurred.
+ *
+ * Since: 1.46
+ */
+gboolean
+g_prepared_callable_invoke (GIPreparedCallable *prepared,
+                            const GIArgument   *in_args,
+                            int                 n_in_args,
+                            const GIArgument   *out_args,
+                            int                 n_out_args,
+                            GIArgument         *return_value,
+                            GError            **error)
+{
+  gpointer *args;
+  gint n_slots, i;
+  GError *local_error = NULL;
+  gpointer error_address = &local_error;
+  GIFFIReturnValue ffi_return_value;
+  gpointer return_value_p; /* Will point inside the union return_value */
+
+  g_return_val_if_fail (prepared != NULL, FALSE);
+  g_return_val_if_fail (return_value, FALSE);
+
+  if (n_in_args != prepared->n_in_args)
+    {
+      g_set_error (error,
+                   G_INVOKE_ERROR,
+                   G_INVOKE_ERROR_ARGUMENT_MISMATCH,
+                   "Too %s \"in\" arguments (expected %d, got %d)",
+                   n_in_args < prepared->n_in_args ? "few" : "many",
+                   prepared->n_in_args, n_in_args);
+      return FALSE;
+    }
+  if (n_out_args != prepared->n_out_args)
+    {
+      g_set_error (error,
+                   G_INVOKE_ERROR,
+                   G_INVOKE_ERROR_ARGUMENT_MISMATCH,
+                   "Too %s \"out\" arguments (expected %d, got %d)",
+                   n_out_args < prepared->n_out_args ? "few" : "many",
+                   prepared->n_out_args, n_out_args);
+      return FALSE;
+    }
+
+  args = g_alloca (sizeof (gpointer) * prepared->n_invoke_args);
+  n_slots = prepared->n_invoke_args - (prepared->throws ? 1 : 0);
+
+  for (i = 0; i < n_slots; i++)
+    {
+      gint slot = prepared->slots[i];
+
+      if (slot >= 0)
+        args[i] = (gpointer) &in_args[slot];
+      else
+        args[i] = (gpointer) &out_args[-slot - 1];
+    }
+
+  if (prepared->throws)
+    args[n_slots] = &error_address;
+
+  /* See comment for GIFFIReturnValue above */
+  switch (prepared->return_tag)
+    {
+    case GI_TYPE_TAG_FLOAT:
+      return_value_p = &ffi_return_value.v_float;
+      break;
+    case GI_TYPE_TAG_DOUBLE:
+      return_value_p = &ffi_return_value.v_double;
+      break;
+    case GI_TYPE_TAG_INT64:
+    case GI_TYPE_TAG_UINT64:
+      return_value_p = &ffi_return_value.v_uint64;
+      break;
+    default:
+      return_value_p = &ffi_return_value.v_long;
+    }
+  ffi_call (&prepared->cif, prepared->function, return_value_p, args);
+
+  if (local_error)
+    {
+      g_propagate_error (error, local_error);
+      return FALSE;
+    }
+
+  gi_type_info_extract_ffi_return_value (prepared->return_info,
+                                         &ffi_return_value, return_value);
+  return TRUE;
+}
+
+/**
+ * g_prepared_callable_free:
+ * @prepared: (allow-none): a #GIPreparedCallable
+ *
+ * Frees a #GIPreparedCallable.
+ *
+ * Since: 1.46
+ */
+void
+g_prepared_callable_free (GIPreparedCallable *prepared)
+{
+  if (prepared == NULL)
+    return;
+
+  g_base_info_unref ((GIBaseInfo *) prepared->return_info);
+  g_free (prepared->atypes);
+  g_free (prepared->slots);
+  g_slice_free (GIPreparedCallable, prepared);
+}
@@ -103,6 +103,25 @@ gboolean               g_callable_info_invoke          (GICallableInfo   *info,
 GI_AVAILABLE_IN_1_42
 GITransfer             g_callable_info_get_instance_ownership_transfer (GICallableInfo *info);
 
+GI_AVAILABLE_IN_1_46
+GIPreparedCallable *   g_callable_info_prepare         (GICallableInfo   *info,
+                                                        gpointer          function,
+                                                        gboolean          is_method,
+                                                        gboolean          throws,
+                                                        GError          **error);
+
+GI_AVAILABLE_IN_1_46
+gboolean               g_prepared_callable_invoke      (GIPreparedCallable *prepared,
+                                                        const GIArgument   *in_args,
+                                                        int                 n_in_args,
+                                                        const GIArgument   *out_args,
+                                                        int                 n_out_args,
+                                                        GIArgument         *return_value,
+                                                        GError            **error);
+
+GI_AVAILABLE_IN_1_46
+void                   g_prepared_callable_free        (GIPreparedCallable *prepared);
+
 G_END_DECLS
 
 
@@ -47,6 +47,28 @@
  * </refsect1>
  */
 
+static gint32
+g_enum_info_get_value_offset (GIEnumInfo *info,
+                              gint        n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+
+  return rinfo->offset + header->enum_blob_size + n * header->value_blob_size;
+}
+
+static gint32
+g_enum_info_get_method_offset (GIEnumInfo *info,
+                               gint        n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  EnumBlob *blob = (EnumBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_enum_info_get_value_offset (info, blob->n_values)
+    + n * header->function_blob_size;
+}
+
 /**
  * g_enum_info_get_n_values:
  * @info: a #GIEnumInfo
@@ -112,17 +134,41 @@ g_enum_info_get_value (GIEnumInfo *info,
 		       gint        n)
 {
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  gint offset;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_ENUM_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  offset = rinfo->offset + header->enum_blob_size
-    + n * header->value_blob_size;
+  return (GIValueInfo *) g_info_new (GI_INFO_TYPE_VALUE, (GIBaseInfo*)info, rinfo->typelib,
+                                     g_enum_info_get_value_offset (info, n));
+}
 
-  return (GIValueInfo *) g_info_new (GI_INFO_TYPE_VALUE, (GIBaseInfo*)info, rinfo->typelib, offset);
+/**
+ * g_enum_info_load_value:
+ * @info: a #GIEnumInfo
+ * @n: index of value to fetch
+ * @value: (out caller-allocates): Initialized with a value for this
+ *   enumeration
+ *
+ * Obtain a value for this enumeration; this function is a variant of
+ * g_enum_info_get_value() designed for stack allocation.
+ *
+ * The initialized @value must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_enum_info_load_value (GIEnumInfo  *info,
+                        gint         n,
+                        GIValueInfo *value)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_ENUM_INFO (info));
+
+  _g_info_init ((GIRealInfo *) value, GI_INFO_TYPE_VALUE, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_enum_info_get_value_offset (info, n));
 }
 
 /**
@@ -163,23 +209,42 @@ GIFunctionInfo *
 g_enum_info_get_method (GIEnumInfo *info,
 			gint        n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  EnumBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_ENUM_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (EnumBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info,
+					rinfo->typelib, g_enum_info_get_method_offset (info, n));
+}
 
-  offset = rinfo->offset + header->enum_blob_size
-    + blob->n_values * header->value_blob_size
-    + n * header->function_blob_size;
+/**
+ * g_enum_info_load_method:
+ * @info: a #GIEnumInfo
+ * @n: index of method to get
+ * @method: (out caller-allocates): Initialized with an enum type method at
+ *   index @n
+ *
+ * Obtain an enum type method at index @n; this function is a variant of
+ * g_enum_info_get_method() designed for stack allocation.
+ *
+ * The initialized @method must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_enum_info_load_method (GIEnumInfo     *info,
+                         gint            n,
+                         GIFunctionInfo *method)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
 
-  return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_ENUM_INFO (info));
+
+  _g_info_init ((GIRealInfo *) method, GI_INFO_TYPE_FUNCTION, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_enum_info_get_method_offset (info, n));
 }
 
 /**
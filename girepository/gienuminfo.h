@@ -58,6 +58,11 @@ GI_AVAILABLE_IN_ALL
 GIValueInfo  * g_enum_info_get_value         (GIEnumInfo  *info,
 					      gint         n);
 
+GI_AVAILABLE_IN_1_46
+void           g_enum_info_load_value        (GIEnumInfo  *info,
+                                              gint         n,
+                                              GIValueInfo *value);
+
 GI_AVAILABLE_IN_ALL
 gint              g_enum_info_get_n_methods     (GIEnumInfo  *info);
 
@@ -65,6 +70,11 @@ GI_AVAILABLE_IN_ALL
 GIFunctionInfo  * g_enum_info_get_method        (GIEnumInfo  *info,
 						 gint         n);
 
+GI_AVAILABLE_IN_1_46
+void              g_enum_info_load_method       (GIEnumInfo     *info,
+                                                 gint            n,
+                                                 GIFunctionInfo *method);
+
 GI_AVAILABLE_IN_ALL
 GITypeTag      g_enum_info_get_storage_type  (GIEnumInfo  *info);
 
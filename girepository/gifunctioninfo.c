@@ -60,11 +60,28 @@ _g_base_info_find_method (GIBaseInfo   *base,
 			  gint          n_methods,
 			  const gchar  *name)
 {
-  /* FIXME hash */
   GIRealInfo *rinfo = (GIRealInfo*)base;
   Header *header = (Header *)rinfo->typelib->data;
+  guint16 index;
   gint i;
 
+  if (g_typelib_lookup_member (rinfo->typelib, rinfo->offset,
+			       GI_MEMBER_INDEX_METHODS, name, &index))
+    {
+      FunctionBlob *fblob;
+
+      if (index >= n_methods)
+	return NULL;
+
+      offset += index * header->function_blob_size;
+      fblob = (FunctionBlob *)&rinfo->typelib->data[offset];
+      if (strcmp (name, (const gchar *)&rinfo->typelib->data[fblob->name]) != 0)
+	return NULL;
+
+      return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, base,
+					    rinfo->typelib, offset);
+    }
+
   for (i = 0; i < n_methods; i++)
     {
       FunctionBlob *fblob = (FunctionBlob *)&rinfo->typelib->data[offset];
@@ -223,6 +240,28 @@ g_invoke_error_quark (void)
   return quark;
 }
 
+/*
+ * _g_function_info_get_address:
+ * @info: a #GIFunctionInfo
+ * @address: (out): returns the address of the function
+ *
+ * Looks up the symbol of @info in its typelib, see also
+ * g_irepository_resolve_symbols().
+ *
+ * Returns: %TRUE if the symbol was found
+ */
+gboolean
+_g_function_info_get_address (GIFunctionInfo *info,
+                              gpointer       *address)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  FunctionBlob *blob;
+
+  blob = (FunctionBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return _g_typelib_symbol_at (rinfo->typelib, blob->symbol, address);
+}
+
 /**
  * g_function_info_invoke: (skip)
  * @info: a #GIFunctionInfo describing the function to invoke
@@ -265,8 +304,7 @@ g_function_info_invoke (GIFunctionInfo *info,
 
   symbol = g_function_info_get_symbol (info);
 
-  if (!g_typelib_symbol (g_base_info_get_typelib((GIBaseInfo *) info),
-                         symbol, &func))
+  if (!_g_function_info_get_address (info, &func))
     {
       g_set_error (error,
                    G_INVOKE_ERROR,
@@ -291,3 +329,52 @@ g_function_info_invoke (GIFunctionInfo *info,
                                  throws,
                                  error);
 }
+
+/**
+ * g_function_info_prepare:
+ * @info: a #GIFunctionInfo describing the function to prepare
+ * @error: return location for detailed error information, or %NULL
+ *
+ * Looks up the symbol of @info and prepares it with
+ * g_callable_info_prepare(), deriving the method and throws flags
+ * the same way g_function_info_invoke() does. This is useful when
+ * the same function is invoked many times.
+ *
+ * Returns: (transfer full): a new #GIPreparedCallable, free with
+ *   g_prepared_callable_free(), or %NULL if an error occurred.
+ *
+ * Since: 1.46
+ */
+GIPreparedCallable *
+g_function_info_prepare (GIFunctionInfo *info,
+                         GError        **error)
+{
+  const gchar *symbol;
+  gpointer func;
+  GIFunctionInfoFlags flags;
+  gboolean is_method;
+  gboolean throws;
+
+  g_return_val_if_fail (info != NULL, NULL);
+  g_return_val_if_fail (GI_IS_FUNCTION_INFO (info), NULL);
+
+  symbol = g_function_info_get_symbol (info);
+
+  if (!_g_function_info_get_address (info, &func))
+    {
+      g_set_error (error,
+                   G_INVOKE_ERROR,
+                   G_INVOKE_ERROR_SYMBOL_NOT_FOUND,
+                   "Could not locate %s: %s", symbol, g_module_error ());
+
+      return NULL;
+    }
+
+  flags = g_function_info_get_flags (info);
+  is_method = (flags & GI_FUNCTION_IS_METHOD) != 0
+    && (flags & GI_FUNCTION_IS_CONSTRUCTOR) == 0;
+  throws = (flags & GI_FUNCTION_THROWS) != 0;
+
+  return g_callable_info_prepare ((GICallableInfo *) info, func,
+                                  is_method, throws, error);
+}
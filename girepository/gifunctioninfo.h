@@ -92,6 +92,10 @@ gboolean              g_function_info_invoke         (GIFunctionInfo *info,
 						      GIArgument        *return_value,
 						      GError          **error);
 
+GI_AVAILABLE_IN_1_46
+GIPreparedCallable *  g_function_info_prepare        (GIFunctionInfo *info,
+						      GError        **error);
+
 
 G_END_DECLS
 
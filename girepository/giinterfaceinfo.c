@@ -48,6 +48,67 @@
  * </refsect1>
  */
 
+static gint32
+g_interface_info_get_property_offset (GIInterfaceInfo *info,
+                                      gint             n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  InterfaceBlob *blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return rinfo->offset + header->interface_blob_size
+    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
+    + n * header->property_blob_size;
+}
+
+static gint32
+g_interface_info_get_method_offset (GIInterfaceInfo *info,
+                                   gint             n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  InterfaceBlob *blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_interface_info_get_property_offset (info, blob->n_properties)
+    + n * header->function_blob_size;
+}
+
+static gint32
+g_interface_info_get_signal_offset (GIInterfaceInfo *info,
+                                   gint             n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  InterfaceBlob *blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_interface_info_get_method_offset (info, blob->n_methods)
+    + n * header->signal_blob_size;
+}
+
+static gint32
+g_interface_info_get_vfunc_offset (GIInterfaceInfo *info,
+                                  gint             n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  InterfaceBlob *blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_interface_info_get_signal_offset (info, blob->n_signals)
+    + n * header->vfunc_blob_size;
+}
+
+static gint32
+g_interface_info_get_constant_offset (GIInterfaceInfo *info,
+                                     gint             n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  InterfaceBlob *blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_interface_info_get_vfunc_offset (info, blob->n_vfuncs)
+    + n * header->constant_blob_size;
+}
+
 /**
  * g_interface_info_get_n_prerequisites:
  * @info: a #GIInterfaceInfo
@@ -98,6 +159,39 @@ g_interface_info_get_prerequisite (GIInterfaceInfo *info,
 			     rinfo->typelib, blob->prerequisites[n]);
 }
 
+/**
+ * g_interface_info_load_prerequisite:
+ * @info: a #GIInterfaceInfo
+ * @n: index of prerequisites to get
+ * @prerequisite: (out caller-allocates): Initialized with the prerequisite
+ *   at index @n
+ *
+ * Obtain an interface type prerequisite at index @n; this function is a
+ * variant of g_interface_info_get_prerequisite() designed for stack
+ * allocation.
+ *
+ * The initialized @prerequisite must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_interface_info_load_prerequisite (GIInterfaceInfo *info,
+                                    gint             n,
+                                    GIBaseInfo      *prerequisite)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  InterfaceBlob *blob;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_INTERFACE_INFO (info));
+
+  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  _g_info_load_from_entry ((GIRealInfo *) prerequisite, rinfo->repository,
+                           rinfo->typelib, blob->prerequisites[n]);
+}
+
 
 /**
  * g_interface_info_get_n_properties:
@@ -135,23 +229,42 @@ GIPropertyInfo *
 g_interface_info_get_property (GIInterfaceInfo *info,
 			       gint            n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  InterfaceBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIPropertyInfo *) g_info_new (GI_INFO_TYPE_PROPERTY, (GIBaseInfo*)info, rinfo->typelib,
+                            g_interface_info_get_property_offset (info, n));
+}
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
-    + n * header->property_blob_size;
+/**
+ * g_interface_info_load_property:
+ * @info: a #GIInterfaceInfo
+ * @n: index of property to get
+ * @property: (out caller-allocates): Initialized with an interface type
+ *   property at index @n
+ *
+ * Obtain an interface type property at index @n; this function is a variant
+ * of g_interface_info_get_property() designed for stack allocation.
+ *
+ * The initialized @property must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_interface_info_load_property (GIInterfaceInfo *info,
+                                gint             n,
+                                GIPropertyInfo  *property)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_INTERFACE_INFO (info));
 
-  return (GIPropertyInfo *) g_info_new (GI_INFO_TYPE_PROPERTY, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) property, GI_INFO_TYPE_PROPERTY, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_interface_info_get_property_offset (info, n));
 }
 
 /**
@@ -190,24 +303,42 @@ GIFunctionInfo *
 g_interface_info_get_method (GIInterfaceInfo *info,
 			     gint            n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  InterfaceBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info, rinfo->typelib,
+                            g_interface_info_get_method_offset (info, n));
+}
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
-    + blob->n_properties * header->property_blob_size
-    + n * header->function_blob_size;
+/**
+ * g_interface_info_load_method:
+ * @info: a #GIInterfaceInfo
+ * @n: index of method to get
+ * @method: (out caller-allocates): Initialized with an interface type
+ *   method at index @n
+ *
+ * Obtain an interface type method at index @n; this function is a variant
+ * of g_interface_info_get_method() designed for stack allocation.
+ *
+ * The initialized @method must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_interface_info_load_method (GIInterfaceInfo *info,
+                              gint             n,
+                              GIFunctionInfo  *method)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
 
-  return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_INTERFACE_INFO (info));
+
+  _g_info_init ((GIRealInfo *) method, GI_INFO_TYPE_FUNCTION, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_interface_info_get_method_offset (info, n));
 }
 
 /**
@@ -227,12 +358,9 @@ g_interface_info_find_method (GIInterfaceInfo *info,
 {
   gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header = (Header *)rinfo->typelib->data;
   InterfaceBlob *blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
-    + blob->n_properties * header->property_blob_size;
+  offset = g_interface_info_get_method_offset (info, 0);
 
   return _g_base_info_find_method ((GIBaseInfo*)info, offset, blob->n_methods, name);
 }
@@ -273,25 +401,42 @@ GISignalInfo *
 g_interface_info_get_signal (GIInterfaceInfo *info,
 			     gint            n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  InterfaceBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GISignalInfo *) g_info_new (GI_INFO_TYPE_SIGNAL, (GIBaseInfo*)info, rinfo->typelib,
+                          g_interface_info_get_signal_offset (info, n));
+}
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + n * header->signal_blob_size;
+/**
+ * g_interface_info_load_signal:
+ * @info: a #GIInterfaceInfo
+ * @n: index of signal to get
+ * @signal: (out caller-allocates): Initialized with an interface type
+ *   signal at index @n
+ *
+ * Obtain an interface type signal at index @n; this function is a variant
+ * of g_interface_info_get_signal() designed for stack allocation.
+ *
+ * The initialized @signal must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_interface_info_load_signal (GIInterfaceInfo *info,
+                              gint             n,
+                              GISignalInfo    *signal)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
 
-  return (GISignalInfo *) g_info_new (GI_INFO_TYPE_SIGNAL, (GIBaseInfo*)info,
-				      rinfo->typelib, offset);
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_INTERFACE_INFO (info));
+
+  _g_info_init ((GIRealInfo *) signal, GI_INFO_TYPE_SIGNAL, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_interface_info_get_signal_offset (info, n));
 }
 
 /**
@@ -309,23 +454,18 @@ GISignalInfo *
 g_interface_info_find_signal (GIInterfaceInfo *info,
                               const gchar  *name)
 {
-  gint n_signals;
-  gint i;
-
-  n_signals = g_interface_info_get_n_signals (info);
-  for (i = 0; i < n_signals; i++)
-    {
-      GISignalInfo *siginfo = g_interface_info_get_signal (info, i);
-
-      if (g_strcmp0 (g_base_info_get_name (siginfo), name) != 0)
-        {
-          g_base_info_unref ((GIBaseInfo*)siginfo);
-          continue;
-        }
-
-      return siginfo;
-    }
-  return NULL;
+  gint offset;
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  InterfaceBlob *blob;
+
+  g_return_val_if_fail (info != NULL, NULL);
+  g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
+
+  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  offset = g_interface_info_get_signal_offset (info, 0);
+
+  return _g_base_info_find_signal ((GIBaseInfo*)info, offset, blob->n_signals, name);
 }
 
 /**
@@ -364,26 +504,42 @@ GIVFuncInfo *
 g_interface_info_get_vfunc (GIInterfaceInfo *info,
 			    gint            n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  InterfaceBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIVFuncInfo *) g_info_new (GI_INFO_TYPE_VFUNC, (GIBaseInfo*)info, rinfo->typelib,
+                         g_interface_info_get_vfunc_offset (info, n));
+}
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + blob->n_signals * header->signal_blob_size
-    + n * header->vfunc_blob_size;
+/**
+ * g_interface_info_load_vfunc:
+ * @info: a #GIInterfaceInfo
+ * @n: index of virtual function to get
+ * @vfunc: (out caller-allocates): Initialized with an interface type
+ *   virtual function at index @n
+ *
+ * Obtain an interface type virtual function at index @n; this function is a
+ * variant of g_interface_info_get_vfunc() designed for stack allocation.
+ *
+ * The initialized @vfunc must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_interface_info_load_vfunc (GIInterfaceInfo *info,
+                             gint             n,
+                             GIVFuncInfo     *vfunc)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_INTERFACE_INFO (info));
 
-  return (GIVFuncInfo *) g_info_new (GI_INFO_TYPE_VFUNC, (GIBaseInfo*)info,
-				     rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) vfunc, GI_INFO_TYPE_VFUNC, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_interface_info_get_vfunc_offset (info, n));
 }
 
 /**
@@ -403,20 +559,14 @@ g_interface_info_find_vfunc (GIInterfaceInfo *info,
 {
   gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
   InterfaceBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
   blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + blob->n_prerequisites % 2) * 2
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + blob->n_signals * header->signal_blob_size;
+  offset = g_interface_info_get_vfunc_offset (info, 0);
 
   return _g_base_info_find_vfunc (rinfo, offset, blob->n_vfuncs, name);
 }
@@ -457,27 +607,42 @@ GIConstantInfo *
 g_interface_info_get_constant (GIInterfaceInfo *info,
 			       gint             n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  InterfaceBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_INTERFACE_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (InterfaceBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIConstantInfo *) g_info_new (GI_INFO_TYPE_CONSTANT, (GIBaseInfo*)info, rinfo->typelib,
+                            g_interface_info_get_constant_offset (info, n));
+}
 
-  offset = rinfo->offset + header->interface_blob_size
-    + (blob->n_prerequisites + (blob->n_prerequisites % 2)) * 2
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + blob->n_signals * header->signal_blob_size
-    + blob->n_vfuncs * header->vfunc_blob_size
-    + n * header->constant_blob_size;
+/**
+ * g_interface_info_load_constant:
+ * @info: a #GIInterfaceInfo
+ * @n: index of constant to get
+ * @constant: (out caller-allocates): Initialized with an interface type
+ *   constant at index @n
+ *
+ * Obtain an interface type constant at index @n; this function is a variant
+ * of g_interface_info_get_constant() designed for stack allocation.
+ *
+ * The initialized @constant must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_interface_info_load_constant (GIInterfaceInfo *info,
+                                gint             n,
+                                GIConstantInfo  *constant)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_INTERFACE_INFO (info));
 
-  return (GIConstantInfo *) g_info_new (GI_INFO_TYPE_CONSTANT, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) constant, GI_INFO_TYPE_CONSTANT, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_interface_info_get_constant_offset (info, n));
 }
 
 /**
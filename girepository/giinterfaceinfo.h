@@ -48,6 +48,11 @@ GI_AVAILABLE_IN_ALL
 GIBaseInfo *     g_interface_info_get_prerequisite    (GIInterfaceInfo *info,
 						       gint             n);
 
+GI_AVAILABLE_IN_1_46
+void             g_interface_info_load_prerequisite   (GIInterfaceInfo *info,
+                                                       gint             n,
+                                                       GIBaseInfo      *prerequisite);
+
 GI_AVAILABLE_IN_ALL
 gint             g_interface_info_get_n_properties    (GIInterfaceInfo *info);
 
@@ -55,6 +60,11 @@ GI_AVAILABLE_IN_ALL
 GIPropertyInfo * g_interface_info_get_property        (GIInterfaceInfo *info,
 						       gint             n);
 
+GI_AVAILABLE_IN_1_46
+void             g_interface_info_load_property       (GIInterfaceInfo *info,
+                                                       gint             n,
+                                                       GIPropertyInfo  *property);
+
 GI_AVAILABLE_IN_ALL
 gint             g_interface_info_get_n_methods       (GIInterfaceInfo *info);
 
@@ -62,6 +72,11 @@ GI_AVAILABLE_IN_ALL
 GIFunctionInfo * g_interface_info_get_method          (GIInterfaceInfo *info,
 						       gint             n);
 
+GI_AVAILABLE_IN_1_46
+void             g_interface_info_load_method         (GIInterfaceInfo *info,
+                                                       gint             n,
+                                                       GIFunctionInfo  *method);
+
 GI_AVAILABLE_IN_ALL
 GIFunctionInfo * g_interface_info_find_method         (GIInterfaceInfo *info,
 						       const gchar     *name);
@@ -73,6 +88,11 @@ GI_AVAILABLE_IN_ALL
 GISignalInfo *   g_interface_info_get_signal          (GIInterfaceInfo *info,
 						       gint             n);
 
+GI_AVAILABLE_IN_1_46
+void             g_interface_info_load_signal         (GIInterfaceInfo *info,
+                                                       gint             n,
+                                                       GISignalInfo    *signal);
+
 GI_AVAILABLE_IN_1_34
 GISignalInfo *   g_interface_info_find_signal         (GIInterfaceInfo *info,
                                                        const gchar  *name);
@@ -84,6 +104,11 @@ GI_AVAILABLE_IN_ALL
 GIVFuncInfo *    g_interface_info_get_vfunc           (GIInterfaceInfo *info,
 						       gint             n);
 
+GI_AVAILABLE_IN_1_46
+void             g_interface_info_load_vfunc          (GIInterfaceInfo *info,
+                                                       gint             n,
+                                                       GIVFuncInfo     *vfunc);
+
 GI_AVAILABLE_IN_ALL
 GIVFuncInfo *    g_interface_info_find_vfunc          (GIInterfaceInfo *info,
                                                        const gchar     *name);
@@ -95,6 +120,11 @@ GI_AVAILABLE_IN_ALL
 GIConstantInfo * g_interface_info_get_constant        (GIInterfaceInfo *info,
 						       gint             n);
 
+GI_AVAILABLE_IN_1_46
+void             g_interface_info_load_constant       (GIInterfaceInfo *info,
+                                                       gint             n,
+                                                       GIConstantInfo  *constant);
+
 
 GI_AVAILABLE_IN_ALL
 GIStructInfo *   g_interface_info_get_iface_struct    (GIInterfaceInfo *info);
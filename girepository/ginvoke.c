@@ -30,17 +30,15 @@
 #include "girffi.h"
 
 /**
- * value_to_ffi_type:
- * @gvalue: TODO
- * @value: TODO
+ * param_ffi_type:
+ * @type: the fundamental type of a parameter value
  *
- * TODO
+ * Returns: the ffi type used to pass a #GValue of fundamental type
+ * @type, or %NULL if the type is not supported.
  */
 static ffi_type *
-value_to_ffi_type (const GValue *gvalue, gpointer *value)
+param_ffi_type (GType type)
 {
-  ffi_type *rettype = NULL;
-  GType type = g_type_fundamental (G_VALUE_TYPE (gvalue));
   g_assert (type != G_TYPE_INVALID);
 
   switch (type)
@@ -48,124 +46,80 @@ value_to_ffi_type (const GValue *gvalue, gpointer *value)
     case G_TYPE_BOOLEAN:
     case G_TYPE_CHAR:
     case G_TYPE_INT:
-      rettype = &ffi_type_sint;
-      *value = (gpointer)&(gvalue->data[0].v_int);
-      break;
+      return &ffi_type_sint;
     case G_TYPE_UCHAR:
     case G_TYPE_UINT:
-      rettype = &ffi_type_uint;
-      *value = (gpointer)&(gvalue->data[0].v_uint);
-      break;
+      return &ffi_type_uint;
     case G_TYPE_STRING:
     case G_TYPE_OBJECT:
     case G_TYPE_BOXED:
     case G_TYPE_POINTER:
     case G_TYPE_PARAM:
-      rettype = &ffi_type_pointer;
-      *value = (gpointer)&(gvalue->data[0].v_pointer);
-      break;
+      return &ffi_type_pointer;
     case G_TYPE_FLOAT:
-      rettype = &ffi_type_float;
-      *value = (gpointer)&(gvalue->data[0].v_float);
-      break;
+      return &ffi_type_float;
     case G_TYPE_DOUBLE:
-      rettype = &ffi_type_double;
-      *value = (gpointer)&(gvalue->data[0].v_double);
-      break;
+      return &ffi_type_double;
     case G_TYPE_LONG:
-      rettype = &ffi_type_slong;
-      *value = (gpointer)&(gvalue->data[0].v_long);
-      break;
+      return &ffi_type_slong;
     case G_TYPE_ULONG:
-      rettype = &ffi_type_ulong;
-      *value = (gpointer)&(gvalue->data[0].v_ulong);
-      break;
+      return &ffi_type_ulong;
     case G_TYPE_INT64:
-      rettype = &ffi_type_sint64;
-      *value = (gpointer)&(gvalue->data[0].v_int64);
-      break;
+      return &ffi_type_sint64;
     case G_TYPE_UINT64:
-      rettype = &ffi_type_uint64;
-      *value = (gpointer)&(gvalue->data[0].v_uint64);
-      break;
+      return &ffi_type_uint64;
     default:
-      rettype = &ffi_type_pointer;
-      *value = NULL;
       g_warning ("Unsupported fundamental type: %s", g_type_name (type));
-      break;
+      return NULL;
     }
-  return rettype;
 }
 
 /**
- * g_value_to_ffi_return_type:
- * @gvalue: TODO
- * @ffi_value: TODO
- * @value: TODO
+ * return_ffi_type:
+ * @type: the fundamental type of the return value
  *
- * TODO
+ * Returns: the ffi type used to return a #GValue of fundamental type
+ * @type, or %NULL if the type is not supported.
  */
 static ffi_type *
-g_value_to_ffi_return_type (const GValue *gvalue,
-			    const GIArgument *ffi_value,
-			    gpointer *value)
+return_ffi_type (GType type)
 {
-  ffi_type *rettype = NULL;
-  GType type = g_type_fundamental (G_VALUE_TYPE (gvalue));
   g_assert (type != G_TYPE_INVALID);
 
-  *value = (gpointer)&(ffi_value->v_long);
-
   switch (type) {
+  case G_TYPE_NONE:
+    return &ffi_type_void;
   case G_TYPE_CHAR:
-    rettype = &ffi_type_sint8;
-    break;
+    return &ffi_type_sint8;
   case G_TYPE_UCHAR:
-    rettype = &ffi_type_uint8;
-    break;
+    return &ffi_type_uint8;
   case G_TYPE_BOOLEAN:
   case G_TYPE_INT:
-    rettype = &ffi_type_sint;
-    break;
+    return &ffi_type_sint;
   case G_TYPE_UINT:
-    rettype = &ffi_type_uint;
-    break;
+    return &ffi_type_uint;
   case G_TYPE_STRING:
   case G_TYPE_OBJECT:
   case G_TYPE_BOXED:
   case G_TYPE_POINTER:
   case G_TYPE_PARAM:
-    rettype = &ffi_type_pointer;
-    break;
+    return &ffi_type_pointer;
   case G_TYPE_FLOAT:
-    rettype = &ffi_type_float;
-    *value = (gpointer)&(ffi_value->v_float);
-    break;
+    return &ffi_type_float;
   case G_TYPE_DOUBLE:
-    rettype = &ffi_type_double;
-    *value = (gpointer)&(ffi_value->v_double);
-    break;
+    return &ffi_type_double;
   case G_TYPE_LONG:
-    rettype = &ffi_type_slong;
-    break;
+    return &ffi_type_slong;
   case G_TYPE_ULONG:
-    rettype = &ffi_type_ulong;
-    break;
+    return &ffi_type_ulong;
   case G_TYPE_INT64:
-    rettype = &ffi_type_sint64;
-    *value = (gpointer)&(ffi_value->v_int64);
-    break;
+    return &ffi_type_sint64;
   case G_TYPE_UINT64:
-    rettype = &ffi_type_uint64;
-    *value = (gpointer)&(ffi_value->v_uint64);
-    break;
+    return &ffi_type_uint64;
   default:
-    rettype = &ffi_type_pointer;
-    *value = NULL;
     g_warning ("Unsupported fundamental type: %s", g_type_name (type));
-    break;
+    return NULL;
   }
-  return rettype;
 }
 
 /**
@@ -232,6 +186,214 @@ g_value_from_ffi_value (GValue           *gvalue,
 
 }
 
+/* Signatures are keyed on fundamental types only, since that is all
+ * the ffi type classification above looks at. Entries are immutable
+ * once inserted and live for the lifetime of the process.
+ */
+typedef struct {
+  GType return_type;
+  guint n_param_values;
+  gboolean swap;
+  GType *param_types;
+} MarshalSignatureKey;
+
+typedef struct {
+  MarshalSignatureKey key;
+  ffi_cif cif;
+  ffi_type **atypes;
+} MarshalSignature;
+
+G_LOCK_DEFINE_STATIC (signatures);
+static GHashTable *signatures = NULL;
+
+static guint
+marshal_signature_key_hash (gconstpointer data)
+{
+  const MarshalSignatureKey *key = data;
+  guint hash, i;
+
+  hash = (guint) key->return_type ^ (key->n_param_values << 1) ^ key->swap;
+  for (i = 0; i < key->n_param_values; i++)
+    hash = (hash << 5) - hash + (guint) key->param_types[i];
+
+  return hash;
+}
+
+static gboolean
+marshal_signature_key_equal (gconstpointer a,
+                             gconstpointer b)
+{
+  const MarshalSignatureKey *ka = a;
+  const MarshalSignatureKey *kb = b;
+  guint i;
+
+  if (ka->return_type != kb->return_type ||
+      ka->n_param_values != kb->n_param_values ||
+      ka->swap != kb->swap)
+    return FALSE;
+
+  for (i = 0; i < ka->n_param_values; i++)
+    if (ka->param_types[i] != kb->param_types[i])
+      return FALSE;
+
+  return TRUE;
+}
+
+static MarshalSignature *
+marshal_signature_new (const MarshalSignatureKey *key)
+{
+  MarshalSignature *sig;
+  ffi_type *rtype;
+  guint n_args, i;
+
+  rtype = return_ffi_type (key->return_type);
+  if (rtype == NULL)
+    return NULL;
+
+  n_args = key->n_param_values + 1;
+
+  /* The key's param types and the ffi types share one allocation */
+  sig = g_malloc0 (sizeof (MarshalSignature) +
+                   sizeof (ffi_type *) * n_args +
+                   sizeof (GType) * key->n_param_values);
+  sig->atypes = (ffi_type **) (sig + 1);
+  sig->key = *key;
+  sig->key.param_types = (GType *) (sig->atypes + n_args);
+  for (i = 0; i < key->n_param_values; i++)
+    sig->key.param_types[i] = key->param_types[i];
+
+  /* The closure data is passed first, or last when swapped */
+  if (key->n_param_values > 0 && !key->swap)
+    {
+      sig->atypes[0] = param_ffi_type (key->param_types[0]);
+      sig->atypes[n_args - 1] = &ffi_type_pointer;
+    }
+  else
+    {
+      sig->atypes[0] = &ffi_type_pointer;
+      if (key->n_param_values > 0)
+        sig->atypes[n_args - 1] = param_ffi_type (key->param_types[0]);
+    }
+
+  for (i = 1; i < n_args - 1; i++)
+    sig->atypes[i] = param_ffi_type (key->param_types[i]);
+
+  for (i = 0; i < n_args; i++)
+    if (sig->atypes[i] == NULL)
+      goto error;
+
+  if (ffi_prep_cif (&sig->cif, FFI_DEFAULT_ABI, n_args, rtype, sig->atypes) != FFI_OK)
+    goto error;
+
+  return sig;
+
+ error:
+  g_free (sig);
+  return NULL;
+}
+
+/**
+ * marshal_signature_lookup:
+ * @return_gvalue: the return value, or %NULL
+ * @n_param_values: the number of parameters
+ * @param_values: the parameters
+ * @swap: whether the closure data is passed first
+ *
+ * Returns the prepared signature matching the arguments, creating and
+ * caching it on first use. Safe to call from any thread.
+ *
+ * Returns: (transfer none): the signature, or %NULL if one of the
+ * types is not supported.
+ */
+static MarshalSignature *
+marshal_signature_lookup (const GValue *return_gvalue,
+                          guint         n_param_values,
+                          const GValue *param_values,
+                          gboolean      swap)
+{
+  MarshalSignatureKey key;
+  MarshalSignature *sig, *existing;
+  guint i;
+
+  if (return_gvalue && G_VALUE_TYPE (return_gvalue))
+    key.return_type = g_type_fundamental (G_VALUE_TYPE (return_gvalue));
+  else
+    key.return_type = G_TYPE_NONE;
+  key.n_param_values = n_param_values;
+  key.swap = swap && n_param_values > 0;
+  key.param_types = g_alloca (sizeof (GType) * (n_param_values + 1));
+  for (i = 0; i < n_param_values; i++)
+    key.param_types[i] = g_type_fundamental (G_VALUE_TYPE (param_values + i));
+
+  G_LOCK (signatures);
+  if (signatures == NULL)
+    signatures = g_hash_table_new (marshal_signature_key_hash,
+                                   marshal_signature_key_equal);
+  sig = g_hash_table_lookup (signatures, &key);
+  G_UNLOCK (signatures);
+
+  if (sig != NULL)
+    return sig;
+
+  /* Prepare outside the lock; if another thread raced us, keep theirs */
+  sig = marshal_signature_new (&key);
+  if (sig == NULL)
+    return NULL;
+
+  G_LOCK (signatures);
+  existing = g_hash_table_lookup (signatures, &key);
+  if (existing == NULL)
+    g_hash_table_insert (signatures, &sig->key, sig);
+  G_UNLOCK (signatures);
+
+  if (existing != NULL)
+    {
+      g_free (sig);
+      sig = existing;
+    }
+
+  return sig;
+}
+
+static void
+marshal_with_signature (MarshalSignature *sig,
+                        GClosure         *closure,
+                        gpointer          callback,
+                        GValue           *return_gvalue,
+                        guint             n_param_values,
+                        const GValue     *param_values)
+{
+  GIArgument return_ffi_value;
+  guint n_args, i;
+  void **args;
+
+  n_args = n_param_values + 1;
+  args = g_alloca (sizeof (gpointer) * n_args);
+
+  /* All members of the GValue data union start at the same address,
+   * so the location does not depend on the type of the value.
+   */
+  if (n_param_values > 0 && !sig->key.swap)
+    {
+      args[0] = (gpointer) &param_values[0].data[0];
+      args[n_args - 1] = &closure->data;
+    }
+  else
+    {
+      args[0] = &closure->data;
+      if (n_param_values > 0)
+        args[n_args - 1] = (gpointer) &param_values[0].data[0];
+    }
+
+  for (i = 1; i < n_args - 1; i++)
+    args[i] = (gpointer) &param_values[i].data[0];
+
+  ffi_call (&sig->cif, callback, &return_ffi_value, args);
+
+  if (return_gvalue && G_VALUE_TYPE (return_gvalue))
+    g_value_from_ffi_value (return_gvalue, &return_ffi_value);
+}
+
 /**
  * gi_cclosure_marshal_generic:
  * @closure: TODO
@@ -251,61 +413,155 @@ gi_cclosure_marshal_generic (GClosure *closure,
                              gpointer invocation_hint,
                              gpointer marshal_data)
 {
-  GIArgument return_ffi_value;
-  ffi_type *rtype;
-  void *rvalue;
-  int n_args;
-  ffi_type **atypes;
-  void **args;
-  int i;
-  ffi_cif cif;
+  MarshalSignature *sig;
   GCClosure *cc = (GCClosure*) closure;
 
+  sig = marshal_signature_lookup (return_gvalue, n_param_values, param_values,
+                                  G_CCLOSURE_SWAP_DATA (closure));
+  if (sig == NULL)
+    return;
+
+  marshal_with_signature (sig, closure,
+                          marshal_data ? marshal_data : cc->callback,
+                          return_gvalue, n_param_values, param_values);
+}
+
+/* The signature a closure was first invoked with, along with the
+ * exact types of the values it was computed from.  Invocations with
+ * the same types, which is all of them for a closure connected to a
+ * signal, reuse the signature without computing fundamental types. */
+typedef struct {
+  MarshalSignature *sig;
+  GType return_type;
+  GType *param_types;
+} PinnedSignature;
+
+static PinnedSignature *
+pinned_signature_new (MarshalSignature *sig,
+                      const GValue     *return_gvalue,
+                      guint             n_param_values,
+                      const GValue     *param_values)
+{
+  PinnedSignature *pin;
+  guint i;
+
+  pin = g_malloc (sizeof (PinnedSignature) + sizeof (GType) * n_param_values);
+  pin->sig = sig;
   if (return_gvalue && G_VALUE_TYPE (return_gvalue))
-    {
-      rtype = g_value_to_ffi_return_type (return_gvalue, &return_ffi_value,
-					  &rvalue);
-    }
+    pin->return_type = G_VALUE_TYPE (return_gvalue);
   else
-    {
-      rtype = &ffi_type_void;
-      rvalue = &return_ffi_value.v_long;
-    }
+    pin->return_type = G_TYPE_NONE;
+  pin->param_types = (GType *) (pin + 1);
+  for (i = 0; i < n_param_values; i++)
+    pin->param_types[i] = G_VALUE_TYPE (param_values + i);
 
-  n_args = n_param_values + 1;
-  atypes = g_alloca (sizeof (ffi_type *) * n_args);
-  args =  g_alloca (sizeof (gpointer) * n_args);
+  return pin;
+}
+
+static gboolean
+pinned_signature_matches (PinnedSignature *pin,
+                          const GValue    *return_gvalue,
+                          guint            n_param_values,
+                          const GValue    *param_values,
+                          gboolean         swap)
+{
+  GType return_type;
+  guint i;
+
+  if (pin->sig->key.n_param_values != n_param_values ||
+      pin->sig->key.swap != (swap && n_param_values > 0))
+    return FALSE;
+
+  if (return_gvalue && G_VALUE_TYPE (return_gvalue))
+    return_type = G_VALUE_TYPE (return_gvalue);
+  else
+    return_type = G_TYPE_NONE;
+  if (pin->return_type != return_type)
+    return FALSE;
 
-  if (n_param_values > 0)
+  for (i = 0; i < n_param_values; i++)
+    if (pin->param_types[i] != G_VALUE_TYPE (param_values + i))
+      return FALSE;
+
+  return TRUE;
+}
+
+static void
+marshal_pinned (GClosure     *closure,
+                GValue       *return_gvalue,
+                guint         n_param_values,
+                const GValue *param_values,
+                gpointer      invocation_hint,
+                gpointer      marshal_data)
+{
+  PinnedSignature **slot = marshal_data;
+  PinnedSignature *pin, *new_pin;
+  MarshalSignature *sig;
+  GCClosure *cc = (GCClosure*) closure;
+  gboolean swap = G_CCLOSURE_SWAP_DATA (closure);
+
+  pin = g_atomic_pointer_get (slot);
+  if (G_LIKELY (pin != NULL &&
+                pinned_signature_matches (pin, return_gvalue, n_param_values,
+                                          param_values, swap)))
+    sig = pin->sig;
+  else
     {
-      if (G_CCLOSURE_SWAP_DATA (closure))
-        {
-          atypes[n_args-1] = value_to_ffi_type (param_values + 0,
-                                                &args[n_args-1]);
-          atypes[0] = &ffi_type_pointer;
-          args[0] = &closure->data;
-        }
-      else
+      sig = marshal_signature_lookup (return_gvalue, n_param_values, param_values,
+                                      swap);
+      if (sig == NULL)
+        return;
+
+      /* Only the first invocation is pinned, so a pin is never freed
+       * while another thread may be reading it */
+      if (pin == NULL)
         {
-          atypes[0] = value_to_ffi_type (param_values + 0, &args[0]);
-          atypes[n_args-1] = &ffi_type_pointer;
-          args[n_args-1] = &closure->data;
+          new_pin = pinned_signature_new (sig, return_gvalue, n_param_values,
+                                          param_values);
+          if (!g_atomic_pointer_compare_and_exchange (slot, NULL, new_pin))
+            g_free (new_pin);
         }
     }
-  else
-    {
-      atypes[0] = &ffi_type_pointer;
-      args[0] = &closure->data;
-    }
 
-  for (i = 1; i < n_args - 1; i++)
-    atypes[i] = value_to_ffi_type (param_values + i, &args[i]);
+  marshal_with_signature (sig, closure, cc->callback,
+                          return_gvalue, n_param_values, param_values);
+}
 
-  if (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, n_args, rtype, atypes) != FFI_OK)
-    return;
+static void
+free_pinned_signature (gpointer  data,
+                       GClosure *closure)
+{
+  PinnedSignature **slot = data;
 
-  ffi_call (&cif, marshal_data ? marshal_data : cc->callback, rvalue, args);
+  g_free (*slot);
+  g_free (slot);
+}
 
-  if (return_gvalue && G_VALUE_TYPE (return_gvalue))
-    g_value_from_ffi_value (return_gvalue, &return_ffi_value);
+/**
+ * gi_cclosure_pin_marshal_generic:
+ * @closure: a #GCClosure without a meta marshal
+ *
+ * Makes @closure use the generic marshaller and remembers the call
+ * signature it is first invoked with, so that later invocations with
+ * arguments of the same types skip looking up the prepared call
+ * interface. Invocations with other types, which do not happen for
+ * closures connected to a signal, look up their call interface as
+ * gi_cclosure_marshal_generic() does.
+ *
+ * This uses the meta marshal of @closure, so it cannot be combined
+ * with g_closure_set_meta_marshal().
+ *
+ * Since: 1.46
+ */
+void
+gi_cclosure_pin_marshal_generic (GClosure *closure)
+{
+  PinnedSignature **pinned;
+
+  g_return_if_fail (closure != NULL);
+
+  pinned = g_new0 (PinnedSignature *, 1);
+  g_closure_set_marshal (closure, gi_cclosure_marshal_generic);
+  g_closure_set_meta_marshal (closure, pinned, marshal_pinned);
+  g_closure_add_finalize_notifier (closure, pinned, free_pinned_signature);
 }
@@ -66,12 +66,20 @@ g_object_info_get_field_offset (GIObjectInfo *info,
   Header *header = (Header *)rinfo->typelib->data;
   ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
   guint32 offset;
+  const guint32 *field_offsets;
   gint i;
   FieldBlob *field_blob;
 
   offset = rinfo->offset + header->object_blob_size
     + (blob->n_interfaces + blob->n_interfaces % 2) * 2;
 
+  if (g_typelib_lookup_field_offsets (rinfo->typelib, rinfo->offset, &field_offsets))
+    {
+      if (field_offsets != NULL)
+        return field_offsets[n];
+      return offset + n * header->field_blob_size;
+    }
+
   for (i = 0; i < n; i++)
     {
       field_blob = (FieldBlob *)&rinfo->typelib->data[offset];
@@ -83,6 +91,66 @@ g_object_info_get_field_offset (GIObjectInfo *info,
   return offset;
 }
 
+static gint32
+g_object_info_get_property_offset (GIObjectInfo *info,
+                                  gint          n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_object_info_get_field_offset (info, blob->n_fields)
+    + n * header->property_blob_size;
+}
+
+static gint32
+g_object_info_get_method_offset (GIObjectInfo *info,
+                                gint          n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_object_info_get_property_offset (info, blob->n_properties)
+    + n * header->function_blob_size;
+}
+
+static gint32
+g_object_info_get_signal_offset (GIObjectInfo *info,
+                                gint          n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_object_info_get_method_offset (info, blob->n_methods)
+    + n * header->signal_blob_size;
+}
+
+static gint32
+g_object_info_get_vfunc_offset (GIObjectInfo *info,
+                               gint          n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_object_info_get_signal_offset (info, blob->n_signals)
+    + n * header->vfunc_blob_size;
+}
+
+static gint32
+g_object_info_get_constant_offset (GIObjectInfo *info,
+                                  gint          n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+  ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  return g_object_info_get_vfunc_offset (info, blob->n_vfuncs)
+    + n * header->constant_blob_size;
+}
+
 /**
  * g_object_info_get_parent:
  * @info: a #GIObjectInfo
@@ -249,6 +317,38 @@ g_object_info_get_interface (GIObjectInfo *info,
 						 rinfo->typelib, blob->interfaces[n]);
 }
 
+/**
+ * g_object_info_load_interface:
+ * @info: a #GIObjectInfo
+ * @n: index of interface to get
+ * @interface: (out caller-allocates): Initialized with the interface at
+ *   index @n
+ *
+ * Obtain an object type interface at index @n; this function is a variant
+ * of g_object_info_get_interface() designed for stack allocation.
+ *
+ * The initialized @interface must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_interface (GIObjectInfo    *info,
+                              gint             n,
+                              GIInterfaceInfo *interface)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  ObjectBlob *blob;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
+
+  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  _g_info_load_from_entry ((GIRealInfo *) interface, rinfo->repository,
+                           rinfo->typelib, blob->interfaces[n]);
+}
+
 /**
  * g_object_info_get_n_fields:
  * @info: a #GIObjectInfo
@@ -285,15 +385,42 @@ GIFieldInfo *
 g_object_info_get_field (GIObjectInfo *info,
 			 gint          n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  offset = g_object_info_get_field_offset(info, n);
+  return (GIFieldInfo *) g_info_new (GI_INFO_TYPE_FIELD, (GIBaseInfo*)info, rinfo->typelib,
+                         g_object_info_get_field_offset (info, n));
+}
 
-  return (GIFieldInfo *) g_info_new (GI_INFO_TYPE_FIELD, (GIBaseInfo*)info, rinfo->typelib, offset);
+/**
+ * g_object_info_load_field:
+ * @info: a #GIObjectInfo
+ * @n: index of field to get
+ * @field: (out caller-allocates): Initialized with an object type field at
+ *   index @n
+ *
+ * Obtain an object type field at index @n; this function is a variant of
+ * g_object_info_get_field() designed for stack allocation.
+ *
+ * The initialized @field must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_field (GIObjectInfo *info,
+                          gint          n,
+                          GIFieldInfo  *field)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
+
+  _g_info_init ((GIRealInfo *) field, GI_INFO_TYPE_FIELD, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_object_info_get_field_offset (info, n));
 }
 
 /**
@@ -331,22 +458,42 @@ GIPropertyInfo *
 g_object_info_get_property (GIObjectInfo *info,
 			    gint          n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIPropertyInfo *) g_info_new (GI_INFO_TYPE_PROPERTY, (GIBaseInfo*)info, rinfo->typelib,
+                            g_object_info_get_property_offset (info, n));
+}
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + n * header->property_blob_size;
+/**
+ * g_object_info_load_property:
+ * @info: a #GIObjectInfo
+ * @n: index of property to get
+ * @property: (out caller-allocates): Initialized with an object type
+ *   property at index @n
+ *
+ * Obtain an object type property at index @n; this function is a variant of
+ * g_object_info_get_property() designed for stack allocation.
+ *
+ * The initialized @property must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_property (GIObjectInfo   *info,
+                             gint            n,
+                             GIPropertyInfo *property)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
 
-  return (GIPropertyInfo *) g_info_new (GI_INFO_TYPE_PROPERTY, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) property, GI_INFO_TYPE_PROPERTY, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_object_info_get_property_offset (info, n));
 }
 
 /**
@@ -385,24 +532,42 @@ GIFunctionInfo *
 g_object_info_get_method (GIObjectInfo *info,
 			  gint          n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info, rinfo->typelib,
+                            g_object_info_get_method_offset (info, n));
+}
 
+/**
+ * g_object_info_load_method:
+ * @info: a #GIObjectInfo
+ * @n: index of method to get
+ * @method: (out caller-allocates): Initialized with an object type method
+ *   at index @n
+ *
+ * Obtain an object type method at index @n; this function is a variant of
+ * g_object_info_get_method() designed for stack allocation.
+ *
+ * The initialized @method must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_method (GIObjectInfo   *info,
+                           gint            n,
+                           GIFunctionInfo *method)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + blob->n_properties * header->property_blob_size
-    + n * header->function_blob_size;
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
 
-    return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info,
-					  rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) method, GI_INFO_TYPE_FUNCTION, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_object_info_get_method_offset (info, n));
 }
 
 /**
@@ -422,17 +587,14 @@ g_object_info_find_method (GIObjectInfo *info,
 {
   gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
   ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, 0);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), 0);
 
-  header = (Header *)rinfo->typelib->data;
   blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + blob->n_properties * header->property_blob_size;
+  offset = g_object_info_get_method_offset (info, 0);
 
   return _g_base_info_find_method ((GIBaseInfo*)info, offset, blob->n_methods, name);
 }
@@ -530,24 +692,42 @@ GISignalInfo *
 g_object_info_get_signal (GIObjectInfo *info,
 			  gint          n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GISignalInfo *) g_info_new (GI_INFO_TYPE_SIGNAL, (GIBaseInfo*)info, rinfo->typelib,
+                          g_object_info_get_signal_offset (info, n));
+}
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + n * header->signal_blob_size;
+/**
+ * g_object_info_load_signal:
+ * @info: a #GIObjectInfo
+ * @n: index of signal to get
+ * @signal: (out caller-allocates): Initialized with an object type signal
+ *   at index @n
+ *
+ * Obtain an object type signal at index @n; this function is a variant of
+ * g_object_info_get_signal() designed for stack allocation.
+ *
+ * The initialized @signal must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_signal (GIObjectInfo *info,
+                           gint          n,
+                           GISignalInfo *signal)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
 
-  return (GISignalInfo *) g_info_new (GI_INFO_TYPE_SIGNAL, (GIBaseInfo*)info,
-				      rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) signal, GI_INFO_TYPE_SIGNAL, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_object_info_get_signal_offset (info, n));
 }
 
 /**
@@ -563,23 +743,18 @@ GISignalInfo *
 g_object_info_find_signal (GIObjectInfo *info,
 			   const gchar  *name)
 {
-  gint n_signals;
-  gint i;
+  gint offset;
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  ObjectBlob *blob;
 
-  n_signals = g_object_info_get_n_signals (info);
-  for (i = 0; i < n_signals; i++)
-    {
-      GISignalInfo *siginfo = g_object_info_get_signal (info, i);
+  g_return_val_if_fail (info != NULL, NULL);
+  g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-      if (g_strcmp0 (g_base_info_get_name (siginfo), name) != 0)
-	{
-	  g_base_info_unref ((GIBaseInfo*)siginfo);
-	  continue;
-	}
+  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
 
-      return siginfo;
-    }
-  return NULL;
+  offset = g_object_info_get_signal_offset (info, 0);
+
+  return _g_base_info_find_signal ((GIBaseInfo*)info, offset, blob->n_signals, name);
 }
 
 
@@ -619,25 +794,42 @@ GIVFuncInfo *
 g_object_info_get_vfunc (GIObjectInfo *info,
 			 gint          n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIVFuncInfo *) g_info_new (GI_INFO_TYPE_VFUNC, (GIBaseInfo*)info, rinfo->typelib,
+                         g_object_info_get_vfunc_offset (info, n));
+}
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + blob->n_signals * header->signal_blob_size
-    + n * header->vfunc_blob_size;
+/**
+ * g_object_info_load_vfunc:
+ * @info: a #GIObjectInfo
+ * @n: index of virtual function to get
+ * @vfunc: (out caller-allocates): Initialized with an object type virtual
+ *   function at index @n
+ *
+ * Obtain an object type virtual function at index @n; this function is a
+ * variant of g_object_info_get_vfunc() designed for stack allocation.
+ *
+ * The initialized @vfunc must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_vfunc (GIObjectInfo *info,
+                          gint          n,
+                          GIVFuncInfo  *vfunc)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
 
-  return (GIVFuncInfo *) g_info_new (GI_INFO_TYPE_VFUNC, (GIBaseInfo*)info,
-				     rinfo->typelib, offset);
+  _g_info_init ((GIRealInfo *) vfunc, GI_INFO_TYPE_VFUNC, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_object_info_get_vfunc_offset (info, n));
 }
 
 /**
@@ -662,19 +854,14 @@ g_object_info_find_vfunc (GIObjectInfo *info,
 {
   gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
   ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
   blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + blob->n_signals * header->signal_blob_size;
+  offset = g_object_info_get_vfunc_offset (info, 0);
 
   return _g_base_info_find_vfunc (rinfo, offset, blob->n_vfuncs, name);
 }
@@ -775,26 +962,42 @@ GIConstantInfo *
 g_object_info_get_constant (GIObjectInfo *info,
 			    gint          n)
 {
-  gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header;
-  ObjectBlob *blob;
 
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  header = (Header *)rinfo->typelib->data;
-  blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+  return (GIConstantInfo *) g_info_new (GI_INFO_TYPE_CONSTANT, (GIBaseInfo*)info, rinfo->typelib,
+                            g_object_info_get_constant_offset (info, n));
+}
 
-  offset = g_object_info_get_field_offset(info, blob->n_fields)
-    + blob->n_properties * header->property_blob_size
-    + blob->n_methods * header->function_blob_size
-    + blob->n_signals * header->signal_blob_size
-    + blob->n_vfuncs * header->vfunc_blob_size
-    + n * header->constant_blob_size;
+/**
+ * g_object_info_load_constant:
+ * @info: a #GIObjectInfo
+ * @n: index of constant to get
+ * @constant: (out caller-allocates): Initialized with an object type
+ *   constant at index @n
+ *
+ * Obtain an object type constant at index @n; this function is a variant of
+ * g_object_info_get_constant() designed for stack allocation.
+ *
+ * The initialized @constant must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_object_info_load_constant (GIObjectInfo   *info,
+                             gint            n,
+                             GIConstantInfo *constant)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
 
-  return (GIConstantInfo *) g_info_new (GI_INFO_TYPE_CONSTANT, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_OBJECT_INFO (info));
+
+  _g_info_init ((GIRealInfo *) constant, GI_INFO_TYPE_CONSTANT, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_object_info_get_constant_offset (info, n));
 }
 
 /**
@@ -825,13 +1028,13 @@ g_object_info_get_class_struct (GIObjectInfo *info)
     return NULL;
 }
 
-typedef const char* (*SymbolGetter) (GIObjectInfo *info);
-
+/* Looks up the function named by the string at @func_offset in the
+ * ObjectBlob of @info or, failing that, of its closest ancestor */
 static void *
 _get_func(GIObjectInfo *info,
-          SymbolGetter getter)
+          gsize         func_offset)
 {
-  const char* symbol;
+  guint32 symbol;
   GSList *parents = NULL, *l;
   GIObjectInfo *parent_info;
   gpointer func = NULL;
@@ -845,12 +1048,17 @@ _get_func(GIObjectInfo *info,
 
   for (l = parents; l; l = l->next)
     {
-      parent_info = l->data;
-      symbol = getter (parent_info);
-      if (symbol == NULL)
+      GIRealInfo *rinfo = l->data;
+
+      /* Parents from namespaces that are not loaded are unresolved */
+      if (!GI_IS_OBJECT_INFO (rinfo))
+        continue;
+
+      symbol = G_STRUCT_MEMBER (guint32, &rinfo->typelib->data[rinfo->offset], func_offset);
+      if (symbol == 0)
         continue;
 
-      g_typelib_symbol (((GIRealInfo *)parent_info)->typelib, symbol, (gpointer*) &func);
+      _g_typelib_symbol_at (rinfo->typelib, symbol, &func);
       if (func)
         break;
     }
@@ -904,7 +1112,7 @@ g_object_info_get_ref_function_pointer (GIObjectInfo *info)
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  return (GIObjectInfoRefFunction)_get_func(info, (SymbolGetter)g_object_info_get_ref_function);
+  return (GIObjectInfoRefFunction)_get_func(info, G_STRUCT_OFFSET (ObjectBlob, ref_func));
 }
 
 /**
@@ -952,7 +1160,7 @@ g_object_info_get_unref_function_pointer (GIObjectInfo *info)
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  return (GIObjectInfoUnrefFunction)_get_func(info, (SymbolGetter)g_object_info_get_unref_function);
+  return (GIObjectInfoUnrefFunction)_get_func(info, G_STRUCT_OFFSET (ObjectBlob, unref_func));
 }
 
 /**
@@ -1001,7 +1209,7 @@ g_object_info_get_set_value_function_pointer (GIObjectInfo *info)
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  return (GIObjectInfoSetValueFunction)_get_func(info, (SymbolGetter)g_object_info_get_set_value_function);
+  return (GIObjectInfoSetValueFunction)_get_func(info, G_STRUCT_OFFSET (ObjectBlob, set_value_func));
 }
 
 /**
@@ -1050,5 +1258,5 @@ g_object_info_get_get_value_function_pointer (GIObjectInfo *info)
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (GI_IS_OBJECT_INFO (info), NULL);
 
-  return (GIObjectInfoGetValueFunction)_get_func(info, (SymbolGetter)g_object_info_get_get_value_function);
+  return (GIObjectInfoGetValueFunction)_get_func(info, G_STRUCT_OFFSET (ObjectBlob, get_value_func));
 }
@@ -100,6 +100,11 @@ GI_AVAILABLE_IN_ALL
 GIInterfaceInfo * g_object_info_get_interface    (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_interface   (GIObjectInfo    *info,
+                                                  gint             n,
+                                                  GIInterfaceInfo *interface);
+
 GI_AVAILABLE_IN_ALL
 gint              g_object_info_get_n_fields     (GIObjectInfo *info);
 
@@ -107,6 +112,11 @@ GI_AVAILABLE_IN_ALL
 GIFieldInfo *     g_object_info_get_field        (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_field       (GIObjectInfo *info,
+                                                  gint          n,
+                                                  GIFieldInfo  *field);
+
 GI_AVAILABLE_IN_ALL
 gint              g_object_info_get_n_properties (GIObjectInfo *info);
 
@@ -114,6 +124,11 @@ GI_AVAILABLE_IN_ALL
 GIPropertyInfo *  g_object_info_get_property     (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_property    (GIObjectInfo   *info,
+                                                  gint            n,
+                                                  GIPropertyInfo *property);
+
 GI_AVAILABLE_IN_ALL
 gint              g_object_info_get_n_methods    (GIObjectInfo *info);
 
@@ -121,6 +136,11 @@ GI_AVAILABLE_IN_ALL
 GIFunctionInfo *  g_object_info_get_method       (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_method      (GIObjectInfo   *info,
+                                                  gint            n,
+                                                  GIFunctionInfo *method);
+
 GI_AVAILABLE_IN_ALL
 GIFunctionInfo *  g_object_info_find_method      (GIObjectInfo *info,
 						  const gchar  *name);
@@ -139,6 +159,11 @@ GI_AVAILABLE_IN_ALL
 GISignalInfo *    g_object_info_get_signal       (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_signal      (GIObjectInfo *info,
+                                                  gint          n,
+                                                  GISignalInfo *signal);
+
 
 GI_AVAILABLE_IN_ALL
 GISignalInfo *    g_object_info_find_signal      (GIObjectInfo *info,
@@ -152,6 +177,11 @@ GI_AVAILABLE_IN_ALL
 GIVFuncInfo *     g_object_info_get_vfunc        (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_vfunc       (GIObjectInfo *info,
+                                                  gint          n,
+                                                  GIVFuncInfo  *vfunc);
+
 GI_AVAILABLE_IN_ALL
 GIVFuncInfo *     g_object_info_find_vfunc       (GIObjectInfo *info,
                                                   const gchar  *name);
@@ -168,6 +198,11 @@ GI_AVAILABLE_IN_ALL
 GIConstantInfo *  g_object_info_get_constant     (GIObjectInfo *info,
 						  gint          n);
 
+GI_AVAILABLE_IN_1_46
+void              g_object_info_load_constant    (GIObjectInfo   *info,
+                                                  gint            n,
+                                                  GIConstantInfo *constant);
+
 GI_AVAILABLE_IN_ALL
 GIStructInfo *    g_object_info_get_class_struct (GIObjectInfo *info);
 
@@ -113,6 +113,34 @@ g_registered_type_info_get_type_init (GIRegisteredTypeInfo *info)
   return NULL;
 }
 
+static GType
+resolve_g_type (GIRegisteredTypeInfo *info)
+{
+  const char *type_init;
+  GType (* get_type_func) (void);
+  GIRealInfo *rinfo = (GIRealInfo*)info;
+  RegisteredTypeBlob *blob;
+
+  type_init = g_registered_type_info_get_type_init (info);
+
+  if (type_init == NULL)
+    return G_TYPE_NONE;
+  else if (!strcmp (type_init, "intern"))
+    /* The special string "intern" is used for some types exposed by libgobject
+       (that therefore should be always available) */
+    return g_type_from_name (g_registered_type_info_get_type_name (info));
+
+  blob = (RegisteredTypeBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  get_type_func = NULL;
+  if (!_g_typelib_symbol_at (rinfo->typelib,
+                             blob->gtype_init,
+                             (void**) &get_type_func))
+    return G_TYPE_NONE;
+
+  return (* get_type_func) ();
+}
+
 /**
  * g_registered_type_info_get_g_type:
  * @info: a #GIRegisteredTypeInfo
@@ -122,33 +150,35 @@ g_registered_type_info_get_type_init (GIRegisteredTypeInfo *info)
  * that the shared library which provides the type_init function for this
  * @info cannot be called.
  *
+ * The #GType is only looked up the first time; it is then cached with the
+ * typelib, see also g_irepository_resolve_gtypes().
+ *
  * Returns: the #GType.
  */
 GType
 g_registered_type_info_get_g_type (GIRegisteredTypeInfo *info)
 {
-  const char *type_init;
-  GType (* get_type_func) (void);
   GIRealInfo *rinfo = (GIRealInfo*)info;
+  gsize *slot;
+  GType gtype;
 
   g_return_val_if_fail (info != NULL, G_TYPE_INVALID);
   g_return_val_if_fail (GI_IS_REGISTERED_TYPE_INFO (info), G_TYPE_INVALID);
 
-  type_init = g_registered_type_info_get_type_init (info);
+  slot = _g_typelib_get_gtype_slot (rinfo->typelib, rinfo->offset);
+  if (slot != NULL)
+    {
+      gtype = (GType) g_atomic_pointer_get (slot);
+      if (gtype != G_TYPE_INVALID)
+        return gtype;
+    }
 
-  if (type_init == NULL)
-    return G_TYPE_NONE;
-  else if (!strcmp (type_init, "intern"))
-    /* The special string "intern" is used for some types exposed by libgobject
-       (that therefore should be always available) */
-    return g_type_from_name (g_registered_type_info_get_type_name (info));
+  gtype = resolve_g_type (info);
 
-  get_type_func = NULL;
-  if (!g_typelib_symbol (rinfo->typelib,
-                         type_init,
-                         (void**) &get_type_func))
-    return G_TYPE_NONE;
+  /* Failures are not cached, the type may be registered later on */
+  if (slot != NULL && gtype != G_TYPE_INVALID && gtype != G_TYPE_NONE)
+    g_atomic_pointer_set (slot, gtype);
 
-  return (* get_type_func) ();
+  return gtype;
 }
 
@@ -60,7 +60,8 @@ struct _GIRealInfo
   guint32 type_is_embedded : 1; /* Used by GITypeInfo */
   guint32 reserved : 31;
 
-  gpointer reserved2[4];
+  GList *cache_link; /* in the repository's info cache, if cached */
+  gpointer reserved2[3];
 };
 
 struct _GIUnresolvedInfo
@@ -88,12 +89,36 @@ GIBaseInfo * _g_info_from_entry (GIRepository *repository,
                                  GITypelib     *typelib,
                                  guint16       index);
 
+void         _g_info_load_from_entry (GIRealInfo   *info,
+                                      GIRepository *repository,
+                                      GITypelib    *typelib,
+                                      guint16       index);
+
 GIBaseInfo * _g_info_new_full   (GIInfoType    type,
 				 GIRepository *repository,
 				 GIBaseInfo   *container,
 				 GITypelib     *typelib,
 				 guint32       offset);
 
+GIBaseInfo * _g_irepository_info_cache_lookup (GIRepository *repository,
+                                               GIInfoType    type,
+                                               GIBaseInfo   *container,
+                                               GITypelib    *typelib,
+                                               guint32       offset);
+
+GIBaseInfo * _g_irepository_info_cache_insert (GIRepository *repository,
+                                               GIBaseInfo   *info);
+
+gboolean     _g_irepository_find_entry (GIRepository  *repository,
+                                        const gchar   *namespace,
+                                        const gchar   *name,
+                                        GITypelib    **typelib,
+                                        GIInfoType    *type,
+                                        guint32       *offset);
+
+gboolean     _g_function_info_get_address (GIFunctionInfo *info,
+                                           gpointer       *address);
+
 GITypeInfo * _g_type_info_new   (GIBaseInfo   *container,
 				 GITypelib     *typelib,
 				 guint32       offset);
@@ -113,6 +138,11 @@ GIVFuncInfo * _g_base_info_find_vfunc (GIRealInfo   *rinfo,
 				       gint          n_vfuncs,
 				       const gchar  *name);
 
+GISignalInfo * _g_base_info_find_signal (GIBaseInfo   *base,
+					 guint32       offset,
+					 gint          n_signals,
+					 const gchar  *name);
+
 extern ffi_status ffi_prep_closure_loc (ffi_closure *,
                                         ffi_cif *,
                                         void (*fun)(ffi_cif *, void *, void **, void *),
@@ -41,6 +41,11 @@
  *
  * #GIRepository is used to manage repositories of namespaces. Namespaces
  * are represented on disk by type libraries (.typelib files).
+ *
+ * A #GIRepository may be used from several threads at once. Lookups of
+ * already loaded namespaces do not take any lock, while loading
+ * namespaces with g_irepository_require() and similar functions is
+ * serialized internally.
  */
 
 
@@ -48,12 +53,71 @@ static GIRepository *default_repository = NULL;
 static GSList *search_path = NULL;
 static GSList *override_search_path = NULL;
 
-struct _GIRepositoryPrivate
+/* A trie of the C prefixes of all loaded typelibs, used to route
+ * GType names to the typelibs likely to define them.
+ */
+typedef struct _PrefixNode PrefixNode;
+
+struct _PrefixNode
+{
+  gchar c;
+  PrefixNode *child;
+  PrefixNode *sibling;
+  GSList *typelibs; /* typelibs with a C prefix ending at this node */
+};
+
+typedef struct
+{
+  GMappedFile *mfile;
+  char *path;
+} TypelibBundle;
+
+typedef struct
 {
   GHashTable *typelibs; /* (string) namespace -> GITypelib */
   GHashTable *lazy_typelibs; /* (string) namespace-version -> GITypelib */
+  PrefixNode *prefixes; /* built from both tables when published */
+} GIRepositoryNamespaces;
+
+struct _GIRepositoryPrivate
+{
+  /* The loaded namespaces are published as an immutable snapshot, so
+   * lookups only need an atomic pointer read.  Registration is
+   * serialized by register_lock and publishes a modified copy; the
+   * superseded snapshots are retired until a publication or the last
+   * reader finds that no reader is using a snapshot, see
+   * namespaces_acquire().  All the readers share n_readers, which is a
+   * known contention point when many threads do lookups at once.
+   */
+  GIRepositoryNamespaces *namespaces;
+  GSList *retired_namespaces; /* protected by register_lock */
+  gint n_readers;
+  GPtrArray *typelib_keys; /* owns the keys of all namespace tables */
+  GRecMutex register_lock;
+
+  /* (string) directory -> (string) namespace -> GPtrArray of versions,
+   * or NULL if the directory can't be read; protected by register_lock
+   */
+  GHashTable *directories;
+  GSList *bundles; /* loaded TypelibBundles, protected by register_lock */
+
+  GRWLock cache_lock; /* protects the caches below */
   GHashTable *info_by_gtype; /* GType -> GIBaseInfo */
   GHashTable *info_by_error_domain; /* GQuark -> GIBaseInfo */
+  GHashTable *unknown_gtypes; /* set of GTypes not found in any namespace */
+
+  gint gtype_cache_hits;
+  gint gtype_cache_negative_hits;
+  gint gtype_cache_misses;
+
+  /* Canonical infos, see g_irepository_set_info_cache_size() */
+  GMutex info_cache_lock; /* protects the fields below */
+  gint info_cache_size; /* 0 when disabled, can be read atomically */
+  GHashTable *info_cache; /* set of GIRealInfo, by location */
+  GQueue info_cache_lru; /* GIRealInfo, most recently used first */
+  guint info_cache_allocations;
+  guint info_cache_hits;
+  guint info_cache_evictions;
 };
 
 G_DEFINE_TYPE (GIRepository, g_irepository, G_TYPE_OBJECT);
@@ -91,19 +155,247 @@ DllMain (HINSTANCE hinstDLL,
 
 #endif
 
+static PrefixNode *
+prefix_node_get_child (PrefixNode *node,
+                       gchar       c,
+                       gboolean    create)
+{
+  PrefixNode *child;
+
+  for (child = node->child; child; child = child->sibling)
+    if (child->c == c)
+      return child;
+
+  if (!create)
+    return NULL;
+
+  child = g_slice_new0 (PrefixNode);
+  child->c = c;
+  child->sibling = node->child;
+  node->child = child;
+
+  return child;
+}
+
+static void
+prefix_node_free (PrefixNode *node)
+{
+  while (node != NULL)
+    {
+      PrefixNode *sibling = node->sibling;
+
+      prefix_node_free (node->child);
+      g_slist_free (node->typelibs);
+      g_slice_free (PrefixNode, node);
+      node = sibling;
+    }
+}
+
+static void
+add_typelib_prefixes (gpointer key,
+                      gpointer value,
+                      gpointer data)
+{
+  GITypelib *typelib = value;
+  PrefixNode *root = data;
+  Header *header = (Header *) typelib->data;
+  const char *c_prefix;
+  char **prefixes;
+  int i;
+
+  c_prefix = g_typelib_get_string (typelib, header->c_prefix);
+  if (c_prefix == NULL || *c_prefix == '\0')
+    return;
+
+  /* c_prefix is a comma separated string of supported prefixes */
+  prefixes = g_strsplit (c_prefix, ",", 0);
+  for (i = 0; prefixes[i]; i++)
+    {
+      PrefixNode *node = root;
+      const char *p;
+
+      if (*prefixes[i] == '\0')
+        continue;
+
+      for (p = prefixes[i]; *p; p++)
+        node = prefix_node_get_child (node, *p, TRUE);
+
+      if (!g_slist_find (node->typelibs, typelib))
+        node->typelibs = g_slist_prepend (node->typelibs, typelib);
+    }
+  g_strfreev (prefixes);
+}
+
+static void
+namespaces_build_prefixes (GIRepositoryNamespaces *namespaces)
+{
+  PrefixNode *root;
+
+  root = g_slice_new0 (PrefixNode);
+  /* Added last, so that they come first in the per-prefix lists */
+  g_hash_table_foreach (namespaces->lazy_typelibs, add_typelib_prefixes, root);
+  g_hash_table_foreach (namespaces->typelibs, add_typelib_prefixes, root);
+
+  namespaces->prefixes = root;
+}
+
+static GIRepositoryNamespaces *
+namespaces_copy (GIRepositoryNamespaces *orig)
+{
+  GIRepositoryNamespaces *namespaces;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  namespaces = g_slice_new (GIRepositoryNamespaces);
+  namespaces->typelibs = g_hash_table_new (g_str_hash, g_str_equal);
+  namespaces->lazy_typelibs = g_hash_table_new (g_str_hash, g_str_equal);
+  namespaces->prefixes = NULL;
+
+  if (orig == NULL)
+    return namespaces;
+
+  g_hash_table_iter_init (&iter, orig->typelibs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    g_hash_table_insert (namespaces->typelibs, key, value);
+
+  g_hash_table_iter_init (&iter, orig->lazy_typelibs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    g_hash_table_insert (namespaces->lazy_typelibs, key, value);
+
+  return namespaces;
+}
+
+static void
+namespaces_free (GIRepositoryNamespaces *namespaces)
+{
+  g_hash_table_destroy (namespaces->typelibs);
+  g_hash_table_destroy (namespaces->lazy_typelibs);
+  prefix_node_free (namespaces->prefixes);
+  g_slice_free (GIRepositoryNamespaces, namespaces);
+}
+
+/* Must be called with register_lock held */
+static GIRepositoryNamespaces *
+get_namespaces (GIRepository *repository)
+{
+  return repository->priv->namespaces;
+}
+
+/* Readers count themselves before loading the snapshot, and must call
+ * namespaces_release() once they are done with it.  Once a publisher
+ * has replaced the snapshot, any later reader gets the new one, so the
+ * retired ones can be freed by whoever sees no reader under
+ * register_lock: the publisher, or the last reader leaving.
+ */
+static GIRepositoryNamespaces *
+namespaces_acquire (GIRepository *repository)
+{
+  g_atomic_int_inc (&repository->priv->n_readers);
+  return g_atomic_pointer_get (&repository->priv->namespaces);
+}
+
+/* Must be called with register_lock held */
+static void
+free_retired_namespaces (GIRepositoryPrivate *priv)
+{
+  if (priv->retired_namespaces == NULL ||
+      g_atomic_int_get (&priv->n_readers) != 0)
+    return;
+
+  g_slist_free_full (priv->retired_namespaces, (GDestroyNotify) namespaces_free);
+  priv->retired_namespaces = NULL;
+}
+
+static void
+namespaces_release (GIRepository *repository)
+{
+  GIRepositoryPrivate *priv = repository->priv;
+
+  if (!g_atomic_int_dec_and_test (&priv->n_readers))
+    return;
+
+  /* Without a steady gap between readers, no publication would ever
+   * see the count drop to zero.  If the lock is busy, the retired
+   * snapshots are left to the next publication or last reader. */
+  if (g_rec_mutex_trylock (&priv->register_lock))
+    {
+      free_retired_namespaces (priv);
+      g_rec_mutex_unlock (&priv->register_lock);
+    }
+}
+
+/* Must be called with register_lock held */
+static void
+publish_namespaces (GIRepository           *repository,
+                    GIRepositoryNamespaces *namespaces)
+{
+  GIRepositoryPrivate *priv = repository->priv;
+
+  namespaces_build_prefixes (namespaces);
+
+  priv->retired_namespaces = g_slist_prepend (priv->retired_namespaces,
+                                              priv->namespaces);
+  g_atomic_pointer_set (&priv->namespaces, namespaces);
+
+  free_retired_namespaces (priv);
+
+  /* A new namespace may provide types that previously weren't found */
+  g_rw_lock_writer_lock (&priv->cache_lock);
+  g_hash_table_remove_all (priv->unknown_gtypes);
+  g_rw_lock_writer_unlock (&priv->cache_lock);
+}
+
+static void
+free_directory_index (GHashTable *index)
+{
+  if (index != NULL)
+    g_hash_table_destroy (index);
+}
+
+static void
+free_bundle (TypelibBundle *bundle)
+{
+  g_mapped_file_unref (bundle->mfile);
+  g_free (bundle->path);
+  g_slice_free (TypelibBundle, bundle);
+}
+
+static guint
+info_cache_hash (gconstpointer key)
+{
+  const GIRealInfo *info = key;
+
+  return (g_direct_hash (info->typelib) ^ g_direct_hash (info->container)) * 31
+    + info->offset * 7 + info->type;
+}
+
+static gboolean
+info_cache_equal (gconstpointer a,
+                  gconstpointer b)
+{
+  const GIRealInfo *info_a = a;
+  const GIRealInfo *info_b = b;
+
+  return info_a->offset == info_b->offset &&
+    info_a->typelib == info_b->typelib &&
+    info_a->container == info_b->container &&
+    info_a->type == info_b->type;
+}
+
 static void
 g_irepository_init (GIRepository *repository)
 {
   repository->priv = G_TYPE_INSTANCE_GET_PRIVATE (repository, G_TYPE_IREPOSITORY,
 						  GIRepositoryPrivate);
-  repository->priv->typelibs
-    = g_hash_table_new_full (g_str_hash, g_str_equal,
-			     (GDestroyNotify) NULL,
-			     (GDestroyNotify) g_typelib_free);
-  repository->priv->lazy_typelibs
+  repository->priv->namespaces = namespaces_copy (NULL);
+  namespaces_build_prefixes (repository->priv->namespaces);
+  repository->priv->typelib_keys = g_ptr_array_new_with_free_func (g_free);
+  g_rec_mutex_init (&repository->priv->register_lock);
+  repository->priv->directories
     = g_hash_table_new_full (g_str_hash, g_str_equal,
                              (GDestroyNotify) g_free,
-                             (GDestroyNotify) NULL);
+                             (GDestroyNotify) free_directory_index);
+  g_rw_lock_init (&repository->priv->cache_lock);
   repository->priv->info_by_gtype
     = g_hash_table_new_full (g_direct_hash, g_direct_equal,
                              (GDestroyNotify) NULL,
@@ -112,17 +404,46 @@ g_irepository_init (GIRepository *repository)
     = g_hash_table_new_full (g_direct_hash, g_direct_equal,
                              (GDestroyNotify) NULL,
                              (GDestroyNotify) g_base_info_unref);
+  repository->priv->unknown_gtypes
+    = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_mutex_init (&repository->priv->info_cache_lock);
+  repository->priv->info_cache
+    = g_hash_table_new (info_cache_hash, info_cache_equal);
+  g_queue_init (&repository->priv->info_cache_lru);
+}
+
+static void
+free_typelib_value (gpointer key,
+                    gpointer value,
+                    gpointer data)
+{
+  g_typelib_free (value);
 }
 
 static void
 g_irepository_finalize (GObject *object)
 {
   GIRepository *repository = G_IREPOSITORY (object);
-
-  g_hash_table_destroy (repository->priv->typelibs);
-  g_hash_table_destroy (repository->priv->lazy_typelibs);
-  g_hash_table_destroy (repository->priv->info_by_gtype);
-  g_hash_table_destroy (repository->priv->info_by_error_domain);
+  GIRepositoryPrivate *priv = repository->priv;
+
+  g_hash_table_foreach (priv->namespaces->typelibs,
+                        (GHFunc) free_typelib_value, NULL);
+  namespaces_free (priv->namespaces);
+  g_slist_free_full (priv->retired_namespaces, (GDestroyNotify) namespaces_free);
+  g_ptr_array_unref (priv->typelib_keys);
+  g_hash_table_destroy (priv->directories);
+  /* After the typelibs, which point into the bundles */
+  g_slist_free_full (priv->bundles, (GDestroyNotify) free_bundle);
+  g_rec_mutex_clear (&priv->register_lock);
+
+  g_hash_table_destroy (priv->info_by_gtype);
+  g_hash_table_destroy (priv->info_by_error_domain);
+  g_hash_table_destroy (priv->unknown_gtypes);
+  g_rw_lock_clear (&priv->cache_lock);
+
+  /* Cached infos keep the repository alive, the cache is empty by now */
+  g_hash_table_destroy (priv->info_cache);
+  g_mutex_clear (&priv->info_cache_lock);
 
   (* G_OBJECT_CLASS (g_irepository_parent_class)->finalize) (G_OBJECT (repository));
 }
@@ -320,14 +641,20 @@ get_registered_status (GIRepository *repository,
 		       gboolean     *lazy_status,
 		       char        **version_conflict)
 {
+  GIRepositoryNamespaces *namespaces;
   GITypelib *typelib;
+  gboolean lazy;
   repository = get_repository (repository);
+  namespaces = namespaces_acquire (repository);
   if (lazy_status)
     *lazy_status = FALSE;
-  typelib = g_hash_table_lookup (repository->priv->typelibs, namespace);
-  if (typelib)
+  typelib = g_hash_table_lookup (namespaces->typelibs, namespace);
+  lazy = typelib == NULL;
+  if (lazy)
+    typelib = g_hash_table_lookup (namespaces->lazy_typelibs, namespace);
+  namespaces_release (repository);
+  if (!lazy)
     return check_version_conflict (typelib, namespace, version, version_conflict);
-  typelib = g_hash_table_lookup (repository->priv->lazy_typelibs, namespace);
   if (!typelib)
     return NULL;
   if (lazy_status)
@@ -383,6 +710,7 @@ load_dependencies_recurse (GIRepository *repository,
   return TRUE;
 }
 
+/* Must be called with register_lock held */
 static const char *
 register_internal (GIRepository *repository,
 		   const char   *source,
@@ -390,6 +718,7 @@ register_internal (GIRepository *repository,
 		   GITypelib     *typelib,
 		   GError      **error)
 {
+  GIRepositoryNamespaces *namespaces;
   Header *header;
   const gchar *namespace;
 
@@ -403,10 +732,15 @@ register_internal (GIRepository *repository,
 
   if (lazy)
     {
-      g_assert (!g_hash_table_lookup (repository->priv->lazy_typelibs,
+      char *key;
+
+      g_assert (!g_hash_table_lookup (get_namespaces (repository)->lazy_typelibs,
 				      namespace));
-      g_hash_table_insert (repository->priv->lazy_typelibs,
-			   build_typelib_key (namespace, source), (void *)typelib);
+      key = build_typelib_key (namespace, source);
+      g_ptr_array_add (repository->priv->typelib_keys, key);
+
+      namespaces = namespaces_copy (get_namespaces (repository));
+      g_hash_table_insert (namespaces->lazy_typelibs, key, (void *)typelib);
     }
   else
     {
@@ -417,17 +751,25 @@ register_internal (GIRepository *repository,
       if (!load_dependencies_recurse (repository, typelib, error))
 	return NULL;
 
+      /* Copy after the dependencies, which publish their own snapshots */
+      namespaces = namespaces_copy (get_namespaces (repository));
+
       /* Check if we are transitioning from lazily loaded state */
-      if (g_hash_table_lookup_extended (repository->priv->lazy_typelibs,
+      if (g_hash_table_lookup_extended (namespaces->lazy_typelibs,
 					namespace,
 					(gpointer)&key, &value))
-	g_hash_table_remove (repository->priv->lazy_typelibs, key);
+	g_hash_table_remove (namespaces->lazy_typelibs, key);
       else
-	key = build_typelib_key (namespace, source);
+	{
+	  key = build_typelib_key (namespace, source);
+	  g_ptr_array_add (repository->priv->typelib_keys, key);
+	}
 
-      g_hash_table_insert (repository->priv->typelibs, key, (void *)typelib);
+      g_hash_table_insert (namespaces->typelibs, key, (void *)typelib);
     }
 
+  publish_namespaces (repository, namespaces);
+
   return namespace;
 }
 
@@ -594,6 +936,7 @@ g_irepository_load_typelib (GIRepository *repository,
   gboolean allow_lazy = flags & G_IREPOSITORY_LOAD_FLAG_LAZY;
   gboolean is_lazy;
   char *version_conflict;
+  const char *ret;
 
   repository = get_repository (repository);
 
@@ -601,6 +944,8 @@ g_irepository_load_typelib (GIRepository *repository,
   namespace = g_typelib_get_string (typelib, header->namespace);
   nsversion = g_typelib_get_string (typelib, header->nsversion);
 
+  g_rec_mutex_lock (&repository->priv->register_lock);
+
   if (get_registered_status (repository, namespace, nsversion, allow_lazy,
 			     &is_lazy, &version_conflict))
     {
@@ -610,12 +955,18 @@ g_irepository_load_typelib (GIRepository *repository,
 		       G_IREPOSITORY_ERROR_NAMESPACE_VERSION_CONFLICT,
 		       "Attempting to load namespace '%s', version '%s', but '%s' is already loaded",
 		       namespace, nsversion, version_conflict);
-	  return NULL;
+	  ret = NULL;
 	}
-      return namespace;
+      else
+	ret = namespace;
     }
-  return register_internal (repository, "<builtin>",
-			    allow_lazy, typelib, error);
+  else
+    ret = register_internal (repository, "<builtin>",
+			     allow_lazy, typelib, error);
+
+  g_rec_mutex_unlock (&repository->priv->register_lock);
+
+  return ret;
 }
 
 /**
@@ -697,6 +1048,264 @@ g_irepository_get_n_infos (GIRepository *repository,
   return n_interfaces;
 }
 
+/**
+ * g_irepository_resolve_gtypes:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @namespace_: Namespace to resolve
+ *
+ * Looks up the #GType of every registered type of @namespace_, calling
+ * their type_init functions, so that later calls to
+ * g_registered_type_info_get_g_type() find them in the cache of the
+ * typelib.  The namespace must have already been loaded before calling
+ * this function.
+ *
+ * Returns: the number of types resolved
+ * Since: 1.46
+ */
+guint
+g_irepository_resolve_gtypes (GIRepository *repository,
+			      const gchar  *namespace)
+{
+  GITypelib *typelib;
+  guint n_entries, i;
+  guint n_resolved = 0;
+
+  g_return_val_if_fail (namespace != NULL, 0);
+
+  repository = get_repository (repository);
+  typelib = get_registered (repository, namespace, NULL);
+  g_return_val_if_fail (typelib != NULL, 0);
+
+  n_entries = ((Header *)typelib->data)->n_local_entries;
+  for (i = 0; i < n_entries; i++)
+    {
+      DirEntry *entry = g_typelib_get_dir_entry (typelib, i + 1);
+      GIBaseInfo info;
+      GType gtype;
+
+      _g_info_init ((GIRealInfo *) &info, entry->blob_type, repository,
+		    NULL, typelib, entry->offset);
+      if (!GI_IS_REGISTERED_TYPE_INFO (&info))
+	continue;
+
+      gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) &info);
+      if (gtype != G_TYPE_INVALID && gtype != G_TYPE_NONE)
+	n_resolved++;
+    }
+
+  return n_resolved;
+}
+
+typedef struct {
+  GIRepository *repository;
+  gchar *namespace;
+} ResolveGTypesData;
+
+static gpointer
+resolve_gtypes_thread (gpointer user_data)
+{
+  ResolveGTypesData *data = user_data;
+  guint n_resolved;
+
+  n_resolved = g_irepository_resolve_gtypes (data->repository, data->namespace);
+
+  g_object_unref (data->repository);
+  g_free (data->namespace);
+  g_slice_free (ResolveGTypesData, data);
+  return GUINT_TO_POINTER (n_resolved);
+}
+
+/**
+ * g_irepository_resolve_gtypes_in_thread: (skip)
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @namespace_: Namespace to resolve
+ *
+ * Like g_irepository_resolve_gtypes(), but resolves the types in a
+ * background thread, so that an application can warm up the cache of
+ * a namespace while it does other work.  Lookups done in the meantime
+ * resolve their type themselves, as when the cache is cold.
+ *
+ * The thread calls the type_init functions of the namespace, so it
+ * must be joined with g_thread_join() before the application shuts
+ * down; g_thread_join() returns the number of types resolved, to be
+ * converted with GPOINTER_TO_UINT().
+ *
+ * Returns: (transfer full): the thread resolving the types, or %NULL
+ *   on error
+ * Since: 1.46
+ */
+GThread *
+g_irepository_resolve_gtypes_in_thread (GIRepository *repository,
+					const gchar  *namespace)
+{
+  ResolveGTypesData *data;
+
+  g_return_val_if_fail (namespace != NULL, NULL);
+
+  repository = get_repository (repository);
+  g_return_val_if_fail (get_registered (repository, namespace, NULL) != NULL, NULL);
+
+  data = g_slice_new (ResolveGTypesData);
+  data->repository = g_object_ref (repository);
+  data->namespace = g_strdup (namespace);
+
+  return g_thread_new ("gi-resolve-gtypes", resolve_gtypes_thread, data);
+}
+
+static void
+add_function_symbol (GArray     *names,
+		     GIBaseInfo *info)
+{
+  GIRealInfo *rinfo = (GIRealInfo *) info;
+  FunctionBlob *blob = (FunctionBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  g_array_append_val (names, blob->symbol);
+}
+
+static void
+add_symbol_names (GArray     *names,
+		  GIBaseInfo *info)
+{
+  GIRealInfo *rinfo = (GIRealInfo *) info;
+  GIBaseInfo method;
+  gint i;
+
+  if (GI_IS_REGISTERED_TYPE_INFO (info))
+    {
+      RegisteredTypeBlob *blob = (RegisteredTypeBlob *)&rinfo->typelib->data[rinfo->offset];
+      const gchar *type_init = g_registered_type_info_get_type_init ((GIRegisteredTypeInfo *) info);
+
+      if (type_init != NULL && strcmp (type_init, "intern") != 0)
+	g_array_append_val (names, blob->gtype_init);
+    }
+
+  switch (g_base_info_get_type (info))
+    {
+    case GI_INFO_TYPE_FUNCTION:
+      add_function_symbol (names, info);
+      break;
+    case GI_INFO_TYPE_OBJECT:
+      {
+	ObjectBlob *blob = (ObjectBlob *)&rinfo->typelib->data[rinfo->offset];
+	guint32 funcs[] = { blob->ref_func, blob->unref_func,
+			    blob->set_value_func, blob->get_value_func };
+	guint j;
+
+	for (j = 0; j < G_N_ELEMENTS (funcs); j++)
+	  if (funcs[j] != 0)
+	    g_array_append_val (names, funcs[j]);
+
+	for (i = 0; i < g_object_info_get_n_methods ((GIObjectInfo *) info); i++)
+	  {
+	    g_object_info_load_method ((GIObjectInfo *) info, i, (GIFunctionInfo *) &method);
+	    add_function_symbol (names, &method);
+	  }
+      }
+      break;
+    case GI_INFO_TYPE_INTERFACE:
+      for (i = 0; i < g_interface_info_get_n_methods ((GIInterfaceInfo *) info); i++)
+	{
+	  g_interface_info_load_method ((GIInterfaceInfo *) info, i, (GIFunctionInfo *) &method);
+	  add_function_symbol (names, &method);
+	}
+      break;
+    case GI_INFO_TYPE_STRUCT:
+      for (i = 0; i < g_struct_info_get_n_methods ((GIStructInfo *) info); i++)
+	{
+	  g_struct_info_load_method ((GIStructInfo *) info, i, (GIFunctionInfo *) &method);
+	  add_function_symbol (names, &method);
+	}
+      break;
+    case GI_INFO_TYPE_BOXED:
+      {
+	GIBaseInfo struct_info;
+
+	/* Boxed entries are written as struct blobs */
+	_g_info_init ((GIRealInfo *) &struct_info, GI_INFO_TYPE_STRUCT, rinfo->repository,
+		      NULL, rinfo->typelib, rinfo->offset);
+	for (i = 0; i < g_struct_info_get_n_methods ((GIStructInfo *) &struct_info); i++)
+	  {
+	    g_struct_info_load_method ((GIStructInfo *) &struct_info, i, (GIFunctionInfo *) &method);
+	    add_function_symbol (names, &method);
+	  }
+      }
+      break;
+    case GI_INFO_TYPE_UNION:
+      for (i = 0; i < g_union_info_get_n_methods ((GIUnionInfo *) info); i++)
+	{
+	  g_union_info_load_method ((GIUnionInfo *) info, i, (GIFunctionInfo *) &method);
+	  add_function_symbol (names, &method);
+	}
+      break;
+    case GI_INFO_TYPE_ENUM:
+    case GI_INFO_TYPE_FLAGS:
+      for (i = 0; i < g_enum_info_get_n_methods ((GIEnumInfo *) info); i++)
+	{
+	  g_enum_info_load_method ((GIEnumInfo *) info, i, (GIFunctionInfo *) &method);
+	  add_function_symbol (names, &method);
+	}
+      break;
+    default:
+      break;
+    }
+}
+
+/**
+ * g_irepository_resolve_symbols:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @namespace_: Namespace to resolve
+ *
+ * Looks up the symbols of all the functions and methods of @namespace_,
+ * along with the type_init functions of its registered types, and keeps
+ * their addresses in a table of the typelib.  Later lookups of these
+ * symbols, for instance by g_function_info_prep_invoker() or
+ * g_registered_type_info_get_g_type(), are then served from that table
+ * rather than from the shared libraries.  The namespace must have
+ * already been loaded before calling this function.
+ *
+ * Symbols looked up individually are also cached, so this is only
+ * useful to pay the cost of the lookups upfront.
+ *
+ * Returns: the number of symbols found
+ * Since: 1.46
+ */
+guint
+g_irepository_resolve_symbols (GIRepository *repository,
+			       const gchar  *namespace)
+{
+  GITypelib *typelib;
+  GArray *names;
+  guint n_entries, i;
+  guint n_resolved;
+
+  g_return_val_if_fail (namespace != NULL, 0);
+
+  repository = get_repository (repository);
+  typelib = get_registered (repository, namespace, NULL);
+  g_return_val_if_fail (typelib != NULL, 0);
+
+  names = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  n_entries = ((Header *)typelib->data)->n_local_entries;
+  for (i = 0; i < n_entries; i++)
+    {
+      DirEntry *entry = g_typelib_get_dir_entry (typelib, i + 1);
+      GIBaseInfo info;
+
+      _g_info_init ((GIRealInfo *) &info, entry->blob_type, repository,
+		    NULL, typelib, entry->offset);
+      add_symbol_names (names, &info);
+    }
+
+  n_resolved = _g_typelib_resolve_symbols (typelib, (guint32 *) names->data, names->len);
+  g_array_free (names, TRUE);
+
+  return n_resolved;
+}
+
 /**
  * g_irepository_get_info:
  * @repository: (allow-none): A #GIRepository or %NULL for the singleton
@@ -743,7 +1352,7 @@ typedef struct {
 } FindByGTypeData;
 
 static DirEntry *
-find_by_gtype (GHashTable *table, FindByGTypeData *data, gboolean check_prefix)
+find_by_gtype (GHashTable *table, FindByGTypeData *data)
 {
   GHashTableIter iter;
   gpointer key, value;
@@ -753,13 +1362,6 @@ find_by_gtype (GHashTable *table, FindByGTypeData *data, gboolean check_prefix)
   while (g_hash_table_iter_next (&iter, &key, &value))
     {
       GITypelib *typelib = (GITypelib*)value;
-      if (check_prefix)
-        {
-          if (!g_typelib_matches_gtype_name_prefix (typelib, data->gtype_name))
-            continue;
-
-          data->found_prefix = TRUE;
-        }
 
       ret = g_typelib_get_dir_entry_by_gtype_name (typelib, data->gtype_name);
       if (ret)
@@ -772,11 +1374,63 @@ find_by_gtype (GHashTable *table, FindByGTypeData *data, gboolean check_prefix)
   return NULL;
 }
 
-/**
- * g_irepository_find_by_gtype:
- * @repository: (allow-none): A #GIRepository or %NULL for the singleton
- *   process-global default #GIRepository
- * @gtype: GType to search for
+/* Only searches the typelibs offering a C prefix of the GType name
+ * which is followed by a capital letter.  For example, a typelib
+ * offering the 'Gdk' prefix matches GdkX11Cursor, however a typelib
+ * offering the 'G' prefix does not.
+ */
+static DirEntry *
+find_by_gtype_prefix (PrefixNode *prefixes, FindByGTypeData *data)
+{
+  PrefixNode *node = prefixes;
+  const gchar *p;
+  GSList *l;
+  DirEntry *ret;
+
+  for (p = data->gtype_name; *p; p++)
+    {
+      node = prefix_node_get_child (node, *p, FALSE);
+      if (node == NULL)
+        break;
+
+      if (node->typelibs == NULL || !g_ascii_isupper (p[1]))
+        continue;
+
+      for (l = node->typelibs; l; l = l->next)
+        {
+          GITypelib *typelib = l->data;
+
+          data->found_prefix = TRUE;
+
+          ret = g_typelib_get_dir_entry_by_gtype_name (typelib, data->gtype_name);
+          if (ret)
+            {
+              data->result_typelib = typelib;
+              return ret;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+static void
+remember_unknown_gtype (GIRepository           *repository,
+			GIRepositoryNamespaces *searched,
+			GType                   gtype)
+{
+  g_rw_lock_writer_lock (&repository->priv->cache_lock);
+  /* Don't record a miss if a namespace was registered meanwhile */
+  if (g_atomic_pointer_get (&repository->priv->namespaces) == searched)
+    g_hash_table_add (repository->priv->unknown_gtypes, (gpointer) gtype);
+  g_rw_lock_writer_unlock (&repository->priv->cache_lock);
+}
+
+/**
+ * g_irepository_find_by_gtype:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @gtype: GType to search for
  *
  * Searches all loaded namespaces for a particular #GType.  Note that
  * in order to locate the metadata, the namespace corresponding to
@@ -791,17 +1445,42 @@ GIBaseInfo *
 g_irepository_find_by_gtype (GIRepository *repository,
 			     GType         gtype)
 {
+  GIRepositoryNamespaces *namespaces;
   FindByGTypeData data;
   GIBaseInfo *cached;
+  gboolean unknown;
   DirEntry *entry;
 
   repository = get_repository (repository);
 
+  /* Take the snapshot before consulting the caches, so that a miss
+   * recorded below can be checked against concurrent registrations.
+   */
+  namespaces = namespaces_acquire (repository);
+
+  g_rw_lock_reader_lock (&repository->priv->cache_lock);
   cached = g_hash_table_lookup (repository->priv->info_by_gtype,
 				(gpointer)gtype);
+  if (cached != NULL)
+    g_base_info_ref (cached);
+  unknown = cached == NULL &&
+    g_hash_table_contains (repository->priv->unknown_gtypes, (gpointer)gtype);
+  g_rw_lock_reader_unlock (&repository->priv->cache_lock);
 
   if (cached != NULL)
-    return g_base_info_ref (cached);
+    {
+      g_atomic_int_inc (&repository->priv->gtype_cache_hits);
+      namespaces_release (repository);
+      return cached;
+    }
+  if (unknown)
+    {
+      g_atomic_int_inc (&repository->priv->gtype_cache_negative_hits);
+      namespaces_release (repository);
+      return NULL;
+    }
+
+  g_atomic_int_inc (&repository->priv->gtype_cache_misses);
 
   data.gtype_name = g_type_name (gtype);
   data.result_typelib = NULL;
@@ -826,16 +1505,18 @@ g_irepository_find_by_gtype (GIRepository *repository,
    * target type does not have this typelib's C prefix. Use this
    * assumption as our first attempt at locating the DirEntry.
    */
-  entry = find_by_gtype (repository->priv->typelibs, &data, TRUE);
-  if (entry == NULL)
-    entry = find_by_gtype (repository->priv->lazy_typelibs, &data, TRUE);
+  entry = find_by_gtype_prefix (namespaces->prefixes, &data);
 
   /* If we have no result, but we did find a typelib claiming to
    * offer bindings for such a prefix, bail out now on the assumption
    * that a more exhaustive search would not produce any results.
    */
   if (entry == NULL && data.found_prefix)
+    {
+      remember_unknown_gtype (repository, namespaces, gtype);
+      namespaces_release (repository);
       return NULL;
+    }
 
   /* Not ever class library necessarily specifies a correct c_prefix,
    * so take a second pass. This time we will try a global lookup,
@@ -843,24 +1524,276 @@ g_irepository_find_by_gtype (GIRepository *repository,
    * See http://bugzilla.gnome.org/show_bug.cgi?id=564016
    */
   if (entry == NULL)
-    entry = find_by_gtype (repository->priv->typelibs, &data, FALSE);
+    entry = find_by_gtype (namespaces->typelibs, &data);
   if (entry == NULL)
-    entry = find_by_gtype (repository->priv->lazy_typelibs, &data, FALSE);
+    entry = find_by_gtype (namespaces->lazy_typelibs, &data);
 
   if (entry != NULL)
     {
+      GIBaseInfo *existing;
+
+      namespaces_release (repository);
+
       cached = _g_info_new_full (entry->blob_type,
 				 repository,
 				 NULL, data.result_typelib, entry->offset);
 
-      g_hash_table_insert (repository->priv->info_by_gtype,
-			   (gpointer) gtype,
-			   g_base_info_ref (cached));
+      /* Another thread may have cached the same type meanwhile */
+      g_rw_lock_writer_lock (&repository->priv->cache_lock);
+      existing = g_hash_table_lookup (repository->priv->info_by_gtype,
+				      (gpointer) gtype);
+      if (existing == NULL)
+	g_hash_table_insert (repository->priv->info_by_gtype,
+			     (gpointer) gtype,
+			     g_base_info_ref (cached));
+      g_rw_lock_writer_unlock (&repository->priv->cache_lock);
+
       return cached;
     }
+
+  remember_unknown_gtype (repository, namespaces, gtype);
+  namespaces_release (repository);
   return NULL;
 }
 
+/**
+ * g_irepository_get_gtype_cache_stats:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @hits: (out) (allow-none): return location for the number of lookups
+ *   answered from the cache of found types
+ * @negative_hits: (out) (allow-none): return location for the number of
+ *   lookups answered from the cache of types not found in any namespace
+ * @misses: (out) (allow-none): return location for the number of lookups
+ *   which had to search the loaded namespaces
+ *
+ * Obtains counters for the caches used by g_irepository_find_by_gtype().
+ * Types which are not found are remembered until another namespace is
+ * loaded.
+ *
+ * Since: 1.46
+ */
+void
+g_irepository_get_gtype_cache_stats (GIRepository *repository,
+				     guint        *hits,
+				     guint        *negative_hits,
+				     guint        *misses)
+{
+  repository = get_repository (repository);
+
+  if (hits)
+    *hits = g_atomic_int_get (&repository->priv->gtype_cache_hits);
+  if (negative_hits)
+    *negative_hits = g_atomic_int_get (&repository->priv->gtype_cache_negative_hits);
+  if (misses)
+    *misses = g_atomic_int_get (&repository->priv->gtype_cache_misses);
+}
+
+/* Must be called with info_cache_lock held; returns the infos to
+ * unref once it is released */
+static GSList *
+info_cache_trim (GIRepositoryPrivate *priv,
+                 guint                size)
+{
+  GSList *evicted = NULL;
+
+  while (g_queue_get_length (&priv->info_cache_lru) > size)
+    {
+      GList *link = g_queue_pop_tail_link (&priv->info_cache_lru);
+      GIRealInfo *info = link->data;
+
+      g_hash_table_remove (priv->info_cache, info);
+      info->cache_link = NULL;
+      g_list_free_1 (link);
+
+      evicted = g_slist_prepend (evicted, info);
+      priv->info_cache_evictions++;
+    }
+
+  return evicted;
+}
+
+GIBaseInfo *
+_g_irepository_info_cache_lookup (GIRepository *repository,
+                                  GIInfoType    type,
+                                  GIBaseInfo   *container,
+                                  GITypelib    *typelib,
+                                  guint32       offset)
+{
+  GIRepositoryPrivate *priv = repository->priv;
+  GIRealInfo key;
+  GIRealInfo *info;
+
+  if (g_atomic_int_get (&priv->info_cache_size) == 0)
+    return NULL;
+
+  key.type = type;
+  key.container = container;
+  key.typelib = typelib;
+  key.offset = offset;
+
+  g_mutex_lock (&priv->info_cache_lock);
+  info = g_hash_table_lookup (priv->info_cache, &key);
+  if (info != NULL)
+    {
+      g_base_info_ref ((GIBaseInfo *) info);
+      g_queue_unlink (&priv->info_cache_lru, info->cache_link);
+      g_queue_push_head_link (&priv->info_cache_lru, info->cache_link);
+      priv->info_cache_hits++;
+    }
+  g_mutex_unlock (&priv->info_cache_lock);
+
+  return (GIBaseInfo *) info;
+}
+
+/* Takes @info, a newly allocated info, and returns the canonical info
+ * for its location */
+GIBaseInfo *
+_g_irepository_info_cache_insert (GIRepository *repository,
+                                  GIBaseInfo   *info)
+{
+  GIRepositoryPrivate *priv = repository->priv;
+  GIRealInfo *rinfo = (GIRealInfo *) info;
+  GIRealInfo *existing;
+  GSList *evicted;
+
+  if (g_atomic_int_get (&priv->info_cache_size) == 0)
+    return info;
+
+  g_mutex_lock (&priv->info_cache_lock);
+
+  priv->info_cache_allocations++;
+
+  /* Another thread may have cached the same info meanwhile */
+  existing = g_hash_table_lookup (priv->info_cache, rinfo);
+  if (existing != NULL)
+    {
+      g_base_info_ref ((GIBaseInfo *) existing);
+      g_mutex_unlock (&priv->info_cache_lock);
+
+      g_base_info_unref (info);
+      return (GIBaseInfo *) existing;
+    }
+
+  g_hash_table_add (priv->info_cache, rinfo);
+  g_queue_push_head (&priv->info_cache_lru, g_base_info_ref (info));
+  rinfo->cache_link = g_queue_peek_head_link (&priv->info_cache_lru);
+
+  evicted = info_cache_trim (priv, priv->info_cache_size);
+
+  g_mutex_unlock (&priv->info_cache_lock);
+
+  g_slist_free_full (evicted, (GDestroyNotify) g_base_info_unref);
+
+  return info;
+}
+
+/**
+ * g_irepository_set_info_cache_size:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @max_infos: the maximum number of infos to keep, or 0 to disable
+ *   the cache
+ *
+ * Enables the cache of infos of @repository.  While it is enabled,
+ * the functions returning infos, such as g_irepository_find_by_name()
+ * or g_object_info_get_method(), return the same info every time they
+ * are asked for the same one, instead of allocating a new one.
+ *
+ * The cache keeps a reference on up to @max_infos of the most
+ * recently used infos, each of which takes about 80 bytes, and on the
+ * infos containing them.  It also keeps @repository alive until the
+ * cache is disabled again.  The cache is disabled by default.
+ *
+ * Since: 1.46
+ */
+void
+g_irepository_set_info_cache_size (GIRepository *repository,
+                                   guint         max_infos)
+{
+  GIRepositoryPrivate *priv;
+  GSList *evicted;
+
+  repository = get_repository (repository);
+  priv = repository->priv;
+
+  max_infos = MIN (max_infos, G_MAXINT);
+
+  g_mutex_lock (&priv->info_cache_lock);
+  g_atomic_int_set (&priv->info_cache_size, max_infos);
+  evicted = info_cache_trim (priv, max_infos);
+  g_mutex_unlock (&priv->info_cache_lock);
+
+  g_slist_free_full (evicted, (GDestroyNotify) g_base_info_unref);
+}
+
+/**
+ * g_irepository_get_info_cache_stats:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @allocations: (out) (allow-none): return location for the number of
+ *   infos allocated while the cache was enabled
+ * @hits: (out) (allow-none): return location for the number of infos
+ *   returned from the cache
+ * @evictions: (out) (allow-none): return location for the number of
+ *   infos dropped from the cache to keep it within its size
+ *
+ * Obtains counters for the cache enabled by
+ * g_irepository_set_info_cache_size().
+ *
+ * Since: 1.46
+ */
+void
+g_irepository_get_info_cache_stats (GIRepository *repository,
+                                    guint        *allocations,
+                                    guint        *hits,
+                                    guint        *evictions)
+{
+  GIRepositoryPrivate *priv;
+
+  repository = get_repository (repository);
+  priv = repository->priv;
+
+  g_mutex_lock (&priv->info_cache_lock);
+  if (allocations)
+    *allocations = priv->info_cache_allocations;
+  if (hits)
+    *hits = priv->info_cache_hits;
+  if (evictions)
+    *evictions = priv->info_cache_evictions;
+  g_mutex_unlock (&priv->info_cache_lock);
+}
+
+/* Like g_irepository_find_by_name(), but returns the location of the
+ * entry instead of allocating an info for it, and tolerates namespaces
+ * that are not loaded, as references from other typelibs may point to
+ * them.
+ */
+gboolean
+_g_irepository_find_entry (GIRepository  *repository,
+                           const gchar   *namespace,
+                           const gchar   *name,
+                           GITypelib    **typelib_out,
+                           GIInfoType    *type,
+                           guint32       *offset)
+{
+  GITypelib *typelib;
+  DirEntry *entry;
+
+  typelib = get_registered (repository, namespace, NULL);
+  if (typelib == NULL)
+    return FALSE;
+
+  entry = g_typelib_get_dir_entry_by_name (typelib, name);
+  if (entry == NULL)
+    return FALSE;
+
+  *typelib_out = typelib;
+  *type = entry->blob_type;
+  *offset = entry->offset;
+  return TRUE;
+}
+
 /**
  * g_irepository_find_by_name:
  * @repository: (allow-none): A #GIRepository or %NULL for the singleton
@@ -940,25 +1873,33 @@ GIEnumInfo *
 g_irepository_find_by_error_domain (GIRepository *repository,
 				    GQuark        domain)
 {
+  GIRepositoryNamespaces *namespaces;
   FindByErrorDomainData data;
   GIEnumInfo *cached;
 
   repository = get_repository (repository);
 
+  g_rw_lock_reader_lock (&repository->priv->cache_lock);
   cached = g_hash_table_lookup (repository->priv->info_by_error_domain,
 				GUINT_TO_POINTER (domain));
+  if (cached != NULL)
+    g_base_info_ref ((GIBaseInfo *)cached);
+  g_rw_lock_reader_unlock (&repository->priv->cache_lock);
 
   if (cached != NULL)
-    return g_base_info_ref ((GIBaseInfo *)cached);
+    return cached;
+
+  namespaces = namespaces_acquire (repository);
 
   data.repository = repository;
   data.domain = domain;
   data.result_typelib = NULL;
   data.result = NULL;
 
-  g_hash_table_foreach (repository->priv->typelibs, find_by_error_domain_foreach, &data);
+  g_hash_table_foreach (namespaces->typelibs, find_by_error_domain_foreach, &data);
   if (data.result == NULL)
-    g_hash_table_foreach (repository->priv->lazy_typelibs, find_by_error_domain_foreach, &data);
+    g_hash_table_foreach (namespaces->lazy_typelibs, find_by_error_domain_foreach, &data);
+  namespaces_release (repository);
 
   if (data.result != NULL)
     {
@@ -966,9 +1907,14 @@ g_irepository_find_by_error_domain (GIRepository *repository,
 				 repository,
 				 NULL, data.result_typelib, data.result->offset);
 
-      g_hash_table_insert (repository->priv->info_by_error_domain,
-			   GUINT_TO_POINTER (domain),
-			   g_base_info_ref (cached));
+      g_rw_lock_writer_lock (&repository->priv->cache_lock);
+      if (g_hash_table_lookup (repository->priv->info_by_error_domain,
+			       GUINT_TO_POINTER (domain)) == NULL)
+	g_hash_table_insert (repository->priv->info_by_error_domain,
+			     GUINT_TO_POINTER (domain),
+			     g_base_info_ref (cached));
+      g_rw_lock_writer_unlock (&repository->priv->cache_lock);
+
       return cached;
     }
   return NULL;
@@ -996,20 +1942,23 @@ collect_namespaces (gpointer key,
 gchar **
 g_irepository_get_loaded_namespaces (GIRepository *repository)
 {
+  GIRepositoryNamespaces *namespaces;
   GList *l, *list = NULL;
   gchar **names;
   gint i;
 
   repository = get_repository (repository);
+  namespaces = namespaces_acquire (repository);
 
-  g_hash_table_foreach (repository->priv->typelibs, collect_namespaces, &list);
-  g_hash_table_foreach (repository->priv->lazy_typelibs, collect_namespaces, &list);
+  g_hash_table_foreach (namespaces->typelibs, collect_namespaces, &list);
+  g_hash_table_foreach (namespaces->lazy_typelibs, collect_namespaces, &list);
 
   names = g_malloc0 (sizeof (gchar *) * (g_list_length (list) + 1));
   i = 0;
   for (l = list; l; l = l->next)
     names[i++] = g_strdup (l->data);
   g_list_free (list);
+  namespaces_release (repository);
 
   return names;
 }
@@ -1141,18 +2090,22 @@ const gchar *
 g_irepository_get_typelib_path (GIRepository *repository,
 				const gchar  *namespace)
 {
+  GIRepositoryNamespaces *namespaces;
   gpointer orig_key, value;
+  gboolean found;
 
   repository = get_repository (repository);
+  namespaces = namespaces_acquire (repository);
 
-  if (!g_hash_table_lookup_extended (repository->priv->typelibs, namespace,
-				     &orig_key, &value))
-    {
-      if (!g_hash_table_lookup_extended (repository->priv->lazy_typelibs, namespace,
-					 &orig_key, &value))
+  /* The keys are owned by typelib_keys, not by the snapshot */
+  found = g_hash_table_lookup_extended (namespaces->typelibs, namespace,
+					&orig_key, &value) ||
+    g_hash_table_lookup_extended (namespaces->lazy_typelibs, namespace,
+				  &orig_key, &value);
+  namespaces_release (repository);
 
-	return NULL;
-    }
+  if (!found)
+    return NULL;
   return ((char*)orig_key) + strlen ((char *) orig_key) + 1;
 }
 
@@ -1239,7 +2192,6 @@ compare_version (const char *v1,
 
 struct NamespaceVersionCandidadate
 {
-  GMappedFile *mfile;
   int path_index;
   char *path;
   char *version;
@@ -1273,132 +2225,191 @@ compare_candidate_reverse (struct NamespaceVersionCandidadate *c1,
 static void
 free_candidate (struct NamespaceVersionCandidadate *candidate)
 {
-  g_mapped_file_unref (candidate->mfile);
   g_free (candidate->path);
   g_free (candidate->version);
   g_slice_free (struct NamespaceVersionCandidadate, candidate);
 }
 
+/* Lists the typelibs in @dirname once, indexing the versions found
+ * by namespace.  Must be called with register_lock held.
+ */
+static GHashTable *
+get_directory_index (GIRepository *repository,
+		     const char   *dirname)
+{
+  GHashTable *index;
+  GDir *dir;
+  const char *entry;
+
+  if (g_hash_table_lookup_extended (repository->priv->directories, dirname,
+				    NULL, (gpointer *) &index))
+    return index;
+
+  dir = g_dir_open (dirname, 0, NULL);
+  if (dir == NULL)
+    {
+      g_hash_table_insert (repository->priv->directories,
+			   g_strdup (dirname), NULL);
+      return NULL;
+    }
+
+  index = g_hash_table_new_full (g_str_hash, g_str_equal,
+				 (GDestroyNotify) g_free,
+				 (GDestroyNotify) g_ptr_array_unref);
+
+  while ((entry = g_dir_read_name (dir)) != NULL)
+    {
+      const char *last_dash;
+      const char *name_end;
+      char *namespace, *version;
+      GPtrArray *versions;
+      int major, minor;
+
+      if (!g_str_has_suffix (entry, ".typelib"))
+	continue;
+
+      name_end = strrchr (entry, '.');
+      last_dash = strrchr (entry, '-');
+      if (last_dash == NULL || last_dash == entry)
+	continue;
+
+      version = g_strndup (last_dash+1, name_end-(last_dash+1));
+      if (!parse_version (version, &major, &minor))
+	{
+	  g_free (version);
+	  continue;
+	}
+
+      namespace = g_strndup (entry, last_dash - entry);
+      versions = g_hash_table_lookup (index, namespace);
+      if (versions == NULL)
+	{
+	  versions = g_ptr_array_new_with_free_func (g_free);
+	  g_hash_table_insert (index, namespace, versions);
+	}
+      else
+	g_free (namespace);
+      g_ptr_array_add (versions, version);
+    }
+  g_dir_close (dir);
+
+  g_hash_table_insert (repository->priv->directories, g_strdup (dirname), index);
+
+  return index;
+}
+
+/* Must be called with register_lock held */
 static GSList *
-enumerate_namespace_versions (const gchar *namespace,
-			      GSList      *search_path)
+enumerate_namespace_versions (GIRepository *repository,
+			      const gchar  *namespace,
+			      GSList       *search_path)
 {
   GSList *candidates = NULL;
   GHashTable *found_versions = g_hash_table_new (g_str_hash, g_str_equal);
-  char *namespace_dash;
-  char *namespace_typelib;
   GSList *ldir;
-  GError *error = NULL;
   int index;
 
-  namespace_dash = g_strdup_printf ("%s-", namespace);
-  namespace_typelib = g_strdup_printf ("%s.typelib", namespace);
-
   index = 0;
   for (ldir = search_path; ldir; ldir = ldir->next)
     {
-      GDir *dir;
       const char *dirname;
-      const char *entry;
+      GHashTable *dir_index;
+      GPtrArray *versions;
+      guint i;
 
       dirname = (const char*)ldir->data;
-      dir = g_dir_open (dirname, 0, NULL);
-      if (dir == NULL)
+      dir_index = get_directory_index (repository, dirname);
+      if (dir_index == NULL)
 	continue;
-      while ((entry = g_dir_read_name (dir)) != NULL)
+
+      versions = g_hash_table_lookup (dir_index, namespace);
+      for (i = 0; versions != NULL && i < versions->len; i++)
 	{
-	  GMappedFile *mfile;
-	  char *path, *version;
+	  const char *version = g_ptr_array_index (versions, i);
 	  struct NamespaceVersionCandidadate *candidate;
-
-	  if (!g_str_has_suffix (entry, ".typelib"))
-	    continue;
-
-	  if (g_str_has_prefix (entry, namespace_dash))
-	    {
-	      const char *last_dash;
-	      const char *name_end;
-	      int major, minor;
-
-	      name_end = strrchr (entry, '.');
-	      last_dash = strrchr (entry, '-');
-	      version = g_strndup (last_dash+1, name_end-(last_dash+1));
-	      if (!parse_version (version, &major, &minor))
-		{
-		  g_free (version);
-		  continue;
-		}
-	    }
-	  else
-	    continue;
+	  char *fname;
 
 	  if (g_hash_table_lookup (found_versions, version) != NULL)
-	    {
-	      g_free (version);
-	      continue;
-	    }
-	  g_hash_table_insert (found_versions, version, version);
+	    continue;
+	  g_hash_table_insert (found_versions, (gpointer) version, (gpointer) version);
 
-	  path = g_build_filename (dirname, entry, NULL);
-	  mfile = g_mapped_file_new (path, FALSE, &error);
-	  if (mfile == NULL)
-	    {
-	      g_free (path);
-	      g_free (version);
-	      g_clear_error (&error);
-	      continue;
-	    }
+	  fname = g_strdup_printf ("%s-%s.typelib", namespace, version);
 	  candidate = g_slice_new0 (struct NamespaceVersionCandidadate);
-	  candidate->mfile = mfile;
 	  candidate->path_index = index;
-	  candidate->path = path;
-	  candidate->version = version;
+	  candidate->path = g_build_filename (dirname, fname, NULL);
+	  candidate->version = g_strdup (version);
 	  candidates = g_slist_prepend (candidates, candidate);
+	  g_free (fname);
 	}
-      g_dir_close (dir);
       index++;
     }
 
-  g_free (namespace_dash);
-  g_free (namespace_typelib);
   g_hash_table_destroy (found_versions);
 
   return candidates;
 }
 
+/* Must be called with register_lock held */
 static GMappedFile *
-find_namespace_latest (const gchar  *namespace,
+find_namespace_latest (GIRepository *repository,
+		       const gchar  *namespace,
 		       GSList       *search_path,
 		       gchar       **version_ret,
 		       gchar       **path_ret)
 {
-  GSList *candidates;
+  GSList *candidates, *link;
   GMappedFile *result = NULL;
 
   *version_ret = NULL;
   *path_ret = NULL;
 
-  candidates = enumerate_namespace_versions (namespace, search_path);
+  candidates = enumerate_namespace_versions (repository, namespace, search_path);
+  candidates = g_slist_sort (candidates, (GCompareFunc) compare_candidate_reverse);
 
-  if (candidates != NULL)
+  /* Only map the best candidate which can actually be opened */
+  for (link = candidates; link; link = link->next)
     {
-      struct NamespaceVersionCandidadate *elected;
-      candidates = g_slist_sort (candidates, (GCompareFunc) compare_candidate_reverse);
-
-      elected = (struct NamespaceVersionCandidadate *) candidates->data;
-      /* Remove the elected one so we don't try to free its contents */
-      candidates = g_slist_delete_link (candidates, candidates);
-
-      result = elected->mfile;
-      *path_ret = elected->path;
-      *version_ret = elected->version;
-      g_slice_free (struct NamespaceVersionCandidadate, elected); /* just free the container */
-      g_slist_foreach (candidates, (GFunc) free_candidate, NULL);
-      g_slist_free (candidates);
+      struct NamespaceVersionCandidadate *candidate = link->data;
+
+      result = g_mapped_file_new (candidate->path, FALSE, NULL);
+      if (result != NULL)
+	{
+	  *path_ret = candidate->path;
+	  *version_ret = candidate->version;
+	  candidate->path = NULL;
+	  candidate->version = NULL;
+	  break;
+	}
     }
+
+  g_slist_free_full (candidates, (GDestroyNotify) free_candidate);
+
   return result;
 }
 
+/**
+ * g_irepository_clear_search_path_cache:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ *
+ * The contents of each directory in the typelib search path are listed
+ * only once, the first time a namespace is required without an explicit
+ * version or its versions are enumerated. Call this function when
+ * typelibs were added to or removed from these directories, so that they
+ * are listed again.
+ *
+ * Since: 1.46
+ */
+void
+g_irepository_clear_search_path_cache (GIRepository *repository)
+{
+  repository = get_repository (repository);
+
+  g_rec_mutex_lock (&repository->priv->register_lock);
+  g_hash_table_remove_all (repository->priv->directories);
+  g_rec_mutex_unlock (&repository->priv->register_lock);
+}
+
 /**
  * g_irepository_enumerate_versions:
  * @repository: (allow-none): A #GIRepository or %NULL for the singleton
@@ -1419,8 +2430,12 @@ g_irepository_enumerate_versions (GIRepository *repository,
   GSList *candidates, *link;
   const gchar *loaded_version;
 
+  repository = get_repository (repository);
+
   search_path = build_search_path_with_overrides ();
-  candidates = enumerate_namespace_versions (namespace_, search_path);
+  g_rec_mutex_lock (&repository->priv->register_lock);
+  candidates = enumerate_namespace_versions (repository, namespace_, search_path);
+  g_rec_mutex_unlock (&repository->priv->register_lock);
   g_slist_free (search_path);
 
   for (link = candidates; link; link = link->next)
@@ -1445,15 +2460,129 @@ g_irepository_enumerate_versions (GIRepository *repository,
   return ret;
 }
 
+/* Returns the name and version of a bundle entry, which have already
+ * been checked by g_irepository_load_bundle().
+ */
+static void
+bundle_entry_get_name (const guint8      *data,
+		       const BundleEntry *entry,
+		       const char       **name,
+		       const char       **version)
+{
+  *name = (const char *) data + entry->name;
+  *version = strrchr (*name, '-') + 1;
+}
+
+typedef struct {
+  const guint8 *data;
+  const char *namespace;
+  gsize namespace_len;
+  const char *version; /* NULL to match any version */
+} BundleKey;
+
+/* Orders like the strcmp() of the "namespace-version" names the
+ * entries are sorted by; all versions of a namespace are adjacent.
+ */
+static int
+compare_bundle_key (const void *key_ptr,
+		    const void *entry_ptr)
+{
+  const BundleKey *key = key_ptr;
+  const char *name, *version;
+  int cmp;
+
+  bundle_entry_get_name (key->data, entry_ptr, &name, &version);
+
+  cmp = strncmp (key->namespace, name, key->namespace_len);
+  if (cmp != 0)
+    return cmp;
+  if (name[key->namespace_len] != '-')
+    return '-' - (guchar) name[key->namespace_len];
+  if (key->version == NULL)
+    return 0;
+  return strcmp (key->version, version);
+}
+
+/* Must be called with register_lock held */
+static gboolean
+find_in_bundles (GIRepository  *repository,
+		 const gchar   *namespace,
+		 const gchar   *version,
+		 const guint8 **data_ret,
+		 gsize         *len_ret,
+		 gchar        **version_ret,
+		 gchar        **path_ret)
+{
+  BundleKey key;
+  GSList *l;
+
+  key.namespace = namespace;
+  key.namespace_len = strlen (namespace);
+  key.version = version;
+
+  for (l = repository->priv->bundles; l; l = l->next)
+    {
+      TypelibBundle *bundle = l->data;
+      const guint8 *data = (const guint8 *) g_mapped_file_get_contents (bundle->mfile);
+      const BundleHeader *header = (const BundleHeader *) data;
+      const BundleEntry *entries = (const BundleEntry *) (data + header->entries);
+      const BundleEntry *found, *best, *entry;
+      const char *name, *best_version, *entry_version;
+
+      key.data = data;
+      found = bsearch (&key, entries, header->n_entries, sizeof (BundleEntry),
+		       compare_bundle_key);
+      if (found == NULL)
+	continue;
+
+      best = found;
+      bundle_entry_get_name (data, best, &name, &best_version);
+
+      /* Without a version, pick the latest of the adjacent matches */
+      if (version == NULL)
+	{
+	  const BundleEntry *first = found, *last = found;
+
+	  while (first > entries && compare_bundle_key (&key, first - 1) == 0)
+	    first--;
+	  while (last + 1 < entries + header->n_entries &&
+		 compare_bundle_key (&key, last + 1) == 0)
+	    last++;
+
+	  for (entry = first; entry <= last; entry++)
+	    {
+	      bundle_entry_get_name (data, entry, &name, &entry_version);
+	      if (compare_version (entry_version, best_version) > 0)
+		{
+		  best = entry;
+		  best_version = entry_version;
+		}
+	    }
+	}
+
+      *data_ret = data + best->offset;
+      *len_ret = best->size;
+      *version_ret = g_strdup (best_version);
+      *path_ret = g_strdup (bundle->path);
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* Must be called with register_lock held */
 static GITypelib *
-require_internal (GIRepository  *repository,
-		  const gchar   *namespace,
-		  const gchar   *version,
-		  GIRepositoryLoadFlags flags,
-		  GSList        *search_path,
-		  GError       **error)
+require_internal_locked (GIRepository  *repository,
+			 const gchar   *namespace,
+			 const gchar   *version,
+			 GIRepositoryLoadFlags flags,
+			 GSList        *search_path,
+			 gboolean       search_bundles,
+			 GError       **error)
 {
-  GMappedFile *mfile;
+  GMappedFile *mfile = NULL;
+  const guint8 *bundled = NULL;
+  gsize bundled_len = 0;
   GITypelib *ret = NULL;
   Header *header;
   GITypelib *typelib = NULL;
@@ -1464,10 +2593,6 @@ require_internal (GIRepository  *repository,
   char *path = NULL;
   char *tmp_version = NULL;
 
-  g_return_val_if_fail (namespace != NULL, FALSE);
-
-  repository = get_repository (repository);
-
   typelib = get_registered_status (repository, namespace, version, allow_lazy,
                                    &is_lazy, &version_conflict);
   if (typelib)
@@ -1482,7 +2607,13 @@ require_internal (GIRepository  *repository,
       return NULL;
     }
 
-  if (version != NULL)
+  /* Typelibs from loaded bundles take precedence over the search path,
+   * but not over a directory given by the caller */
+  if (search_bundles &&
+      find_in_bundles (repository, namespace, version,
+		       &bundled, &bundled_len, &tmp_version, &path))
+    ;
+  else if (version != NULL)
     {
       mfile = find_namespace_version (namespace, version,
 				      search_path, &path);
@@ -1490,11 +2621,11 @@ require_internal (GIRepository  *repository,
     }
   else
     {
-      mfile = find_namespace_latest (namespace, search_path,
+      mfile = find_namespace_latest (repository, namespace, search_path,
 				     &tmp_version, &path);
     }
 
-  if (mfile == NULL)
+  if (bundled == NULL && mfile == NULL)
     {
       if (version != NULL)
 	g_set_error (error, G_IREPOSITORY_ERROR,
@@ -1511,7 +2642,10 @@ require_internal (GIRepository  *repository,
 
   {
     GError *temp_error = NULL;
-    typelib = g_typelib_new_from_mapped_file (mfile, &temp_error);
+    if (bundled != NULL)
+      typelib = g_typelib_new_from_const_memory (bundled, bundled_len, &temp_error);
+    else
+      typelib = g_typelib_new_from_mapped_file (mfile, &temp_error);
     if (!typelib)
       {
 	g_set_error (error, G_IREPOSITORY_ERROR,
@@ -1560,6 +2694,38 @@ require_internal (GIRepository  *repository,
   return ret;
 }
 
+static GITypelib *
+require_internal (GIRepository  *repository,
+		  const gchar   *namespace,
+		  const gchar   *version,
+		  GIRepositoryLoadFlags flags,
+		  GSList        *search_path,
+		  gboolean       search_bundles,
+		  GError       **error)
+{
+  GITypelib *typelib;
+  gboolean allow_lazy = (flags & G_IREPOSITORY_LOAD_FLAG_LAZY) > 0;
+
+  g_return_val_if_fail (namespace != NULL, FALSE);
+
+  repository = get_repository (repository);
+
+  /* Already loaded namespaces need no locking; anything else, including
+   * reporting a version conflict, is rechecked under the lock.
+   */
+  typelib = get_registered_status (repository, namespace, version, allow_lazy,
+                                   NULL, NULL);
+  if (typelib)
+    return typelib;
+
+  g_rec_mutex_lock (&repository->priv->register_lock);
+  typelib = require_internal_locked (repository, namespace, version, flags,
+                                     search_path, search_bundles, error);
+  g_rec_mutex_unlock (&repository->priv->register_lock);
+
+  return typelib;
+}
+
 /**
  * g_irepository_require:
  * @repository: (allow-none): A #GIRepository or %NULL for the singleton
@@ -1589,12 +2755,300 @@ g_irepository_require (GIRepository  *repository,
 
   search_path = build_search_path_with_overrides ();
   typelib = require_internal (repository, namespace, version, flags,
-			      search_path, error);
+			      search_path, TRUE, error);
   g_slist_free (search_path);
 
   return typelib;
 }
 
+/* Checks a typelib of a bundle like the loaders do, and that its
+ * dependencies are part of the bundle */
+static gboolean
+validate_bundle_typelib (const guint8      *data,
+			 const BundleEntry *entry,
+			 GError           **error)
+{
+  const BundleHeader *header = (const BundleHeader *) data;
+  const BundleEntry *entries = (const BundleEntry *) (data + header->entries);
+  GITypelib *typelib;
+  Header *typelib_header;
+  const char *name, *version, *namespace;
+  char **dependencies;
+  gboolean ret = TRUE;
+  guint i;
+
+  bundle_entry_get_name (data, entry, &name, &version);
+
+  typelib = g_typelib_new_from_const_memory (data + entry->offset, entry->size, error);
+  if (typelib == NULL)
+    {
+      g_prefix_error (error, "%s: ", name);
+      return FALSE;
+    }
+
+  typelib_header = (Header *) typelib->data;
+  namespace = g_typelib_get_string (typelib, typelib_header->namespace);
+  if (strlen (namespace) != (gsize) (version - name - 1) ||
+      strncmp (namespace, name, version - name - 1) != 0 ||
+      strcmp (g_typelib_get_string (typelib, typelib_header->nsversion), version) != 0)
+    {
+      g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID,
+		   "%s: Typelib for namespace '%s' version '%s'", name,
+		   namespace, g_typelib_get_string (typelib, typelib_header->nsversion));
+      g_typelib_free (typelib);
+      return FALSE;
+    }
+
+  dependencies = get_typelib_dependencies (typelib);
+  for (i = 0; ret && dependencies != NULL && dependencies[i]; i++)
+    {
+      const char *last_dash = strrchr (dependencies[i], '-');
+      BundleKey key;
+
+      if (last_dash != NULL)
+	{
+	  key.data = data;
+	  key.namespace = dependencies[i];
+	  key.namespace_len = last_dash - dependencies[i];
+	  key.version = last_dash + 1;
+	}
+
+      if (last_dash == NULL ||
+	  bsearch (&key, entries, header->n_entries, sizeof (BundleEntry),
+		   compare_bundle_key) == NULL)
+	{
+	  g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID,
+		       "%s: Dependency %s is not part of the bundle",
+		       name, dependencies[i]);
+	  ret = FALSE;
+	}
+    }
+
+  g_strfreev (dependencies);
+  g_typelib_free (typelib);
+
+  return ret;
+}
+
+static gboolean
+validate_bundle (const guint8 *data,
+		 gsize         len,
+		 GError      **error)
+{
+  const BundleHeader *header = (const BundleHeader *) data;
+  const BundleEntry *entries;
+  int major, minor;
+  guint i;
+
+  if (len < sizeof (BundleHeader) ||
+      memcmp (header->magic, G_IR_BUNDLE_MAGIC, sizeof (header->magic)) != 0)
+    {
+      g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID_HEADER,
+		   "Invalid magic header");
+      return FALSE;
+    }
+
+  if (header->size != len ||
+      header->entries % 4 != 0 ||
+      header->entries > len ||
+      header->n_entries > (len - header->entries) / sizeof (BundleEntry))
+    {
+      g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID_HEADER,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  entries = (const BundleEntry *) (data + header->entries);
+  for (i = 0; i < header->n_entries; i++)
+    {
+      const char *name, *dash;
+
+      if (entries[i].name >= len ||
+	  memchr (data + entries[i].name, '\0', len - entries[i].name) == NULL)
+	{
+	  g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID,
+		       "The buffer is too short");
+	  return FALSE;
+	}
+
+      name = (const char *) data + entries[i].name;
+      dash = strrchr (name, '-');
+      if (dash == NULL || dash == name ||
+	  !parse_version (dash + 1, &major, &minor))
+	{
+	  g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID,
+		       "Invalid entry name '%s'", name);
+	  return FALSE;
+	}
+
+      if (entries[i].offset % 8 != 0 ||
+	  entries[i].offset > len ||
+	  entries[i].size > len - entries[i].offset)
+	{
+	  g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID,
+		       "Misplaced typelib for %s", name);
+	  return FALSE;
+	}
+
+      /* Lookups binary search the table */
+      if (i > 0 && strcmp ((const char *) data + entries[i - 1].name, name) >= 0)
+	{
+	  g_set_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID,
+		       "Entries not sorted");
+	  return FALSE;
+	}
+    }
+
+  /* All the names are valid now */
+  for (i = 0; i < header->n_entries; i++)
+    {
+      if (!validate_bundle_typelib (data, &entries[i], error))
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Must be called with register_lock held */
+static gboolean
+check_bundle_conflicts (GIRepository *repository,
+			const guint8 *data,
+			GError      **error)
+{
+  const BundleHeader *header = (const BundleHeader *) data;
+  const BundleEntry *entries = (const BundleEntry *) (data + header->entries);
+  const char *name, *version, *prev_name, *prev_version;
+  char *version_conflict = NULL;
+  char *namespace;
+  guint i;
+
+  for (i = 0; i < header->n_entries; i++)
+    {
+      bundle_entry_get_name (data, &entries[i], &name, &version);
+      namespace = g_strndup (name, version - name - 1);
+
+      /* Versions of a namespace are adjacent */
+      if (i > 0)
+	{
+	  bundle_entry_get_name (data, &entries[i - 1], &prev_name, &prev_version);
+	  if (version - name == prev_version - prev_name &&
+	      strncmp (name, prev_name, version - name) == 0)
+	    version_conflict = g_strdup (prev_version);
+	}
+
+      if (version_conflict == NULL)
+	get_registered_status (repository, namespace, version, TRUE,
+			       NULL, &version_conflict);
+
+      if (version_conflict != NULL)
+	{
+	  g_set_error (error, G_IREPOSITORY_ERROR,
+		       G_IREPOSITORY_ERROR_NAMESPACE_VERSION_CONFLICT,
+		       "Requiring namespace '%s' version '%s', but '%s' is already loaded",
+		       namespace, version, version_conflict);
+	  g_free (version_conflict);
+	  g_free (namespace);
+	  return FALSE;
+	}
+
+      g_free (namespace);
+    }
+
+  return TRUE;
+}
+
+/**
+ * g_irepository_load_bundle:
+ * @repository: (allow-none): A #GIRepository or %NULL for the singleton
+ *   process-global default #GIRepository
+ * @path: (type filename): path of a typelib bundle
+ * @flags: Set of %GIRepositoryLoadFlags, may be 0
+ * @error: a #GError.
+ *
+ * Maps a bundle of typelibs created with <command>g-ir-compiler
+ * --bundle</command> and registers every namespace it contains.  A bundle
+ * holds a closed set of typelibs, so their dependencies are satisfied
+ * from the same mapping rather than from separate files.
+ *
+ * The bundle stays loaded for the lifetime of @repository, and later
+ * calls to g_irepository_require() prefer the typelibs it contains over
+ * those found on the search path.
+ *
+ * Returns: %TRUE if all namespaces of the bundle were registered
+ *
+ * Since: 1.46
+ */
+gboolean
+g_irepository_load_bundle (GIRepository          *repository,
+			   const gchar           *path,
+			   GIRepositoryLoadFlags  flags,
+			   GError               **error)
+{
+  GMappedFile *mfile;
+  TypelibBundle *bundle;
+  const guint8 *data;
+  const BundleHeader *header;
+  const BundleEntry *entries;
+  GSList *search_path;
+  gboolean ret = TRUE;
+  guint i;
+
+  g_return_val_if_fail (path != NULL, FALSE);
+
+  repository = get_repository (repository);
+
+  mfile = g_mapped_file_new (path, FALSE, error);
+  if (mfile == NULL)
+    return FALSE;
+
+  data = (const guint8 *) g_mapped_file_get_contents (mfile);
+  if (!validate_bundle (data, g_mapped_file_get_length (mfile), error))
+    {
+      g_prefix_error (error, "%s: ", path);
+      g_mapped_file_unref (mfile);
+      return FALSE;
+    }
+
+  header = (const BundleHeader *) data;
+  entries = (const BundleEntry *) (data + header->entries);
+
+  g_rec_mutex_lock (&repository->priv->register_lock);
+
+  /* Nothing is registered unless all of the bundle can be */
+  if (!check_bundle_conflicts (repository, data, error))
+    {
+      g_rec_mutex_unlock (&repository->priv->register_lock);
+      g_prefix_error (error, "%s: ", path);
+      g_mapped_file_unref (mfile);
+      return FALSE;
+    }
+
+  bundle = g_slice_new (TypelibBundle);
+  bundle->mfile = mfile;
+  bundle->path = g_strdup (path);
+  repository->priv->bundles = g_slist_prepend (repository->priv->bundles, bundle);
+
+  search_path = build_search_path_with_overrides ();
+
+  for (i = 0; i < header->n_entries && ret; i++)
+    {
+      const char *name, *version;
+      char *namespace;
+
+      bundle_entry_get_name (data, &entries[i], &name, &version);
+      namespace = g_strndup (name, version - name - 1);
+      ret = require_internal_locked (repository, namespace, version, flags,
+				     search_path, TRUE, error) != NULL;
+      g_free (namespace);
+    }
+
+  g_rec_mutex_unlock (&repository->priv->register_lock);
+
+  g_slist_free (search_path);
+
+  return ret;
+}
+
 /**
  * g_irepository_require_private:
  * @repository: (allow-none): A #GIRepository or %NULL for the singleton
@@ -1624,7 +3078,7 @@ g_irepository_require_private (GIRepository  *repository,
   GSList search_path = { (gpointer) typelib_dir, NULL };
 
   return require_internal (repository, namespace, version, flags,
-			   &search_path, error);
+			   &search_path, FALSE, error);
 }
 
 static gboolean
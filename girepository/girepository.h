@@ -108,6 +108,9 @@ void          g_irepository_prepend_library_path (const char *directory);
 GI_AVAILABLE_IN_ALL
 GSList *      g_irepository_get_search_path     (void);
 
+GI_AVAILABLE_IN_1_46
+void          g_irepository_clear_search_path_cache (GIRepository *repository);
+
 GI_AVAILABLE_IN_ALL
 const char *  g_irepository_load_typelib  (GIRepository *repository,
 					   GITypelib     *typelib,
@@ -143,6 +146,12 @@ GITypelib *    g_irepository_require_private (GIRepository  *repository,
 					     GIRepositoryLoadFlags flags,
 					     GError       **error);
 
+GI_AVAILABLE_IN_1_46
+gboolean      g_irepository_load_bundle (GIRepository          *repository,
+					 const gchar           *path,
+					 GIRepositoryLoadFlags  flags,
+					 GError               **error);
+
 GI_AVAILABLE_IN_1_44
 gchar      ** g_irepository_get_immediate_dependencies (GIRepository *repository,
                                                         const gchar  *namespace_);
@@ -158,10 +167,38 @@ GI_AVAILABLE_IN_ALL
 GIBaseInfo *  g_irepository_find_by_gtype (GIRepository *repository,
 					   GType         gtype);
 
+GI_AVAILABLE_IN_1_46
+void          g_irepository_get_gtype_cache_stats (GIRepository *repository,
+						   guint        *hits,
+						   guint        *negative_hits,
+						   guint        *misses);
+
+GI_AVAILABLE_IN_1_46
+void          g_irepository_set_info_cache_size (GIRepository *repository,
+						 guint         max_infos);
+
+GI_AVAILABLE_IN_1_46
+void          g_irepository_get_info_cache_stats (GIRepository *repository,
+						  guint        *allocations,
+						  guint        *hits,
+						  guint        *evictions);
+
 GI_AVAILABLE_IN_ALL
 gint          g_irepository_get_n_infos   (GIRepository *repository,
 					   const gchar  *namespace_);
 
+GI_AVAILABLE_IN_1_46
+guint         g_irepository_resolve_gtypes (GIRepository *repository,
+					    const gchar  *namespace_);
+
+GI_AVAILABLE_IN_1_46
+GThread *     g_irepository_resolve_gtypes_in_thread (GIRepository *repository,
+						      const gchar  *namespace_);
+
+GI_AVAILABLE_IN_1_46
+guint         g_irepository_resolve_symbols (GIRepository *repository,
+					     const gchar  *namespace_);
+
 GI_AVAILABLE_IN_ALL
 GIBaseInfo *  g_irepository_get_info      (GIRepository *repository,
 					   const gchar  *namespace_,
@@ -236,6 +273,9 @@ void gi_cclosure_marshal_generic (GClosure       *closure,
                                   gpointer        invocation_hint,
                                   gpointer        marshal_data);
 
+GI_AVAILABLE_IN_1_46
+void gi_cclosure_pin_marshal_generic (GClosure       *closure);
+
 G_END_DECLS
 
 
@@ -278,8 +278,7 @@ g_function_info_prep_invoker (GIFunctionInfo       *info,
 
   symbol = g_function_info_get_symbol ((GIFunctionInfo*) info);
 
-  if (!g_typelib_symbol (g_base_info_get_typelib((GIBaseInfo *) info),
-                         symbol, &addr))
+  if (!_g_function_info_get_address (info, &addr))
     {
       g_set_error (error,
                    G_INVOKE_ERROR,
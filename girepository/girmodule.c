@@ -30,7 +30,10 @@
 #define ALIGN_VALUE(this, boundary) \
   (( ((unsigned long)(this)) + (((unsigned long)(boundary)) -1)) & (~(((unsigned long)(boundary))-1)))
 
-#define NUM_SECTIONS 2
+#define NUM_SECTIONS 6
+
+/* Containers with fewer members than this are not worth indexing */
+#define MEMBER_INDEX_MIN_MEMBERS 8
 
 GIrModule *
 _g_ir_module_new (const gchar *name,
@@ -51,8 +54,13 @@ _g_ir_module_new (const gchar *name,
   module->c_prefix = g_strdup (c_prefix);
   module->dependencies = NULL;
   module->entries = NULL;
+  module->last_entry = NULL;
+  module->entry_nodes = g_ptr_array_new ();
+  module->entry_index = g_hash_table_new (g_str_hash, g_str_equal);
+  module->xref_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
   module->include_modules = NULL;
+  module->include_index = g_hash_table_new (g_str_hash, g_str_equal);
   module->aliases = NULL;
 
   return module;
@@ -65,6 +73,12 @@ _g_ir_module_free (GIrModule *module)
 
   g_free (module->name);
 
+  /* The indexes are keyed by the node names */
+  g_hash_table_destroy (module->entry_index);
+  g_hash_table_destroy (module->xref_index);
+  g_hash_table_destroy (module->include_index);
+  g_ptr_array_free (module->entry_nodes, TRUE);
+
   for (e = module->entries; e; e = e->next)
     _g_ir_node_free ((GIrNode *)e->data);
 
@@ -151,6 +165,17 @@ add_disguised_structure_foreach (gpointer key,
   g_hash_table_replace (module->disguised_structures, g_strdup (key), value);
 }
 
+static void
+add_include_index_foreach (gpointer key,
+			   gpointer value,
+			   gpointer data)
+{
+  GIrModule *module = data;
+
+  if (!g_hash_table_lookup (module->include_index, key))
+    g_hash_table_insert (module->include_index, key, value);
+}
+
 void
 _g_ir_module_add_include_module (GIrModule  *module,
 				 GIrModule  *include_module)
@@ -158,6 +183,14 @@ _g_ir_module_add_include_module (GIrModule  *module,
   module->include_modules = g_list_prepend (module->include_modules,
 					    include_module);
 
+  /* A namespace is only ever parsed once per compilation, so all
+   * the modules found under a given name are the same. */
+  g_hash_table_replace (module->include_index, include_module->name,
+			include_module);
+  g_hash_table_foreach (include_module->include_index,
+			add_include_index_foreach,
+			module);
+
   g_hash_table_foreach (include_module->aliases,
 			add_alias_foreach,
 			module);
@@ -167,6 +200,102 @@ _g_ir_module_add_include_module (GIrModule  *module,
 			module);
 }
 
+/**
+ * _g_ir_module_add_entry:
+ * @module: a #GIrModule
+ * @node: (transfer full): the node to append, with its name set
+ *
+ * Appends @node to the entries of @module, and indexes it by name.
+ * Entries must not be added to the list in any other way.
+ */
+void
+_g_ir_module_add_entry (GIrModule *module,
+			GIrNode   *node)
+{
+  guint index;
+
+  if (module->last_entry == NULL)
+    {
+      module->entries = g_list_append (NULL, node);
+      module->last_entry = module->entries;
+    }
+  else
+    {
+      g_list_append (module->last_entry, node);
+      module->last_entry = module->last_entry->next;
+    }
+
+  g_ptr_array_add (module->entry_nodes, node);
+  index = module->entry_nodes->len;
+
+  /* Like the former linear searches, the first entry wins */
+  if (!g_hash_table_lookup (module->entry_index, node->name))
+    g_hash_table_insert (module->entry_index, node->name,
+			 GUINT_TO_POINTER (index));
+
+  if (node->type == G_IR_NODE_XREF)
+    {
+      char *key = g_strdup_printf ("%s.%s", ((GIrNodeXRef *)node)->namespace,
+				   node->name);
+
+      if (!g_hash_table_lookup (module->xref_index, key))
+	g_hash_table_insert (module->xref_index, key, GUINT_TO_POINTER (index));
+      else
+	g_free (key);
+    }
+}
+
+/**
+ * _g_ir_module_find_entry:
+ * @module: a #GIrModule
+ * @name: an entry name, or a "Namespace.name" cross reference
+ * @idx: (out) (allow-none): return location for the 1-based index of
+ *   the entry
+ *
+ * Looks up the first entry of @module called @name.  Qualified names
+ * only match cross references to other namespaces.
+ *
+ * Returns: (transfer none): the entry, or %NULL
+ */
+GIrNode *
+_g_ir_module_find_entry (GIrModule  *module,
+			 const char *name,
+			 guint16    *idx)
+{
+  guint index;
+
+  if (strchr (name, '.') != NULL)
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (module->xref_index, name));
+  else
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (module->entry_index, name));
+
+  if (index == 0)
+    return NULL;
+
+  if (idx)
+    *idx = index;
+
+  return g_ptr_array_index (module->entry_nodes, index - 1);
+}
+
+/**
+ * _g_ir_module_find_namespace:
+ * @module: a #GIrModule
+ * @name: a namespace name
+ *
+ * Returns: (transfer none): @module if it is called @name, or the
+ *   module it includes directly or indirectly with that name, or %NULL
+ */
+GIrModule *
+_g_ir_module_find_namespace (GIrModule  *module,
+			     const char *name)
+{
+  if (strcmp (module->name, name) == 0)
+    return module;
+
+  return g_hash_table_lookup (module->include_index, name);
+}
+
 struct AttributeWriteData
 {
   guint count;
@@ -293,6 +422,547 @@ add_directory_index_section (guint8 *data, GIrModule *module, guint32 *offset2)
   return data;
 }
 
+static guint8*
+add_gtype_index_section (guint8 *data, GIrModule *module, guint32 *offset2)
+{
+  DirEntry *entry;
+  Header *header = (Header*)data;
+  GITypelibHashBuilder *gtindex_builder;
+  GHashTable *seen;
+  guint i, n_interfaces;
+  guint32 n_gtypes;
+  guint32 required_size;
+  guint32 new_offset;
+
+  gtindex_builder = _gi_typelib_hash_builder_new ();
+  seen = g_hash_table_new (g_str_hash, g_str_equal);
+
+  n_interfaces = header->n_local_entries;
+
+  for (i = 0; i < n_interfaces; i++)
+    {
+      RegisteredTypeBlob *blob;
+      const char *str;
+
+      entry = (DirEntry *)&data[header->directory + (i * header->entry_blob_size)];
+      if (!BLOB_IS_REGISTERED_TYPE (entry))
+	continue;
+
+      blob = (RegisteredTypeBlob *)&data[entry->offset];
+      if (!blob->gtype_name)
+	continue;
+
+      /* Like the linear lookup, the first entry with a given GType
+       * name wins. */
+      str = (const char *) (&data[blob->gtype_name]);
+      if (g_hash_table_lookup (seen, str))
+	continue;
+      g_hash_table_insert (seen, (char *) str, (char *) str);
+
+      _gi_typelib_hash_builder_add_string (gtindex_builder, str, i);
+    }
+
+  n_gtypes = g_hash_table_size (seen);
+  g_hash_table_destroy (seen);
+
+  if (n_gtypes > 0 && !_gi_typelib_hash_builder_prepare (gtindex_builder))
+    {
+      /* As for the directory index, just leave the section out. */
+      _gi_typelib_hash_builder_destroy (gtindex_builder);
+      return data;
+    }
+
+  /* An empty section is still written for typelibs without any
+   * registered type, so that lookups in them are immediate too.
+   */
+  alloc_section (data, GI_SECTION_GTYPE_INDEX, *offset2);
+
+  required_size = 0;
+  if (n_gtypes > 0)
+    {
+      required_size = _gi_typelib_hash_builder_get_buffer_size (gtindex_builder);
+      required_size = ALIGN_VALUE (required_size, 4);
+    }
+
+  new_offset = *offset2 + sizeof (guint32) + required_size;
+
+  data = g_realloc (data, new_offset);
+
+  /* The number of hashed names comes first, as the hash may return
+   * out of range slots for names it wasn't built with. */
+  *((guint32 *) &data[*offset2]) = n_gtypes;
+  if (n_gtypes > 0)
+    _gi_typelib_hash_builder_pack (gtindex_builder,
+				   ((guint8*)data) + *offset2 + sizeof (guint32),
+				   required_size);
+
+  *offset2 = new_offset;
+
+  _gi_typelib_hash_builder_destroy (gtindex_builder);
+  return data;
+}
+
+typedef struct {
+  guint entry;
+  MemberIndexKind kind;
+  guint32 n_names;
+  GITypelibHashBuilder *builder;
+} MemberHash;
+
+static GITypelibHashBuilder *
+build_member_hash (guint8  *data,
+		   guint32  offset,
+		   guint    n_members,
+		   guint16  member_size,
+		   guint32  name_offset,
+		   guint32 *n_names)
+{
+  GITypelibHashBuilder *builder;
+  GHashTable *seen;
+  guint i;
+
+  builder = _gi_typelib_hash_builder_new ();
+  seen = g_hash_table_new (g_str_hash, g_str_equal);
+
+  for (i = 0; i < n_members; i++)
+    {
+      guint32 name = *((guint32 *) &data[offset + name_offset]);
+      const char *str = (const char *) &data[name];
+
+      /* The linear lookups return the first match */
+      if (!g_hash_table_lookup (seen, str))
+	{
+	  g_hash_table_insert (seen, (char *) str, (char *) str);
+	  _gi_typelib_hash_builder_add_string (builder, str, i);
+	}
+
+      offset += member_size;
+    }
+
+  *n_names = g_hash_table_size (seen);
+  g_hash_table_destroy (seen);
+
+  if (!_gi_typelib_hash_builder_prepare (builder))
+    {
+      _gi_typelib_hash_builder_destroy (builder);
+      return NULL;
+    }
+
+  return builder;
+}
+
+static void
+add_member_hash (GArray   *hashes,
+		 guint8   *data,
+		 guint     entry,
+		 MemberIndexKind kind,
+		 guint32   offset,
+		 guint     n_members,
+		 guint16   member_size,
+		 guint32   name_offset)
+{
+  MemberHash hash;
+
+  if (n_members < MEMBER_INDEX_MIN_MEMBERS)
+    return;
+
+  hash.entry = entry;
+  hash.kind = kind;
+  hash.builder = build_member_hash (data, offset, n_members, member_size,
+				    name_offset, &hash.n_names);
+  if (hash.builder != NULL)
+    g_array_append_val (hashes, hash);
+}
+
+static guint32
+skip_fields (guint8 *data, guint32 offset, guint n_fields)
+{
+  Header *header = (Header*)data;
+  guint i;
+
+  for (i = 0; i < n_fields; i++)
+    {
+      FieldBlob *field_blob = (FieldBlob *)&data[offset];
+
+      offset += header->field_blob_size;
+      if (field_blob->has_embedded_type)
+	offset += header->callback_blob_size;
+    }
+
+  return offset;
+}
+
+static guint8*
+add_member_index_section (guint8 *data, GIrModule *module, guint32 *offset2)
+{
+  Header *header = (Header*)data;
+  GArray *entries;
+  GArray *hashes;
+  guint i, n_interfaces;
+  guint32 required_size;
+  guint32 new_offset;
+  guint32 hash_offset;
+  guint16 function_size, signal_size, vfunc_size;
+  guint32 function_name, signal_name, vfunc_name;
+
+  entries = g_array_new (FALSE, TRUE, sizeof (MemberIndexEntry));
+  hashes = g_array_new (FALSE, FALSE, sizeof (MemberHash));
+
+  function_size = header->function_blob_size;
+  signal_size = header->signal_blob_size;
+  vfunc_size = header->vfunc_blob_size;
+  function_name = G_STRUCT_OFFSET (FunctionBlob, name);
+  signal_name = G_STRUCT_OFFSET (SignalBlob, name);
+  vfunc_name = G_STRUCT_OFFSET (VFuncBlob, name);
+
+  n_interfaces = header->n_local_entries;
+
+  for (i = 0; i < n_interfaces; i++)
+    {
+      DirEntry *entry;
+      MemberIndexEntry index_entry = { 0, };
+      guint n_hashes = hashes->len;
+      guint32 offset;
+
+      entry = (DirEntry *)&data[header->directory + (i * header->entry_blob_size)];
+
+      /* The layout computed here must match the one the info
+       * accessors use to locate the members. */
+      switch (entry->blob_type)
+	{
+	case BLOB_TYPE_OBJECT:
+	  {
+	    ObjectBlob *blob = (ObjectBlob *)&data[entry->offset];
+
+	    offset = entry->offset + header->object_blob_size
+	      + (blob->n_interfaces + blob->n_interfaces % 2) * 2;
+	    offset = skip_fields (data, offset, blob->n_fields);
+	    offset += blob->n_properties * header->property_blob_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_METHODS,
+			     offset, blob->n_methods, function_size, function_name);
+	    offset += blob->n_methods * function_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_SIGNALS,
+			     offset, blob->n_signals, signal_size, signal_name);
+	    offset += blob->n_signals * signal_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_VFUNCS,
+			     offset, blob->n_vfuncs, vfunc_size, vfunc_name);
+	  }
+	  break;
+	case BLOB_TYPE_INTERFACE:
+	  {
+	    InterfaceBlob *blob = (InterfaceBlob *)&data[entry->offset];
+
+	    offset = entry->offset + header->interface_blob_size
+	      + (blob->n_prerequisites + blob->n_prerequisites % 2) * 2
+	      + blob->n_properties * header->property_blob_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_METHODS,
+			     offset, blob->n_methods, function_size, function_name);
+	    offset += blob->n_methods * function_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_SIGNALS,
+			     offset, blob->n_signals, signal_size, signal_name);
+	    offset += blob->n_signals * signal_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_VFUNCS,
+			     offset, blob->n_vfuncs, vfunc_size, vfunc_name);
+	  }
+	  break;
+	case BLOB_TYPE_STRUCT:
+	case BLOB_TYPE_BOXED:
+	  {
+	    StructBlob *blob = (StructBlob *)&data[entry->offset];
+
+	    offset = skip_fields (data, entry->offset + header->struct_blob_size,
+				  blob->n_fields);
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_METHODS,
+			     offset, blob->n_methods, function_size, function_name);
+	  }
+	  break;
+	case BLOB_TYPE_UNION:
+	  {
+	    UnionBlob *blob = (UnionBlob *)&data[entry->offset];
+
+	    offset = entry->offset + header->union_blob_size
+	      + blob->n_fields * header->field_blob_size;
+	    add_member_hash (hashes, data, entries->len, GI_MEMBER_INDEX_METHODS,
+			     offset, blob->n_functions, function_size, function_name);
+	  }
+	  break;
+	default:
+	  break;
+	}
+
+      if (hashes->len > n_hashes)
+	{
+	  index_entry.blob = entry->offset;
+	  g_array_append_val (entries, index_entry);
+	}
+    }
+
+  if (entries->len == 0)
+    {
+      g_array_free (entries, TRUE);
+      g_array_free (hashes, TRUE);
+      return data;
+    }
+
+  /* Entries were added in directory order, which is also the order
+   * the blobs were written in, so the array is sorted by offset. */
+
+  alloc_section (data, GI_SECTION_MEMBER_INDEX, *offset2);
+
+  required_size = sizeof (guint32) + entries->len * sizeof (MemberIndexEntry);
+  for (i = 0; i < hashes->len; i++)
+    {
+      MemberHash *hash = &g_array_index (hashes, MemberHash, i);
+
+      required_size += sizeof (guint32);
+      required_size += ALIGN_VALUE (_gi_typelib_hash_builder_get_buffer_size (hash->builder), 4);
+    }
+
+  new_offset = *offset2 + required_size;
+
+  data = g_realloc (data, new_offset);
+
+  *((guint32 *) &data[*offset2]) = entries->len;
+  hash_offset = *offset2 + sizeof (guint32) + entries->len * sizeof (MemberIndexEntry);
+
+  for (i = 0; i < hashes->len; i++)
+    {
+      MemberHash *hash = &g_array_index (hashes, MemberHash, i);
+      MemberIndexEntry *index_entry = &g_array_index (entries, MemberIndexEntry, hash->entry);
+      guint32 hash_size;
+
+      switch (hash->kind)
+	{
+	case GI_MEMBER_INDEX_METHODS:
+	  index_entry->methods = hash_offset;
+	  break;
+	case GI_MEMBER_INDEX_SIGNALS:
+	  index_entry->signals = hash_offset;
+	  break;
+	case GI_MEMBER_INDEX_VFUNCS:
+	  index_entry->vfuncs = hash_offset;
+	  break;
+	}
+
+      hash_size = ALIGN_VALUE (_gi_typelib_hash_builder_get_buffer_size (hash->builder), 4);
+
+      *((guint32 *) &data[hash_offset]) = hash->n_names;
+      _gi_typelib_hash_builder_pack (hash->builder,
+				     ((guint8*)data) + hash_offset + sizeof (guint32),
+				     hash_size);
+      hash_offset += sizeof (guint32) + hash_size;
+
+      _gi_typelib_hash_builder_destroy (hash->builder);
+    }
+
+  memcpy (&data[*offset2 + sizeof (guint32)], entries->data,
+	  entries->len * sizeof (MemberIndexEntry));
+
+  *offset2 = new_offset;
+
+  g_array_free (entries, TRUE);
+  g_array_free (hashes, TRUE);
+  return data;
+}
+
+static guint8*
+add_field_offsets_section (guint8 *data, GIrModule *module, guint32 *offset2)
+{
+  Header *header = (Header*)data;
+  GArray *entries;
+  GArray *offsets;
+  guint i, j, n_interfaces;
+  guint32 required_size;
+  guint32 table_offset;
+
+  entries = g_array_new (FALSE, TRUE, sizeof (FieldOffsetsEntry));
+  offsets = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  n_interfaces = header->n_local_entries;
+
+  for (i = 0; i < n_interfaces; i++)
+    {
+      DirEntry *entry;
+      FieldOffsetsEntry offsets_entry;
+      guint32 offset, end;
+      guint n_fields;
+
+      entry = (DirEntry *)&data[header->directory + (i * header->entry_blob_size)];
+
+      switch (entry->blob_type)
+	{
+	case BLOB_TYPE_OBJECT:
+	  {
+	    ObjectBlob *blob = (ObjectBlob *)&data[entry->offset];
+
+	    offset = entry->offset + header->object_blob_size
+	      + (blob->n_interfaces + blob->n_interfaces % 2) * 2;
+	    n_fields = blob->n_fields;
+	  }
+	  break;
+	case BLOB_TYPE_STRUCT:
+	case BLOB_TYPE_BOXED:
+	  {
+	    StructBlob *blob = (StructBlob *)&data[entry->offset];
+
+	    offset = entry->offset + header->struct_blob_size;
+	    n_fields = blob->n_fields;
+	  }
+	  break;
+	default:
+	  continue;
+	}
+
+      /* Fixed size fields are located without a table */
+      end = skip_fields (data, offset, n_fields);
+      if (end == offset + n_fields * header->field_blob_size)
+	continue;
+
+      offsets_entry.blob = entry->offset;
+      offsets_entry.offsets = offsets->len;
+      g_array_append_val (entries, offsets_entry);
+
+      for (j = 0; j < n_fields; j++)
+	{
+	  g_array_append_val (offsets, offset);
+	  offset = skip_fields (data, offset, 1);
+	}
+      g_array_append_val (offsets, end);
+    }
+
+  /* As for the member index, directory order is offset order.  The
+   * section is written even when empty, it tells that the fields of all
+   * containers without an entry can be found by their size. */
+
+  alloc_section (data, GI_SECTION_FIELD_OFFSETS, *offset2);
+
+  required_size = sizeof (guint32)
+    + entries->len * sizeof (FieldOffsetsEntry)
+    + offsets->len * sizeof (guint32);
+
+  data = g_realloc (data, *offset2 + required_size);
+
+  *((guint32 *) &data[*offset2]) = entries->len;
+  table_offset = *offset2 + sizeof (guint32) + entries->len * sizeof (FieldOffsetsEntry);
+
+  for (i = 0; i < entries->len; i++)
+    {
+      FieldOffsetsEntry *offsets_entry = &g_array_index (entries, FieldOffsetsEntry, i);
+
+      offsets_entry->offsets = table_offset + offsets_entry->offsets * sizeof (guint32);
+    }
+
+  memcpy (&data[*offset2 + sizeof (guint32)], entries->data,
+	  entries->len * sizeof (FieldOffsetsEntry));
+  memcpy (&data[table_offset], offsets->data, offsets->len * sizeof (guint32));
+
+  *offset2 += required_size;
+
+  g_array_free (entries, TRUE);
+  g_array_free (offsets, TRUE);
+  return data;
+}
+
+static GList *
+get_local_names (GHashTable *table, const char *namespace)
+{
+  GHashTableIter iter;
+  gpointer key;
+  GList *names = NULL;
+  gsize len = strlen (namespace);
+
+  /* The tables also hold the entries merged from the includes */
+  g_hash_table_iter_init (&iter, table);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      const char *name = key;
+
+      if (strncmp (name, namespace, len) == 0 && name[len] == '.')
+	names = g_list_prepend (names, (char *) name);
+    }
+
+  /* Keep the typelib reproducible */
+  return g_list_sort (names, (GCompareFunc) strcmp);
+}
+
+static guint32
+write_section_string (guint8 *data, guint32 *offset, const char *str)
+{
+  guint32 start = *offset;
+  gsize len = strlen (str) + 1;
+
+  memcpy (&data[start], str, len);
+  *offset += len;
+
+  return start;
+}
+
+static guint8*
+add_alias_section (guint8 *data, GIrModule *module, guint32 *offset2)
+{
+  GList *aliases, *disguised, *l;
+  guint32 n_aliases, n_disguised;
+  guint32 required_size;
+  guint32 new_offset;
+  guint32 entry_offset, string_offset;
+
+  aliases = get_local_names (module->aliases, module->name);
+  disguised = get_local_names (module->disguised_structures, module->name);
+  n_aliases = g_list_length (aliases);
+  n_disguised = g_list_length (disguised);
+
+  /* The section is written even when empty, its presence tells
+   * the compiler that the typelib can stand in for the GIR. */
+  alloc_section (data, GI_SECTION_ALIASES, *offset2);
+
+  required_size = 2 * sizeof (guint32)
+    + n_aliases * sizeof (AliasEntry)
+    + n_disguised * sizeof (guint32);
+  for (l = aliases; l; l = l->next)
+    {
+      required_size += strlen (l->data) + 1;
+      required_size += strlen (g_hash_table_lookup (module->aliases, l->data)) + 1;
+    }
+  for (l = disguised; l; l = l->next)
+    required_size += strlen (l->data) + 1;
+  required_size = ALIGN_VALUE (required_size, 4);
+
+  new_offset = *offset2 + required_size;
+
+  data = g_realloc (data, new_offset);
+  memset (&data[*offset2], 0, required_size);
+
+  ((guint32 *) &data[*offset2])[0] = n_aliases;
+  ((guint32 *) &data[*offset2])[1] = n_disguised;
+
+  entry_offset = *offset2 + 2 * sizeof (guint32);
+  string_offset = entry_offset + n_aliases * sizeof (AliasEntry)
+    + n_disguised * sizeof (guint32);
+
+  for (l = aliases; l; l = l->next)
+    {
+      AliasEntry *entry = (AliasEntry *) &data[entry_offset];
+
+      entry->name = write_section_string (data, &string_offset, l->data);
+      entry->target = write_section_string (data, &string_offset,
+					    g_hash_table_lookup (module->aliases, l->data));
+      entry_offset += sizeof (AliasEntry);
+    }
+
+  for (l = disguised; l; l = l->next)
+    {
+      *((guint32 *) &data[entry_offset]) =
+	write_section_string (data, &string_offset, l->data);
+      entry_offset += sizeof (guint32);
+    }
+
+  *offset2 = new_offset;
+
+  g_list_free (aliases);
+  g_list_free (disguised);
+  return data;
+}
+
 GITypelib *
 _g_ir_module_build_typelib (GIrModule  *module)
 {
@@ -316,7 +986,7 @@ _g_ir_module_build_typelib (GIrModule  *module)
   Section *section;
 
   header_size = ALIGN_VALUE (sizeof (Header), 4);
-  n_local_entries = g_list_length (module->entries);
+  n_local_entries = module->entry_nodes->len;
 
   /* Serialize dependencies into one string; this is convenient
    * and not a major change to the typelib format. */
@@ -345,7 +1015,7 @@ _g_ir_module_build_typelib (GIrModule  *module)
   strings = g_hash_table_new (g_str_hash, g_str_equal);
   types = g_hash_table_new (g_str_hash, g_str_equal);
   nodes_with_attributes = NULL;
-  n_entries = g_list_length (module->entries);
+  n_entries = module->entry_nodes->len;
 
   g_message ("%d entries (%d local), %d dependencies\n", n_entries, n_local_entries,
 	     g_list_length (module->dependencies));
@@ -546,6 +1216,18 @@ _g_ir_module_build_typelib (GIrModule  *module)
   data = add_directory_index_section (data, module, &offset2);
   header = (Header *)data;
 
+  data = add_gtype_index_section (data, module, &offset2);
+  header = (Header *)data;
+
+  data = add_member_index_section (data, module, &offset2);
+  header = (Header *)data;
+
+  data = add_field_offsets_section (data, module, &offset2);
+  header = (Header *)data;
+
+  data = add_alias_section (data, module, &offset2);
+  header = (Header *)data;
+
   length = header->size = offset2;
   typelib = g_typelib_new_from_memory (data, length, &error);
   if (!typelib)
@@ -29,6 +29,7 @@ G_BEGIN_DECLS
 
 typedef struct _GIrTypelibBuild GIrTypelibBuild;
 typedef struct _GIrModule GIrModule;
+struct _GIrNode;
 
 struct _GIrTypelibBuild {
   GIrModule  *module;
@@ -49,6 +50,19 @@ struct _GIrModule
   GList *dependencies;
   GList *entries;
 
+  /* Bookkeeping of _g_ir_module_add_entry(); the array holds the
+   * entries in order, without owning them */
+  GList *last_entry;
+  GPtrArray *entry_nodes;
+
+  /* The first entry with a given name, and the first cross reference
+   * with a given "Namespace.name", see _g_ir_module_find_entry() */
+  GHashTable *entry_index;
+  GHashTable *xref_index;
+
+  /* Modules included directly or indirectly, by namespace */
+  GHashTable *include_index;
+
   /* All modules that are included directly or indirectly */
   GList *include_modules;
 
@@ -69,6 +83,14 @@ void       _g_ir_module_free           (GIrModule  *module);
 void       _g_ir_module_add_include_module (GIrModule  *module,
 					   GIrModule  *include_module);
 
+void       _g_ir_module_add_entry      (GIrModule       *module,
+					struct _GIrNode *node);
+struct _GIrNode *_g_ir_module_find_entry (GIrModule  *module,
+					  const char *name,
+					  guint16    *idx);
+GIrModule *_g_ir_module_find_namespace (GIrModule  *module,
+					const char *name);
+
 GITypelib * _g_ir_module_build_typelib  (GIrModule  *module);
 
 void       _g_ir_module_fatal (GIrTypelibBuild  *build, guint line, const char *msg, ...) G_GNUC_PRINTF (3, 4) G_GNUC_NORETURN;
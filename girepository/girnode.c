@@ -33,30 +33,48 @@
 #define strtoull _strtoui64
 #endif
 
-static gulong string_count = 0;
-static gulong unique_string_count = 0;
-static gulong string_size = 0;
-static gulong unique_string_size = 0;
-static gulong types_count = 0;
-static gulong unique_types_count = 0;
+typedef struct {
+  gulong string_count;
+  gulong unique_string_count;
+  gulong string_size;
+  gulong unique_string_size;
+  gulong types_count;
+  gulong unique_types_count;
+} IrNodeStats;
+
+/* Per thread, as g-ir-compiler may build several typelibs at once */
+static GPrivate stats_key = G_PRIVATE_INIT (g_free);
+
+static IrNodeStats *
+get_stats (void)
+{
+  IrNodeStats *stats = g_private_get (&stats_key);
+
+  if (stats == NULL)
+    {
+      stats = g_new0 (IrNodeStats, 1);
+      g_private_set (&stats_key, stats);
+    }
+
+  return stats;
+}
 
 void
 _g_irnode_init_stats (void)
 {
-  string_count = 0;
-  unique_string_count = 0;
-  string_size = 0;
-  unique_string_size = 0;
-  types_count = 0;
-  unique_types_count = 0;
+  memset (get_stats (), 0, sizeof (IrNodeStats));
 }
 
 void
 _g_irnode_dump_stats (void)
 {
+  IrNodeStats *stats = get_stats ();
+
   g_message ("%lu strings (%lu before sharing), %lu bytes (%lu before sharing)",
-	     unique_string_count, string_count, unique_string_size, string_size);
-  g_message ("%lu types (%lu before sharing)", unique_types_count, types_count);
+	     stats->unique_string_count, stats->string_count,
+	     stats->unique_string_size, stats->string_size);
+  g_message ("%lu types (%lu before sharing)",
+	     stats->unique_types_count, stats->types_count);
 }
 
 #define DO_ALIGNED_COPY(dest_addr, value, type) \
@@ -1026,71 +1044,39 @@ find_entry_node (GIrTypelibBuild   *build,
 
 {
   GIrModule *module = build->module;
-  GList *l;
-  gint i;
-  gchar **names;
-  gint n_names;
-  GIrNode *result = NULL;
+  const gchar *dot;
+  GIrNode *result;
 
   g_assert (name != NULL);
   g_assert (strlen (name) > 0);
 
-  names = g_strsplit (name, ".", 0);
-  n_names = g_strv_length (names);
-  if (n_names > 2)
+  dot = strchr (name, '.');
+  if (dot != NULL && strchr (dot + 1, '.') != NULL)
     g_error ("Too many name parts");
 
-  for (l = module->entries, i = 1; l; l = l->next, i++)
-    {
-      GIrNode *node = (GIrNode *)l->data;
+  result = _g_ir_module_find_entry (module, name, idx);
+  if (result != NULL)
+    return result;
 
-      if (n_names > 1)
-	{
-	  if (node->type != G_IR_NODE_XREF)
-	    continue;
-
-	  if (((GIrNodeXRef *)node)->namespace == NULL ||
-	      strcmp (((GIrNodeXRef *)node)->namespace, names[0]) != 0)
-	    continue;
-	}
-
-      if (strcmp (node->name, names[n_names - 1]) == 0)
-	{
-	  if (idx)
-	    *idx = i;
-
-	  result = node;
-	  goto out;
-	}
-    }
-
-  if (n_names > 1)
+  if (dot != NULL)
     {
       GIrNode *node = _g_ir_node_new (G_IR_NODE_XREF, module);
 
-      ((GIrNodeXRef *)node)->namespace = g_strdup (names[0]);
-      node->name = g_strdup (names[1]);
+      ((GIrNodeXRef *)node)->namespace = g_strndup (name, dot - name);
+      node->name = g_strdup (dot + 1);
 
-      module->entries = g_list_append (module->entries, node);
+      _g_ir_module_add_entry (module, node);
 
       if (idx)
-	*idx = g_list_length (module->entries);
+	*idx = module->entry_nodes->len;
 
-      result = node;
+      g_debug ("Creating XREF: %s %s", ((GIrNodeXRef *)node)->namespace, node->name);
 
-      g_debug ("Creating XREF: %s %s", names[0], names[1]);
-
-      goto out;
+      return node;
     }
 
-  
   _g_ir_module_fatal (build, -1, "type reference '%s' not found",
 		      name);
- out:
-
-  g_strfreev (names);
-
-  return result;
 }
 
 static guint16
@@ -1104,71 +1090,32 @@ find_entry (GIrTypelibBuild   *build,
   return idx;
 }
 
-static GIrModule *
-find_namespace (GIrModule  *module,
-		const char *name)
-{
-  GIrModule *target;
-  GList *l;
-  
-  if (strcmp (module->name, name) == 0)
-    return module;
-
-  for (l = module->include_modules; l; l = l->next)
-    {
-      GIrModule *submodule = l->data;
-
-     if (strcmp (submodule->name, name) == 0)
-       return submodule;
-
-      target = find_namespace (submodule, name);
-      if (target)
-       return target;
-    }
-  return NULL;
-}
-
 GIrNode *
 _g_ir_find_node (GIrTypelibBuild  *build,
 		GIrModule        *src_module,
 		const char       *name)
 {
-  GList *l;
-  GIrNode *return_node = NULL;
-  char **names = g_strsplit (name, ".", 0);
-  gint n_names = g_strv_length (names);
-  const char *target_name;
+  const char *dot = strchr (name, '.');
   GIrModule *target_module;
+  GIrNode *return_node = NULL;
 
-  if (n_names == 1)
+  if (dot == NULL)
     {
       target_module = src_module;
-      target_name = name;
+      return_node = _g_ir_module_find_entry (target_module, name, NULL);
     }
   else
     {
-      target_module = find_namespace (build->module, names[0]);
-      target_name = names[1];
-    }
+      char *namespace = g_strndup (name, dot - name);
 
-  /* find_namespace() may return NULL. */
-  if (target_module == NULL)
-      goto done;
+      target_module = _g_ir_module_find_namespace (build->module, namespace);
+      g_free (namespace);
 
-  for (l = target_module->entries; l; l = l->next)
-    {
-      GIrNode *node = (GIrNode *)l->data;
-
-      if (strcmp (node->name, target_name) == 0)
-	{
-	  return_node = node;
-	  break;
-	}
+      /* _g_ir_module_find_namespace() may return NULL. */
+      if (target_module != NULL)
+	return_node = _g_ir_module_find_entry (target_module, dot + 1, NULL);
     }
 
-done:
-  g_strfreev (names);
-
   return return_node;
 }
 
@@ -1441,7 +1388,7 @@ _g_ir_node_build_typelib (GIrNode         *node,
 	    serialize_type (build, type, str);
 	    s = g_string_free (str, FALSE);
 
-	    types_count += 1;
+	    get_stats ()->types_count += 1;
 	    value = g_hash_table_lookup (types, s);
 	    if (value)
 	      {
@@ -1450,7 +1397,7 @@ _g_ir_node_build_typelib (GIrNode         *node,
 	      }
 	    else
 	      {
-		unique_types_count += 1;
+		get_stats ()->unique_types_count += 1;
 		g_hash_table_insert (types, s, GUINT_TO_POINTER(*offset2));
 
 		blob->offset = *offset2;
@@ -2327,19 +2274,20 @@ _g_ir_write_string (const gchar *str,
 		    guchar      *data,
 		    guint32     *offset)
 {
+  IrNodeStats *stats = get_stats ();
   gpointer value;
   guint32 start;
 
-  string_count += 1;
-  string_size += strlen (str);
+  stats->string_count += 1;
+  stats->string_size += strlen (str);
 
   value = g_hash_table_lookup (strings, str);
 
   if (value)
     return GPOINTER_TO_UINT (value);
 
-  unique_string_count += 1;
-  unique_string_size += strlen (str);
+  stats->unique_string_count += 1;
+  stats->unique_string_size += strlen (str);
 
   g_hash_table_insert (strings, (gpointer)str, GUINT_TO_POINTER (*offset));
 
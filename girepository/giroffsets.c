@@ -497,18 +497,15 @@ check_needs_computation (GIrTypelibBuild *build,
   return alignment == 0;
 }
 
-/*
- * _g_ir_node_compute_offsets:
- * @build: Current typelib build
- * @node: a #GIrNode
- *
- * If a node is a a structure or union, makes sure that the field
- * offsets have been computed, and also computes the overall size and
- * alignment for the type.
+/* Modules built concurrently share the nodes of their includes, whose
+ * offsets are computed on demand.  Computations are serialized so that
+ * no build sees another one in progress, which looks like recursion.
  */
-void
-_g_ir_node_compute_offsets (GIrTypelibBuild *build,
-			    GIrNode         *node)
+static GRecMutex offsets_lock;
+
+static void
+compute_offsets (GIrTypelibBuild *build,
+		 GIrNode         *node)
 {
   gboolean appended_stack;
 
@@ -585,3 +582,21 @@ _g_ir_node_compute_offsets (GIrTypelibBuild *build,
   if (appended_stack)
     build->stack = g_list_delete_link (build->stack, build->stack);
 }
+
+/*
+ * _g_ir_node_compute_offsets:
+ * @build: Current typelib build
+ * @node: a #GIrNode
+ *
+ * If a node is a a structure or union, makes sure that the field
+ * offsets have been computed, and also computes the overall size and
+ * alignment for the type.
+ */
+void
+_g_ir_node_compute_offsets (GIrTypelibBuild *build,
+			    GIrNode         *node)
+{
+  g_rec_mutex_lock (&offsets_lock);
+  compute_offsets (build, node);
+  g_rec_mutex_unlock (&offsets_lock);
+}
@@ -31,6 +31,7 @@
 #include "girmodule.h"
 #include "girnode.h"
 #include "gitypelib-internal.h"
+#include "girffi.h"
 
 /* This is a "major" version in the sense that it's only bumped
  * for incompatible changes.
@@ -58,7 +59,13 @@
 struct _GIrParser
 {
   gchar **includes;
+  gboolean typelib_includes;
   GList *parsed_modules; /* All previously parsed modules */
+
+  /* The modules used by the current top-level parse, by namespace;
+   * the others are only used again for the same version */
+  GHashTable *used_modules;
+  guint depth;
 };
 
 typedef enum
@@ -184,6 +191,8 @@ _g_ir_parser_new (void)
 {
   GIrParser *parser = g_slice_new0 (GIrParser);
 
+  parser->used_modules = g_hash_table_new (g_str_hash, g_str_equal);
+
   return parser;
 }
 
@@ -195,6 +204,8 @@ _g_ir_parser_free (GIrParser *parser)
   if (parser->includes)
     g_strfreev (parser->includes);
 
+  g_hash_table_destroy (parser->used_modules);
+
   for (l = parser->parsed_modules; l; l = l->next)
     _g_ir_module_free (l->data);
 
@@ -211,6 +222,43 @@ _g_ir_parser_set_includes (GIrParser          *parser,
   parser->includes = g_strdupv ((char **)includes);
 }
 
+/**
+ * _g_ir_parser_take_module:
+ * @parser: a #GIrParser
+ * @module: a module returned by @parser
+ *
+ * Transfers the ownership of @module to the caller.  @parser will no
+ * longer use it to satisfy the includes of the GIRs it parses next,
+ * so the module can be modified, for instance by building it.
+ */
+void
+_g_ir_parser_take_module (GIrParser *parser,
+			  GIrModule *module)
+{
+  parser->parsed_modules = g_list_remove (parser->parsed_modules, module);
+  if (g_hash_table_lookup (parser->used_modules, module->name) == module)
+    g_hash_table_remove (parser->used_modules, module->name);
+}
+
+/**
+ * _g_ir_parser_set_typelib_includes:
+ * @parser: a #GIrParser
+ * @typelib_includes: whether to use typelibs for includes
+ *
+ * If @typelib_includes is %TRUE, included namespaces are loaded from
+ * the typelibs found on the default #GIRepository search path rather
+ * than by parsing their GIR, which is then only done for namespaces
+ * without a suitable typelib.  Typelibs are suitable only if they were
+ * compiled with the alias section, as aliases do not exist otherwise
+ * in the typelib.
+ */
+void
+_g_ir_parser_set_typelib_includes (GIrParser *parser,
+				   gboolean   typelib_includes)
+{
+  parser->typelib_includes = typelib_includes;
+}
+
 static void
 firstpass_start_element_handler (GMarkupParseContext *context,
 				 const gchar         *element_name,
@@ -788,8 +836,7 @@ start_glib_boxed (GMarkupParseContext *context,
     boxed->deprecated = FALSE;
 
   push_node (ctx, (GIrNode *)boxed);
-  ctx->current_module->entries =
-    g_list_append (ctx->current_module->entries, boxed);
+  _g_ir_module_add_entry (ctx->current_module, (GIrNode *)boxed);
 
   return TRUE;
 }
@@ -907,8 +954,7 @@ start_function (GMarkupParseContext *context,
 
   if (ctx->node_stack == NULL)
     {
-      ctx->current_module->entries =
-	g_list_append (ctx->current_module->entries, function);
+      _g_ir_module_add_entry (ctx->current_module, (GIrNode *)function);
     }
   else if (ctx->current_typed)
     {
@@ -1482,8 +1528,7 @@ start_enum (GMarkupParseContext *context,
     enum_->deprecated = FALSE;
 
   push_node (ctx, (GIrNode *) enum_);
-  ctx->current_module->entries =
-    g_list_append (ctx->current_module->entries, enum_);
+  _g_ir_module_add_entry (ctx->current_module, (GIrNode *)enum_);
 
   return TRUE;
 }
@@ -1714,8 +1759,7 @@ start_constant (GMarkupParseContext *context,
   if (prev_state == STATE_NAMESPACE)
     {
       push_node (ctx, (GIrNode *) constant);
-      ctx->current_module->entries =
-	g_list_append (ctx->current_module->entries, constant);
+      _g_ir_module_add_entry (ctx->current_module, (GIrNode *)constant);
     }
   else
     {
@@ -1784,8 +1828,7 @@ start_interface (GMarkupParseContext *context,
     iface->deprecated = FALSE;
 
   push_node (ctx, (GIrNode *) iface);
-  ctx->current_module->entries =
-    g_list_append (ctx->current_module->entries, iface);
+  _g_ir_module_add_entry (ctx->current_module, (GIrNode *)iface);
 
   return TRUE;
 }
@@ -1874,8 +1917,7 @@ start_class (GMarkupParseContext *context,
     iface->get_value_func = g_strdup (get_value_func);
 
   push_node (ctx, (GIrNode *) iface);
-  ctx->current_module->entries =
-    g_list_append (ctx->current_module->entries, iface);
+  _g_ir_module_add_entry (ctx->current_module, (GIrNode *)iface);
 
   return TRUE;
 }
@@ -2581,8 +2623,7 @@ start_struct (GMarkupParseContext *context,
   struct_->foreign = (g_strcmp0 (foreign, "1") == 0);
 
   if (ctx->node_stack == NULL)
-    ctx->current_module->entries =
-      g_list_append (ctx->current_module->entries, struct_);
+    _g_ir_module_add_entry (ctx->current_module, (GIrNode *)struct_);
   push_node (ctx, (GIrNode *)struct_);
   return TRUE;
 }
@@ -2634,8 +2675,7 @@ start_union (GMarkupParseContext *context,
     union_->deprecated = FALSE;
 
   if (ctx->node_stack == NULL)
-    ctx->current_module->entries =
-      g_list_append (ctx->current_module->entries, union_);
+    _g_ir_module_add_entry (ctx->current_module, (GIrNode *)union_);
   push_node (ctx, (GIrNode *)union_);
   return TRUE;
 }
@@ -2675,6 +2715,405 @@ start_discriminator (GMarkupParseContext *context,
   return TRUE;
 }
 
+static void
+use_module (GIrParser *parser,
+	    GIrModule *module)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  if (!g_hash_table_lookup (parser->used_modules, module->name))
+    g_hash_table_insert (parser->used_modules, module->name, module);
+
+  g_hash_table_iter_init (&iter, module->include_index);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      GIrModule *include = value;
+
+      if (!g_hash_table_lookup (parser->used_modules, include->name))
+	g_hash_table_insert (parser->used_modules, include->name, include);
+    }
+}
+
+/* Returns the module already used for @name by the current parse,
+ * whatever its version, or else a module parsed before with the same
+ * version.  The caller must check the version for conflicts.
+ */
+static GIrModule *
+find_parsed_module (GIrParser  *parser,
+		    const char *name,
+		    const char *version)
+{
+  GIrModule *module;
+  GList *l;
+
+  module = g_hash_table_lookup (parser->used_modules, name);
+  if (module != NULL)
+    return module;
+
+  for (l = parser->parsed_modules; l; l = l->next)
+    {
+      GIrModule *m = l->data;
+
+      if (strcmp (m->name, name) == 0 && strcmp (m->version, version) == 0)
+	{
+	  use_module (parser, m);
+	  return m;
+	}
+    }
+
+  return NULL;
+}
+
+static gboolean
+read_typelib_aliases (GITypelib *typelib,
+		      GIrModule *module)
+{
+  Header *header = (Header *)typelib->data;
+  Section *section;
+  AliasEntry *entries;
+  guint32 *disguised;
+  guint32 n_aliases, n_disguised;
+  guint32 i;
+
+  if (header->sections == 0)
+    return FALSE;
+
+  for (section = (Section *)&typelib->data[header->sections];
+       section->id != GI_SECTION_END;
+       section++)
+    {
+      if (section->id == GI_SECTION_ALIASES)
+	break;
+    }
+  if (section->id != GI_SECTION_ALIASES ||
+      section->offset + 2 * sizeof (guint32) > typelib->len)
+    return FALSE;
+
+  n_aliases = ((guint32 *)&typelib->data[section->offset])[0];
+  n_disguised = ((guint32 *)&typelib->data[section->offset])[1];
+  if (section->offset + 2 * sizeof (guint32) + n_aliases * sizeof (AliasEntry)
+      + n_disguised * sizeof (guint32) > typelib->len)
+    return FALSE;
+
+  entries = (AliasEntry *)&typelib->data[section->offset + 2 * sizeof (guint32)];
+  disguised = (guint32 *)&entries[n_aliases];
+
+  for (i = 0; i < n_aliases; i++)
+    g_hash_table_replace (module->aliases,
+			  g_strdup ((const char *)&typelib->data[entries[i].name]),
+			  g_strdup ((const char *)&typelib->data[entries[i].target]));
+
+  for (i = 0; i < n_disguised; i++)
+    g_hash_table_replace (module->disguised_structures,
+			  g_strdup ((const char *)&typelib->data[disguised[i]]),
+			  GINT_TO_POINTER (1));
+
+  return TRUE;
+}
+
+static gboolean typelib_object_size_alignment (GIObjectInfo *info,
+					       gint         *size,
+					       gint         *alignment);
+
+static gboolean
+typelib_type_size_alignment (GITypeInfo *type_info,
+			     gint       *size,
+			     gint       *alignment)
+{
+  GITypeTag tag = g_type_info_get_tag (type_info);
+  ffi_type *type_ffi;
+
+  if (g_type_info_is_pointer (type_info))
+    {
+      *size = ffi_type_pointer.size;
+      *alignment = ffi_type_pointer.alignment;
+      return TRUE;
+    }
+
+  if (tag == GI_TYPE_TAG_ARRAY)
+    {
+      GITypeInfo *param_type;
+      gint fixed_size = g_type_info_get_array_fixed_size (type_info);
+      gboolean success;
+
+      if (g_type_info_get_array_type (type_info) != GI_ARRAY_TYPE_C ||
+	  fixed_size < 0)
+	return FALSE;
+
+      param_type = g_type_info_get_param_type (type_info, 0);
+      success = typelib_type_size_alignment (param_type, size, alignment);
+      g_base_info_unref ((GIBaseInfo *)param_type);
+      *size *= fixed_size;
+
+      return success;
+    }
+
+  if (tag == GI_TYPE_TAG_INTERFACE)
+    {
+      GIBaseInfo *iface = g_type_info_get_interface (type_info);
+      gboolean success = TRUE;
+
+      switch (g_base_info_get_type (iface))
+	{
+	case GI_INFO_TYPE_STRUCT:
+	case GI_INFO_TYPE_BOXED:
+	  *size = g_struct_info_get_size ((GIStructInfo *)iface);
+	  *alignment = g_struct_info_get_alignment ((GIStructInfo *)iface);
+	  break;
+	case GI_INFO_TYPE_UNION:
+	  *size = g_union_info_get_size ((GIUnionInfo *)iface);
+	  *alignment = g_union_info_get_alignment ((GIUnionInfo *)iface);
+	  break;
+	case GI_INFO_TYPE_OBJECT:
+	  success = typelib_object_size_alignment ((GIObjectInfo *)iface,
+						   size, alignment);
+	  break;
+	case GI_INFO_TYPE_ENUM:
+	case GI_INFO_TYPE_FLAGS:
+	  type_ffi = gi_type_tag_get_ffi_type (g_enum_info_get_storage_type ((GIEnumInfo *)iface),
+					       FALSE);
+	  *size = type_ffi->size;
+	  *alignment = type_ffi->alignment;
+	  break;
+	case GI_INFO_TYPE_CALLBACK:
+	  *size = ffi_type_pointer.size;
+	  *alignment = ffi_type_pointer.alignment;
+	  break;
+	default:
+	  success = FALSE;
+	  break;
+	}
+
+      g_base_info_unref (iface);
+      return success;
+    }
+
+  type_ffi = gi_type_tag_get_ffi_type (tag, FALSE);
+  *size = type_ffi->size;
+  *alignment = type_ffi->alignment;
+
+  return *alignment > 0;
+}
+
+/* Object blobs don't record the size of the instance struct, so it is
+ * recomputed from the field offsets the way giroffsets.c lays them out.
+ */
+static gboolean
+typelib_object_size_alignment (GIObjectInfo *info,
+			       gint         *size,
+			       gint         *alignment)
+{
+  gint n_fields, i;
+  gint object_size = 0;
+  gint object_alignment = 1;
+
+  n_fields = g_object_info_get_n_fields (info);
+  for (i = 0; i < n_fields; i++)
+    {
+      GIFieldInfo *field = g_object_info_get_field (info, i);
+      GITypeInfo *type_info = g_field_info_get_type (field);
+      gint field_size, field_alignment;
+      gboolean success;
+
+      success = typelib_type_size_alignment (type_info, &field_size, &field_alignment);
+      if (success)
+	{
+	  object_size = MAX (object_size, g_field_info_get_offset (field) + field_size);
+	  object_alignment = MAX (object_alignment, field_alignment);
+	}
+
+      g_base_info_unref ((GIBaseInfo *)type_info);
+      g_base_info_unref ((GIBaseInfo *)field);
+
+      if (!success)
+	return FALSE;
+    }
+
+  *size = ALIGN_VALUE (object_size, object_alignment);
+  *alignment = object_alignment;
+
+  return TRUE;
+}
+
+/* Only the registered types are needed from included namespaces, to
+ * compute the size of the fields using them.
+ */
+static GIrNode *
+node_from_typelib_info (GIrModule  *module,
+			GIBaseInfo *info)
+{
+  GIrNode *node;
+
+  switch (g_base_info_get_type (info))
+    {
+    case GI_INFO_TYPE_STRUCT:
+      {
+	GIrNodeStruct *struct_;
+
+	node = _g_ir_node_new (G_IR_NODE_STRUCT, module);
+	struct_ = (GIrNodeStruct *)node;
+	struct_->size = g_struct_info_get_size ((GIStructInfo *)info);
+	struct_->alignment = g_struct_info_get_alignment ((GIStructInfo *)info);
+	break;
+      }
+    case GI_INFO_TYPE_BOXED:
+      {
+	GIrNodeBoxed *boxed;
+
+	/* Boxed blobs have the layout of a struct blob */
+	node = _g_ir_node_new (G_IR_NODE_BOXED, module);
+	boxed = (GIrNodeBoxed *)node;
+	boxed->size = g_struct_info_get_size ((GIStructInfo *)info);
+	boxed->alignment = g_struct_info_get_alignment ((GIStructInfo *)info);
+	break;
+      }
+    case GI_INFO_TYPE_UNION:
+      {
+	GIrNodeUnion *union_;
+
+	node = _g_ir_node_new (G_IR_NODE_UNION, module);
+	union_ = (GIrNodeUnion *)node;
+	union_->size = g_union_info_get_size ((GIUnionInfo *)info);
+	union_->alignment = g_union_info_get_alignment ((GIUnionInfo *)info);
+	break;
+      }
+    case GI_INFO_TYPE_OBJECT:
+      {
+	GIrNodeInterface *iface;
+
+	node = _g_ir_node_new (G_IR_NODE_OBJECT, module);
+	iface = (GIrNodeInterface *)node;
+	if (!typelib_object_size_alignment ((GIObjectInfo *)info,
+					    &iface->size, &iface->alignment))
+	  {
+	    iface->size = -1;
+	    iface->alignment = -1;
+	  }
+	break;
+      }
+    case GI_INFO_TYPE_INTERFACE:
+      {
+	GIrNodeInterface *iface;
+
+	/* Like an interface without fields in giroffsets.c */
+	node = _g_ir_node_new (G_IR_NODE_INTERFACE, module);
+	iface = (GIrNodeInterface *)node;
+	iface->size = 0;
+	iface->alignment = 1;
+	break;
+      }
+    case GI_INFO_TYPE_ENUM:
+    case GI_INFO_TYPE_FLAGS:
+      {
+	GIrNodeEnum *enum_;
+
+	node = _g_ir_node_new (g_base_info_get_type (info) == GI_INFO_TYPE_ENUM
+			       ? G_IR_NODE_ENUM : G_IR_NODE_FLAGS, module);
+	enum_ = (GIrNodeEnum *)node;
+	enum_->storage_type = g_enum_info_get_storage_type ((GIEnumInfo *)info);
+	break;
+      }
+    case GI_INFO_TYPE_CALLBACK:
+      node = _g_ir_node_new (G_IR_NODE_CALLBACK, module);
+      break;
+    default:
+      return NULL;
+    }
+
+  node->name = g_strdup (g_base_info_get_name (info));
+
+  return node;
+}
+
+/* Builds a module for an included namespace out of its typelib and
+ * those of its dependencies; returns %NULL if any of them is missing
+ * or lacks the alias section, in which case the GIR must be parsed.
+ */
+static GIrModule *
+load_include_typelib (GIrParser  *parser,
+		      const char *name,
+		      const char *version)
+{
+  GError *error = NULL;
+  GITypelib *typelib;
+  GIrModule *module;
+  GList *include_modules = NULL;
+  GList *l;
+  gchar **dependencies;
+  gint i, n_infos;
+
+  typelib = g_irepository_require (NULL, name, version, 0, &error);
+  if (typelib == NULL)
+    {
+      g_debug ("No typelib for include %s-%s: %s", name, version, error->message);
+      g_clear_error (&error);
+      return NULL;
+    }
+
+  dependencies = g_irepository_get_immediate_dependencies (NULL, name);
+  for (i = 0; dependencies[i] != NULL; i++)
+    {
+      GIrModule *include;
+      char *dependency_version;
+
+      dependency_version = strchr (dependencies[i], '-');
+      if (dependency_version == NULL)
+	continue;
+      *dependency_version++ = '\0';
+
+      include = find_parsed_module (parser, dependencies[i], dependency_version);
+      if (include != NULL && strcmp (include->version, dependency_version) != 0)
+	include = NULL;
+      else if (include == NULL)
+	include = load_include_typelib (parser, dependencies[i], dependency_version);
+
+      if (include == NULL)
+	{
+	  g_strfreev (dependencies);
+	  g_list_free (include_modules);
+	  return NULL;
+	}
+
+      include_modules = g_list_append (include_modules, include);
+    }
+  g_strfreev (dependencies);
+
+  module = _g_ir_module_new (name, version,
+			     g_irepository_get_shared_library (NULL, name),
+			     g_irepository_get_c_prefix (NULL, name));
+  module->aliases = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  module->disguised_structures = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  if (!read_typelib_aliases (typelib, module))
+    {
+      g_debug ("Typelib for include %s-%s has no aliases section", name, version);
+      _g_ir_module_free (module);
+      g_list_free (include_modules);
+      return NULL;
+    }
+
+  for (l = include_modules; l; l = l->next)
+    _g_ir_module_add_include_module (module, l->data);
+  g_list_free (include_modules);
+
+  n_infos = g_irepository_get_n_infos (NULL, name);
+  for (i = 0; i < n_infos; i++)
+    {
+      GIBaseInfo *info = g_irepository_get_info (NULL, name, i);
+      GIrNode *node = node_from_typelib_info (module, info);
+
+      if (node != NULL)
+	_g_ir_module_add_entry (module, node);
+      g_base_info_unref (info);
+    }
+
+  parser->parsed_modules = g_list_prepend (parser->parsed_modules, module);
+  use_module (parser, module);
+
+  return module;
+}
+
 static gboolean
 parse_include (GMarkupParseContext *context,
 	       ParseContext        *ctx,
@@ -2686,26 +3125,33 @@ parse_include (GMarkupParseContext *context,
   gsize length;
   gchar *girpath, *girname;
   GIrModule *module;
-  GList *l;
 
-  for (l = ctx->parser->parsed_modules; l; l = l->next)
+  module = find_parsed_module (ctx->parser, name, version);
+  if (module != NULL)
     {
-      GIrModule *m = l->data;
+      if (strcmp (module->version, version) == 0)
+	{
+	  ctx->include_modules = g_list_prepend (ctx->include_modules, module);
 
-      if (strcmp (m->name, name) == 0)
+	  return TRUE;
+	}
+      else
 	{
-	  if (strcmp (m->version, version) == 0)
-	    {
-	      ctx->include_modules = g_list_prepend (ctx->include_modules, m);
+	  g_printerr ("Module '%s' imported with conflicting versions '%s' and '%s'\n",
+		      name, module->version, version);
+	  return FALSE;
+	}
+    }
 
-	      return TRUE;
-	    }
-	  else
-	    {
-	      g_printerr ("Module '%s' imported with conflicting versions '%s' and '%s'\n",
-			  name, m->version, version);
-	      return FALSE;
-	    }
+  if (ctx->parser->typelib_includes)
+    {
+      module = load_include_typelib (ctx->parser, name, version);
+      if (module != NULL)
+	{
+	  g_debug ("Using typelib for include %s-%s\n", name, version);
+	  ctx->include_modules = g_list_prepend (ctx->include_modules, module);
+
+	  return TRUE;
 	}
     }
 
@@ -2744,8 +3190,10 @@ parse_include (GMarkupParseContext *context,
     }
   g_free (girpath);
 
-  ctx->include_modules = g_list_append (ctx->include_modules,
-					module);
+  /* Like the other ways of satisfying an include, so that the
+   * lookup order does not depend on which was used */
+  ctx->include_modules = g_list_prepend (ctx->include_modules,
+					 module);
 
   return TRUE;
 }
@@ -3548,6 +3996,12 @@ _g_ir_parser_parse_string (GIrParser           *parser,
 {
   ParseContext ctx = { 0 };
   GMarkupParseContext *context;
+  GList *l;
+
+  /* Includes are parsed recursively; only a top-level parse starts a
+   * new set of used modules */
+  if (parser->depth++ == 0)
+    g_hash_table_remove_all (parser->used_modules);
 
   ctx.parser = parser;
   ctx.state = STATE_START;
@@ -3580,8 +4034,11 @@ _g_ir_parser_parse_string (GIrParser           *parser,
 
   parser->parsed_modules = g_list_concat (g_list_copy (ctx.modules),
 					  parser->parsed_modules);
+  for (l = ctx.modules; l; l = l->next)
+    use_module (parser, l->data);
 
  out:
+  parser->depth--;
 
   if (ctx.modules == NULL)
     {
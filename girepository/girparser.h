@@ -34,6 +34,10 @@ GIrParser *_g_ir_parser_new          (void);
 void       _g_ir_parser_free         (GIrParser          *parser);
 void       _g_ir_parser_set_includes (GIrParser          *parser,
 				      const gchar *const *includes);
+void       _g_ir_parser_take_module  (GIrParser          *parser,
+				      GIrModule          *module);
+void       _g_ir_parser_set_typelib_includes (GIrParser *parser,
+					      gboolean   typelib_includes);
 
 GIrModule *_g_ir_parser_parse_string (GIrParser    *parser,
 				      const gchar  *namespace,
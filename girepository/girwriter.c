@@ -32,87 +32,254 @@
 #include "girepository.h"
 #include "gitypelib-internal.h"
 
+/* Output is built up in memory and written out in blocks of about
+ * this size. */
+#define XML_BUFFER_SIZE (64 * 1024)
+
 typedef struct {
   FILE *file;
-  GSList *stack;
+  GString *buffer;
+  GArray *stack;
   gboolean show_all;
 } Xml;
 
+/* See _gir_writer_set_markup_printf() */
+static gboolean markup_printf = FALSE;
+
 typedef struct {
-  char *name;
-  guint has_children : 1;
+  /* Element names are static strings, they are not copied */
+  const char *name;
+  gboolean has_children;
 } XmlElement;
 
-static XmlElement *
-xml_element_new (const char *name)
+static void
+xml_flush (Xml *xml)
 {
-  XmlElement *elem;
+  if (xml->buffer->len == 0)
+    return;
 
-  elem = g_slice_new (XmlElement);
-  elem->name = g_strdup (name);
-  elem->has_children = FALSE;
-  return elem;
+  if (fwrite (xml->buffer->str, 1, xml->buffer->len, xml->file) != xml->buffer->len)
+    g_critical ("failed to write GIR: %s", g_strerror (errno));
+  g_string_truncate (xml->buffer, 0);
 }
 
+/* Escapes @str while copying it to the output, like
+ * g_markup_escape_text() does but without an intermediate string. */
 static void
-xml_element_free (XmlElement *elem)
+xml_append_escaped (Xml *xml, const char *str)
 {
-  g_free (elem->name);
-  g_slice_free (XmlElement, elem);
+  GString *buffer = xml->buffer;
+  const char *run;
+  const char *p;
+
+  if (str == NULL)
+    str = "(null)";
+
+  run = p = str;
+  while (*p != '\0')
+    {
+      const char *entity = NULL;
+      guint codepoint = 0;
+      guint len = 1;
+      guchar c = *p;
+
+      switch (c)
+        {
+        case '&':
+          entity = "&amp;";
+          break;
+        case '<':
+          entity = "&lt;";
+          break;
+        case '>':
+          entity = "&gt;";
+          break;
+        case '\'':
+          entity = "&apos;";
+          break;
+        case '"':
+          entity = "&quot;";
+          break;
+        default:
+          if ((c >= 0x1 && c <= 0x8) || (c >= 0xb && c <= 0xc) ||
+              (c >= 0xe && c <= 0x1f) || c == 0x7f)
+            codepoint = c;
+          else if (c == 0xc2 && (guchar) p[1] >= 0x80 && (guchar) p[1] <= 0x9f)
+            {
+              /* C1 control characters */
+              codepoint = (guchar) p[1];
+              len = 2;
+            }
+          break;
+        }
+
+      if (entity == NULL && codepoint == 0)
+        {
+          p++;
+          continue;
+        }
+
+      g_string_append_len (buffer, run, p - run);
+      if (entity != NULL)
+        g_string_append (buffer, entity);
+      else
+        {
+          char ref[8];
+
+          g_snprintf (ref, sizeof (ref), "&#x%x;", codepoint);
+          g_string_append (buffer, ref);
+        }
+      p += len;
+      run = p;
+    }
+  g_string_append_len (buffer, run, p - run);
 }
 
+/* Supports the conversions used in this file: %s arguments are
+ * escaped, integers (with the h, l and ll modifiers, and the I64 one
+ * of G_GINT64_FORMAT on Windows) and doubles are not. */
 static void
 xml_printf (Xml *xml, const char *fmt, ...)
 {
   va_list ap;
-  char *s;
+  const char *p;
 
   va_start (ap, fmt);
-  s = g_markup_vprintf_escaped (fmt, ap);
-  fputs (s, xml->file);
-  g_free (s);
+
+  if (markup_printf)
+    {
+      char *s = g_markup_vprintf_escaped (fmt, ap);
+
+      g_string_append (xml->buffer, s);
+      g_free (s);
+      va_end (ap);
+      return;
+    }
+
+  p = fmt;
+  while (*p != '\0')
+    {
+      const char *run = p;
+      char spec[8];
+      char number[32];
+      guint n_long = 0;
+      guint n = 0;
+
+      while (*p != '\0' && *p != '%')
+        p++;
+      g_string_append_len (xml->buffer, run, p - run);
+      if (*p == '\0')
+        break;
+
+      spec[n++] = *p++;
+      if (strncmp (p, "I64", 3) == 0)
+        {
+          memcpy (&spec[n], p, 3);
+          n += 3;
+          p += 3;
+          n_long = 2;
+        }
+      while (*p == 'h' || *p == 'l')
+        {
+          if (*p == 'l')
+            n_long++;
+          g_assert (n < sizeof (spec) - 2);
+          spec[n++] = *p++;
+        }
+      spec[n++] = *p;
+      spec[n] = '\0';
+
+      switch (*p++)
+        {
+        case '%':
+          g_string_append_c (xml->buffer, '%');
+          break;
+        case 's':
+          xml_append_escaped (xml, va_arg (ap, const char *));
+          break;
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+          if (n_long >= 2)
+            g_snprintf (number, sizeof (number), spec, va_arg (ap, long long));
+          else if (n_long == 1)
+            g_snprintf (number, sizeof (number), spec, va_arg (ap, long));
+          else
+            g_snprintf (number, sizeof (number), spec, va_arg (ap, int));
+          g_string_append (xml->buffer, number);
+          break;
+        case 'f':
+          g_string_append_printf (xml->buffer, spec, va_arg (ap, double));
+          break;
+        default:
+          g_assert_not_reached ();
+        }
+    }
+
   va_end (ap);
 }
 
+static void
+xml_indent (Xml *xml)
+{
+  guint i;
+
+  for (i = 0; i < xml->stack->len; i++)
+    g_string_append_len (xml->buffer, "  ", 2);
+}
+
 static void
 xml_start_element (Xml *xml, const char *element_name)
 {
-  XmlElement *parent = NULL;
+  XmlElement elem;
 
-  if (xml->stack)
+  if (xml->stack->len > 0)
     {
-      parent = xml->stack->data;
+      XmlElement *parent;
+
+      parent = &g_array_index (xml->stack, XmlElement, xml->stack->len - 1);
 
       if (!parent->has_children)
-        xml_printf (xml, ">\n");
+        g_string_append_len (xml->buffer, ">\n", 2);
 
       parent->has_children = TRUE;
     }
 
-  xml_printf (xml, "%*s<%s", g_slist_length(xml->stack)*2, "", element_name);
+  xml_indent (xml);
+  g_string_append_c (xml->buffer, '<');
+  g_string_append (xml->buffer, element_name);
 
-  xml->stack = g_slist_prepend (xml->stack, xml_element_new (element_name));
+  elem.name = element_name;
+  elem.has_children = FALSE;
+  g_array_append_val (xml->stack, elem);
 }
 
 static void
 xml_end_element (Xml *xml, const char *name)
 {
-  XmlElement *elem;
+  XmlElement elem;
 
-  g_assert (xml->stack != NULL);
+  g_assert (xml->stack->len > 0);
 
-  elem = xml->stack->data;
-  xml->stack = g_slist_delete_link (xml->stack, xml->stack);
+  elem = g_array_index (xml->stack, XmlElement, xml->stack->len - 1);
+  g_array_set_size (xml->stack, xml->stack->len - 1);
 
   if (name != NULL)
-    g_assert_cmpstr (name, ==, elem->name);
+    g_assert_cmpstr (name, ==, elem.name);
 
-  if (elem->has_children)
-    xml_printf (xml, "%*s</%s>\n", g_slist_length (xml->stack)*2, "", elem->name);
+  if (elem.has_children)
+    {
+      xml_indent (xml);
+      g_string_append_len (xml->buffer, "</", 2);
+      g_string_append (xml->buffer, elem.name);
+      g_string_append_len (xml->buffer, ">\n", 2);
+    }
   else
-    xml_printf (xml, "/>\n");
+    g_string_append_len (xml->buffer, "/>\n", 3);
 
-  xml_element_free (elem);
+  if (xml->buffer->len >= XML_BUFFER_SIZE)
+    xml_flush (xml);
 }
 
 static void
@@ -128,7 +295,8 @@ xml_open (FILE *file)
 
   xml = g_slice_new (Xml);
   xml->file = file;
-  xml->stack = NULL;
+  xml->buffer = g_string_sized_new (XML_BUFFER_SIZE);
+  xml->stack = g_array_new (FALSE, FALSE, sizeof (XmlElement));
 
   return xml;
 }
@@ -136,9 +304,10 @@ xml_open (FILE *file)
 static void
 xml_close (Xml *xml)
 {
-  g_assert (xml->stack == NULL);
+  g_assert (xml->stack->len == 0);
   if (xml->file != NULL)
     {
+      xml_flush (xml);
       fflush (xml->file);
       if (xml->file != stdout)
         fclose (xml->file);
@@ -150,6 +319,8 @@ static void
 xml_free (Xml *xml)
 {
   xml_close (xml);
+  g_string_free (xml->buffer, TRUE);
+  g_array_free (xml->stack, TRUE);
   g_slice_free (Xml, xml);
 }
 
@@ -1250,6 +1421,21 @@ write_union_info (const gchar *namespace,
 }
 
 
+/**
+ * _gir_writer_set_markup_printf:
+ * @use_markup_printf: whether to format with g_markup_vprintf_escaped()
+ *
+ * Makes the writer format every fragment with
+ * g_markup_vprintf_escaped() rather than escaping the arguments itself,
+ * which is how it used to work.  Only meant for the tests, to check
+ * that both give the same output; must not be called while writing.
+ */
+void
+_gir_writer_set_markup_printf (gboolean use_markup_printf)
+{
+  markup_printf = use_markup_printf;
+}
+
 /**
  * gir_writer_write:
  * @filename: filename to write to
@@ -1258,7 +1444,8 @@ write_union_info (const gchar *namespace,
  * @show_all: if field size calculations should be included
  *
  * Writes the output of a typelib represented by @namespace
- * into a GIR xml file named @filename.
+ * into a GIR xml file named @filename.  Several namespaces can
+ * be written from different threads at the same time.
  */
 void
 gir_writer_write (const char *filename,
@@ -1284,7 +1471,7 @@ gir_writer_write (const char *filename,
 	full_filename = g_strdup_printf ("%s-%s", namespace, filename);
       else
 	full_filename = g_strdup (filename);
-      ofile = g_fopen (filename, "w");
+      ofile = g_fopen (full_filename, "w");
 
       if (ofile == NULL)
 	{
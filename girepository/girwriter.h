@@ -27,4 +27,6 @@ void gir_writer_write (const char *filename,
 		       gboolean    needs_prefix,
 		       gboolean    show_all);
 
+void _gir_writer_set_markup_printf (gboolean use_markup_printf);
+
 #endif  /* __GIRWRITER_H__ */
@@ -22,6 +22,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <glib.h>
 
 #include <girepository.h>
@@ -51,6 +53,49 @@
  * </refsect1>
  */
 
+GISignalInfo *
+_g_base_info_find_signal (GIBaseInfo   *base,
+			  guint32       offset,
+			  gint          n_signals,
+			  const gchar  *name)
+{
+  GIRealInfo *rinfo = (GIRealInfo*)base;
+  Header *header = (Header *)rinfo->typelib->data;
+  guint16 index;
+  gint i;
+
+  if (g_typelib_lookup_member (rinfo->typelib, rinfo->offset,
+			       GI_MEMBER_INDEX_SIGNALS, name, &index))
+    {
+      SignalBlob *sblob;
+
+      if (index >= n_signals)
+	return NULL;
+
+      offset += index * header->signal_blob_size;
+      sblob = (SignalBlob *)&rinfo->typelib->data[offset];
+      if (strcmp (name, (const gchar *)&rinfo->typelib->data[sblob->name]) != 0)
+	return NULL;
+
+      return (GISignalInfo *) g_info_new (GI_INFO_TYPE_SIGNAL, base,
+					  rinfo->typelib, offset);
+    }
+
+  for (i = 0; i < n_signals; i++)
+    {
+      SignalBlob *sblob = (SignalBlob *)&rinfo->typelib->data[offset];
+      const gchar *sname = (const gchar *)&rinfo->typelib->data[sblob->name];
+
+      if (strcmp (name, sname) == 0)
+        return (GISignalInfo *) g_info_new (GI_INFO_TYPE_SIGNAL, base,
+					    rinfo->typelib, offset);
+
+      offset += header->signal_blob_size;
+    }
+
+  return NULL;
+}
+
 /**
  * g_signal_info_get_flags:
  * @info: a #GISignalInfo
@@ -80,9 +80,17 @@ g_struct_get_field_offset (GIStructInfo *info,
   GIRealInfo *rinfo = (GIRealInfo *)info;
   Header *header = (Header *)rinfo->typelib->data;
   guint32 offset = rinfo->offset + header->struct_blob_size;
+  const guint32 *field_offsets;
   gint i;
   FieldBlob *field_blob;
 
+  if (g_typelib_lookup_field_offsets (rinfo->typelib, rinfo->offset, &field_offsets))
+    {
+      if (field_offsets != NULL)
+        return field_offsets[n];
+      return offset + n * header->field_blob_size;
+    }
+
   for (i = 0; i < n; i++)
     {
       field_blob = (FieldBlob *)&rinfo->typelib->data[offset];
@@ -94,6 +102,17 @@ g_struct_get_field_offset (GIStructInfo *info,
   return offset;
 }
 
+static gint32
+g_struct_get_method_offset (GIStructInfo *info,
+                            gint          n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  StructBlob *blob = (StructBlob *)&rinfo->typelib->data[rinfo->offset];
+  Header *header = (Header *)rinfo->typelib->data;
+
+  return g_struct_get_field_offset (info, blob->n_fields) + n * header->function_blob_size;
+}
+
 /**
  * g_struct_info_get_field:
  * @info: a #GIStructInfo
@@ -114,6 +133,35 @@ g_struct_info_get_field (GIStructInfo *info,
                                      g_struct_get_field_offset (info, n));
 }
 
+/**
+ * g_struct_info_load_field:
+ * @info: a #GIStructInfo
+ * @n: a field index
+ * @field: (out caller-allocates): Initialized with the type information for
+ *   field with specified index
+ *
+ * Obtain the type information for field with specified index; this function
+ * is a variant of g_struct_info_get_field() designed for stack allocation.
+ *
+ * The initialized @field must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_struct_info_load_field (GIStructInfo *info,
+                          gint          n,
+                          GIFieldInfo  *field)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_STRUCT_INFO (info));
+
+  _g_info_init ((GIRealInfo *) field, GI_INFO_TYPE_FIELD, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_struct_get_field_offset (info, n));
+}
+
 /**
  * g_struct_info_get_n_methods:
  * @info: a #GIStructInfo
@@ -146,13 +194,39 @@ g_struct_info_get_method (GIStructInfo *info,
 			  gint         n)
 {
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  StructBlob *blob = (StructBlob *)&rinfo->typelib->data[rinfo->offset];
-  Header *header = (Header *)rinfo->typelib->data;
-  gint offset;
 
-  offset = g_struct_get_field_offset (info, blob->n_fields) + n * header->function_blob_size;
   return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info,
-                                        rinfo->typelib, offset);
+                                        rinfo->typelib, g_struct_get_method_offset (info, n));
+}
+
+/**
+ * g_struct_info_load_method:
+ * @info: a #GIStructInfo
+ * @n: a method index
+ * @method: (out caller-allocates): Initialized with the type information
+ *   for method with specified index
+ *
+ * Obtain the type information for method with specified index; this
+ * function is a variant of g_struct_info_get_method() designed for stack
+ * allocation.
+ *
+ * The initialized @method must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_struct_info_load_method (GIStructInfo   *info,
+                           gint            n,
+                           GIFunctionInfo *method)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_STRUCT_INFO (info));
+
+  _g_info_init ((GIRealInfo *) method, GI_INFO_TYPE_FUNCTION, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_struct_get_method_offset (info, n));
 }
 
 /**
@@ -171,11 +245,9 @@ g_struct_info_find_method (GIStructInfo *info,
 {
   gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header = (Header *)rinfo->typelib->data;
   StructBlob *blob = (StructBlob *)&rinfo->typelib->data[rinfo->offset];
 
-  offset = rinfo->offset + header->struct_blob_size
-    + blob->n_fields * header->field_blob_size;
+  offset = g_struct_get_method_offset (info, 0);
 
   return _g_base_info_find_method ((GIBaseInfo*)info, offset, blob->n_methods, name);
 }
@@ -48,6 +48,11 @@ GI_AVAILABLE_IN_ALL
 GIFieldInfo *    g_struct_info_get_field       (GIStructInfo *info,
 						gint          n);
 
+GI_AVAILABLE_IN_1_46
+void             g_struct_info_load_field      (GIStructInfo *info,
+                                                gint          n,
+                                                GIFieldInfo  *field);
+
 GI_AVAILABLE_IN_ALL
 gint             g_struct_info_get_n_methods   (GIStructInfo *info);
 
@@ -55,6 +60,11 @@ GI_AVAILABLE_IN_ALL
 GIFunctionInfo * g_struct_info_get_method      (GIStructInfo *info,
 						gint          n);
 
+GI_AVAILABLE_IN_1_46
+void             g_struct_info_load_method     (GIStructInfo   *info,
+                                                gint            n,
+                                                GIFunctionInfo *method);
+
 GI_AVAILABLE_IN_ALL
 GIFunctionInfo * g_struct_info_find_method     (GIStructInfo *info,
 						const gchar  *name);
@@ -156,6 +156,57 @@ g_type_info_get_param_type (GITypeInfo *info,
   return NULL;
 }
 
+/**
+ * g_type_info_load_param_type:
+ * @info: a #GITypeInfo
+ * @n: index of the parameter
+ * @param_type: (out caller-allocates): Initialized with the parameter type @n
+ *
+ * Obtain the parameter type @n; this function is a variant of
+ * g_type_info_get_param_type() designed for stack allocation.
+ *
+ * The initialized @param_type must not be referenced after @info is
+ * deallocated.
+ *
+ * Returns: %TRUE if @param_type was initialized, %FALSE if @info has no
+ * parameter types
+ * Since: 1.46
+ */
+gboolean
+g_type_info_load_param_type (GITypeInfo *info,
+                             gint        n,
+                             GITypeInfo *param_type)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  SimpleTypeBlob *type;
+
+  g_return_val_if_fail (info != NULL, FALSE);
+  g_return_val_if_fail (GI_IS_TYPE_INFO (info), FALSE);
+
+  type = (SimpleTypeBlob *)&rinfo->typelib->data[rinfo->offset];
+
+  if (!(type->flags.reserved == 0 && type->flags.reserved2 == 0))
+    {
+      ParamTypeBlob *param = (ParamTypeBlob *)&rinfo->typelib->data[rinfo->offset];
+
+      switch (param->tag)
+        {
+          case GI_TYPE_TAG_ARRAY:
+          case GI_TYPE_TAG_GLIST:
+          case GI_TYPE_TAG_GSLIST:
+          case GI_TYPE_TAG_GHASH:
+            _g_type_info_init ((GIBaseInfo*)param_type, (GIBaseInfo*)info, rinfo->typelib,
+                               rinfo->offset + sizeof (ParamTypeBlob)
+                               + sizeof (SimpleTypeBlob) * n);
+            return TRUE;
+          default:
+            break;
+        }
+    }
+
+  return FALSE;
+}
+
 /**
  * g_type_info_get_interface:
  * @info: a #GITypeInfo
@@ -212,6 +263,67 @@ g_type_info_get_interface (GITypeInfo *info)
   return NULL;
 }
 
+/**
+ * g_type_info_load_interface:
+ * @info: a #GITypeInfo
+ * @iface: (out caller-allocates): Initialized with the referenced type
+ *
+ * Obtain the type referenced by a #GI_TYPE_TAG_INTERFACE type; this
+ * function is a variant of g_type_info_get_interface() designed for
+ * stack allocation.  A reference to a type of a namespace that is not
+ * loaded initializes @iface as a #GI_INFO_TYPE_UNRESOLVED info.
+ *
+ * The initialized @iface must not be referenced after @info is
+ * deallocated.
+ *
+ * Returns: %TRUE if @iface was initialized, %FALSE if @info does not
+ * reference a type
+ * Since: 1.46
+ */
+gboolean
+g_type_info_load_interface (GITypeInfo *info,
+                            GIBaseInfo *iface)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_val_if_fail (info != NULL, FALSE);
+  g_return_val_if_fail (GI_IS_TYPE_INFO (info), FALSE);
+
+  /* See g_type_info_get_interface() */
+  if (rinfo->type_is_embedded)
+    {
+      CommonBlob *common = (CommonBlob *)&rinfo->typelib->data[rinfo->offset];
+
+      switch (common->blob_type)
+        {
+          case BLOB_TYPE_CALLBACK:
+            _g_info_init ((GIRealInfo *) iface, GI_INFO_TYPE_CALLBACK, rinfo->repository,
+                          (GIBaseInfo*)info, rinfo->typelib, rinfo->offset);
+            return TRUE;
+          default:
+            g_assert_not_reached ();
+            return FALSE;
+        }
+    }
+  else
+    {
+      SimpleTypeBlob *type = (SimpleTypeBlob *)&rinfo->typelib->data[rinfo->offset];
+      if (!(type->flags.reserved == 0 && type->flags.reserved2 == 0))
+        {
+          InterfaceTypeBlob *blob = (InterfaceTypeBlob *)&rinfo->typelib->data[rinfo->offset];
+
+          if (blob->tag == GI_TYPE_TAG_INTERFACE)
+            {
+              _g_info_load_from_entry ((GIRealInfo *) iface, rinfo->repository,
+                                       rinfo->typelib, blob->interface);
+              return TRUE;
+            }
+        }
+    }
+
+  return FALSE;
+}
+
 /**
  * g_type_info_get_array_length:
  * @info: a #GITypeInfo
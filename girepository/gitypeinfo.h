@@ -65,9 +65,18 @@ GI_AVAILABLE_IN_ALL
 GITypeInfo *           g_type_info_get_param_type      (GITypeInfo *info,
 						        gint       n);
 
+GI_AVAILABLE_IN_1_46
+gboolean               g_type_info_load_param_type     (GITypeInfo *info,
+                                                        gint        n,
+                                                        GITypeInfo *param_type);
+
 GI_AVAILABLE_IN_ALL
 GIBaseInfo *           g_type_info_get_interface       (GITypeInfo *info);
 
+GI_AVAILABLE_IN_1_46
+gboolean               g_type_info_load_interface      (GITypeInfo *info,
+                                                        GIBaseInfo *iface);
+
 GI_AVAILABLE_IN_ALL
 gint                   g_type_info_get_array_length    (GITypeInfo *info);
 
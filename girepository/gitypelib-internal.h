@@ -145,6 +145,50 @@ Changes since 0.1:
  */
 #define G_IR_MAGIC "GOBJ\nMETADATA\r\n\032"
 
+/**
+ * G_IR_BUNDLE_MAGIC:
+ *
+ * Identifying prefix for a typelib bundle, padded to 16 bytes.
+ */
+#define G_IR_BUNDLE_MAGIC "GOBJ\nBUNDLE\r\n\032\0"
+
+/**
+ * BundleHeader:
+ * @magic: See #G_IR_BUNDLE_MAGIC.
+ * @size: The size of the bundle file in bytes.
+ * @n_entries: The number of typelibs in the bundle.
+ * @entries: Offset of the #BundleEntry array.
+ *
+ * A bundle packs a closed set of typelibs, each typelib together with
+ * all of its dependencies, into a single file, so that they can all be
+ * registered from one mapping.  The typelibs are stored unmodified and
+ * aligned to 8 bytes; all offsets are relative to the start of the
+ * bundle.
+ */
+typedef struct {
+  gchar   magic[16];
+  guint32 size;
+  guint32 n_entries;
+  guint32 entries;
+  guint32 reserved;
+} BundleHeader;
+
+/**
+ * BundleEntry:
+ * @name: Offset of the nul-terminated "namespace-version" string.
+ * @offset: Offset of the typelib data.
+ * @size: Size of the typelib data in bytes.
+ *
+ * An entry in the namespace table of a bundle.  Entries are sorted by
+ * name.
+ */
+typedef struct {
+  guint32 name;
+  guint32 offset;
+  guint32 size;
+  guint32 reserved;
+} BundleEntry;
+
 /**
  * GTypelibBlobType:
  * @BLOB_TYPE_INVALID: Should not appear in code
@@ -289,12 +333,29 @@ typedef struct {
  * SectionType:
  * @GI_SECTION_END: TODO
  * @GI_SECTION_DIRECTORY_INDEX: TODO
+ * @GI_SECTION_GTYPE_INDEX: Perfect hash of the local registered types,
+ *   keyed by GType name.  The section starts with a guint32 holding the
+ *   number of hashed names, followed by the hash itself (only present
+ *   if the count is non-zero).
+ * @GI_SECTION_MEMBER_INDEX: Per-container hashes of method, signal and
+ *   virtual function names.  See #MemberIndexEntry.
+ * @GI_SECTION_ALIASES: The aliases and disguised records of the
+ *   namespace, which are resolved away when compiling and are only
+ *   needed to compile other namespaces including this one.  See
+ *   #AliasEntry.
+ * @GI_SECTION_FIELD_OFFSETS: The offsets of the fields of the
+ *   containers whose fields do not all have the same size.  See
+ *   #FieldOffsetsEntry.
  *
  * TODO
  */
 typedef enum {
   GI_SECTION_END = 0,
-  GI_SECTION_DIRECTORY_INDEX = 1
+  GI_SECTION_DIRECTORY_INDEX = 1,
+  GI_SECTION_GTYPE_INDEX = 2,
+  GI_SECTION_MEMBER_INDEX = 3,
+  GI_SECTION_ALIASES = 4,
+  GI_SECTION_FIELD_OFFSETS = 5
 } SectionType;
 
 /**
@@ -303,15 +364,91 @@ typedef enum {
  * @offset: Integer offset for this section
  *
  * A section is a blob of data that's (at least theoretically) optional,
- * and may or may not be present in the typelib.  Presently, just used
- * for the directory index.  This allows a form of dynamic extensibility
- * with different tradeoffs from the format minor version.
+ * and may or may not be present in the typelib.  Presently used for
+ * the directory index and the GType name index.  This allows a form of
+ * dynamic extensibility with different tradeoffs from the format minor
+ * version.
  */
 typedef struct {
   guint32 id;
   guint32 offset;
 } Section;
 
+/**
+ * MemberIndexKind:
+ * @GI_MEMBER_INDEX_METHODS: The methods (functions) of a container
+ * @GI_MEMBER_INDEX_SIGNALS: The signals of an object or interface
+ * @GI_MEMBER_INDEX_VFUNCS: The virtual functions of an object or interface
+ *
+ * The kinds of members which can be looked up through the member index.
+ */
+typedef enum {
+  GI_MEMBER_INDEX_METHODS,
+  GI_MEMBER_INDEX_SIGNALS,
+  GI_MEMBER_INDEX_VFUNCS
+} MemberIndexKind;
+
+/**
+ * MemberIndexEntry:
+ * @blob: Offset of the container blob (object, interface, struct, boxed
+ *   or union) in the typelib.
+ * @methods: Offset of the method name hash, or 0.
+ * @signals: Offset of the signal name hash, or 0.
+ * @vfuncs: Offset of the virtual function name hash, or 0.
+ *
+ * The member index section starts with a guint32 holding the number of
+ * entries, followed by the #MemberIndexEntry array sorted by @blob.  Each
+ * hash starts with a guint32 holding the number of hashed names, followed
+ * by the perfect hash mapping a member name to its index within the
+ * container.  Only containers with many members are indexed; lookups of
+ * all the others fall back to a linear search.
+ */
+typedef struct {
+  guint32 blob;
+  guint32 methods;
+  guint32 signals;
+  guint32 vfuncs;
+} MemberIndexEntry;
+
+/**
+ * FieldOffsetsEntry:
+ * @blob: Offset of the container blob (object, struct or boxed) in the
+ *   typelib.
+ * @offsets: Offset of the field offset table of the container.
+ *
+ * A #FieldBlob is followed by a #CallbackBlob when the field has an
+ * embedded type, so the fields of a container can only be located by
+ * walking them, as can the members following them.  The field offset
+ * section starts with a guint32 holding the number of entries,
+ * followed by the #FieldOffsetsEntry array sorted by @blob.  Each table
+ * holds n_fields + 1 guint32 offsets: the offset of every field blob,
+ * then the offset just past the last field.  Containers without
+ * embedded types have no entry, their fields are found by multiplying
+ * with the field blob size.  The compiler writes the section even when
+ * it has no entries.
+ */
+typedef struct {
+  guint32 blob;
+  guint32 offsets;
+} FieldOffsetsEntry;
+
+/**
+ * AliasEntry:
+ * @name: The name of the alias, qualified with its namespace.
+ * @target: The aliased type, as written in the GIR.
+ *
+ * The alias section starts with a guint32 holding the number of
+ * aliases and a guint32 holding the number of disguised records.  They
+ * are followed by the #AliasEntry array and then by the offsets of the
+ * qualified names of the disguised records.  All names are offsets of
+ * strings stored in the section itself, and both lists are sorted by
+ * name.
+ */
+typedef struct {
+  guint32 name;
+  guint32 target;
+} AliasEntry;
+
 
 /**
  * DirEntry:
@@ -1200,6 +1337,10 @@ struct _GITypelib {
   GMappedFile *mfile;
   GList *modules;
   gboolean open_attempted;
+  gsize *gtypes; /* resolved GTypes of the local entries, see _g_typelib_get_gtype_slot() */
+  GMutex symbols_lock;
+  GHashTable *symbols; /* symbol name -> address, filled by g_typelib_symbol() */
+  struct _GITypelibSymbolTable *symbol_table; /* see _g_typelib_resolve_symbols() */
 };
 
 DirEntry *g_typelib_get_dir_entry (GITypelib *typelib,
@@ -1214,8 +1355,26 @@ DirEntry *g_typelib_get_dir_entry_by_gtype_name (GITypelib *typelib,
 DirEntry *g_typelib_get_dir_entry_by_error_domain (GITypelib *typelib,
 						   GQuark     error_domain);
 
-gboolean  g_typelib_matches_gtype_name_prefix (GITypelib *typelib,
-					       const gchar *gtype_name);
+gboolean  g_typelib_lookup_member (GITypelib       *typelib,
+				   guint32          blob_offset,
+				   MemberIndexKind  kind,
+				   const gchar     *name,
+				   guint16         *index);
+
+gboolean  _g_typelib_symbol_at (GITypelib *typelib,
+				guint32    name,
+				gpointer  *symbol);
+
+guint     _g_typelib_resolve_symbols (GITypelib     *typelib,
+				      const guint32 *names,
+				      guint          n_names);
+
+gsize *   _g_typelib_get_gtype_slot (GITypelib *typelib,
+				     guint32    blob_offset);
+
+gboolean  g_typelib_lookup_field_offsets (GITypelib      *typelib,
+					  guint32         blob_offset,
+					  const guint32 **offsets);
 
 
 GI_AVAILABLE_IN_ALL
@@ -1266,6 +1425,29 @@ GI_AVAILABLE_IN_ALL
 gboolean g_typelib_validate (GITypelib  *typelib,
 			     GError    **error);
 
+/**
+ * GITypelibValidateFlags:
+ * @G_TYPELIB_VALIDATE_PARALLEL: Validate the directory entries using a
+ *   thread pool.
+ * @G_TYPELIB_VALIDATE_STAMP: Skip validation if the same content was
+ *   validated before, and remember successful validations.  The stamps
+ *   are kept in the user cache directory, keyed on a hash of the data.
+ *   Hashing costs about as much as the checks it skips, so this is
+ *   only meant for runtime loaders validating the same installed
+ *   typelibs repeatedly, not for tools checking freshly built ones.
+ *
+ * Flags for g_typelib_validate_full().
+ */
+typedef enum {
+  G_TYPELIB_VALIDATE_PARALLEL = 1 << 0,
+  G_TYPELIB_VALIDATE_STAMP    = 1 << 1
+} GITypelibValidateFlags;
+
+GI_AVAILABLE_IN_1_46
+gboolean g_typelib_validate_full (GITypelib              *typelib,
+				  GITypelibValidateFlags  flags,
+				  GError                **error);
+
 
 /* defined in gibaseinfo.c */
 AttributeBlob *_attribute_blob_find_first (GIBaseInfo *info,
@@ -229,8 +229,38 @@ g_typelib_get_dir_entry_by_gtype_name (GITypelib *typelib,
 				       const gchar *gtype_name)
 {
   Header *header = (Header *)typelib->data;
+  Section *gtindex;
   guint i;
 
+  gtindex = get_section_by_id (typelib, GI_SECTION_GTYPE_INDEX);
+  if (gtindex != NULL)
+    {
+      guint32 n_gtypes = *((guint32 *) &typelib->data[gtindex->offset]);
+      guint8 *hash = (guint8*) &typelib->data[gtindex->offset + sizeof (guint32)];
+      RegisteredTypeBlob *blob;
+      DirEntry *entry;
+      guint16 index;
+
+      if (n_gtypes == 0)
+	return NULL;
+
+      index = _gi_typelib_hash_search (hash, gtype_name, n_gtypes);
+      if (index >= header->n_local_entries)
+	return NULL;
+
+      entry = g_typelib_get_dir_entry (typelib, index + 1);
+      if (!BLOB_IS_REGISTERED_TYPE (entry))
+	return NULL;
+
+      blob = (RegisteredTypeBlob *)(&typelib->data[entry->offset]);
+      if (!blob->gtype_name)
+	return NULL;
+
+      if (strcmp (g_typelib_get_string (typelib, blob->gtype_name), gtype_name) == 0)
+	return entry;
+      return NULL;
+    }
+
   for (i = 1; i <= header->n_local_entries; i++)
     {
       RegisteredTypeBlob *blob;
@@ -250,117 +280,194 @@ g_typelib_get_dir_entry_by_gtype_name (GITypelib *typelib,
   return NULL;
 }
 
-typedef struct {
-  const char *s;
-  const char *separator;
-  gsize sep_len;
-  GString buf;
-} StrSplitIter;
-
-static void
-strsplit_iter_init (StrSplitIter  *iter,
-                    const char    *s,
-                    const char    *separator)
+/**
+ * g_typelib_lookup_member:
+ * @typelib: a #GITypelib
+ * @blob_offset: offset of the container blob
+ * @kind: which kind of member to look up
+ * @name: name of the member
+ * @index: (out): return location for the candidate member index
+ *
+ * Looks up @name in the member index of the container at @blob_offset.
+ * Since the index is a perfect hash over the known names only, the
+ * member at @index must still be compared against @name by the caller.
+ *
+ * Returns: %FALSE if the typelib has no index for these members, in
+ *   which case the caller has to search linearly
+ */
+gboolean
+g_typelib_lookup_member (GITypelib       *typelib,
+			 guint32          blob_offset,
+			 MemberIndexKind  kind,
+			 const gchar     *name,
+			 guint16         *index)
 {
-  iter->s = s;
-  iter->separator = separator;
-  iter->sep_len = strlen (separator);
-  iter->buf.str = NULL;
-  iter->buf.len = 0;
-  iter->buf.allocated_len = 0;
-}
+  Section *section;
+  MemberIndexEntry *entries;
+  MemberIndexEntry *entry = NULL;
+  guint32 n_entries;
+  guint32 hash_offset;
+  guint32 n_names;
+  guint lo, hi;
+
+  section = get_section_by_id (typelib, GI_SECTION_MEMBER_INDEX);
+  if (section == NULL)
+    return FALSE;
 
-static gboolean
-strsplit_iter_next (StrSplitIter  *iter,
-                    char         **out_val)
-{
-  const char *s = iter->s;
-  const char *next;
-  gsize len;
+  n_entries = *((guint32 *) &typelib->data[section->offset]);
+  entries = (MemberIndexEntry *) &typelib->data[section->offset + sizeof (guint32)];
 
-  if (!s)
-    return FALSE;
-  next = strstr (s, iter->separator);
-  if (next)
+  lo = 0;
+  hi = n_entries;
+  while (lo < hi)
     {
-      iter->s = next + iter->sep_len;
-      len = next - s;
+      guint mid = lo + (hi - lo) / 2;
+
+      if (entries[mid].blob < blob_offset)
+	lo = mid + 1;
+      else if (entries[mid].blob > blob_offset)
+	hi = mid;
+      else
+	{
+	  entry = &entries[mid];
+	  break;
+	}
     }
-  else
+
+  if (entry == NULL)
+    return FALSE;
+
+  switch (kind)
     {
-      iter->s = NULL;
-      len = strlen (s);
+    case GI_MEMBER_INDEX_METHODS:
+      hash_offset = entry->methods;
+      break;
+    case GI_MEMBER_INDEX_SIGNALS:
+      hash_offset = entry->signals;
+      break;
+    case GI_MEMBER_INDEX_VFUNCS:
+      hash_offset = entry->vfuncs;
+      break;
+    default:
+      g_assert_not_reached ();
+      return FALSE;
     }
-  if (len == 0)
+
+  if (hash_offset == 0)
+    return FALSE;
+
+  n_names = *((guint32 *) &typelib->data[hash_offset]);
+  *index = _gi_typelib_hash_search (&typelib->data[hash_offset + sizeof (guint32)],
+				    name, n_names);
+  return TRUE;
+}
+
+/**
+ * _g_typelib_get_gtype_slot:
+ * @typelib: a #GITypelib
+ * @blob_offset: Offset of a registered type blob
+ *
+ * Returns the location where the #GType of the local entry at
+ * @blob_offset is cached, holding 0 until it is resolved.  The table is
+ * allocated on first use and owned by @typelib; its slots are accessed
+ * atomically, as they are read and written without a lock.
+ *
+ * Returns: the cache slot, or %NULL if @blob_offset is not the offset
+ *   of a local directory entry
+ */
+gsize *
+_g_typelib_get_gtype_slot (GITypelib *typelib,
+			   guint32    blob_offset)
+{
+  Header *header = (Header *)typelib->data;
+  gsize *gtypes;
+  guint lo, hi, mid;
+
+  /* Blobs are written in directory order */
+  lo = 0;
+  hi = header->n_local_entries;
+  while (lo < hi)
     {
-      *out_val = "";
+      DirEntry *entry;
+
+      mid = lo + (hi - lo) / 2;
+      entry = g_typelib_get_dir_entry (typelib, mid + 1);
+
+      if (entry->offset < blob_offset)
+	lo = mid + 1;
+      else if (entry->offset > blob_offset)
+	hi = mid;
+      else
+	break;
     }
-  else
+
+  if (lo >= hi)
+    return NULL;
+
+  gtypes = g_atomic_pointer_get (&typelib->gtypes);
+  if (gtypes == NULL)
     {
-      g_string_overwrite_len (&iter->buf, 0, s, (gssize)len);
-      *out_val = iter->buf.str;
+      gtypes = g_new0 (gsize, header->n_local_entries);
+      if (!g_atomic_pointer_compare_and_exchange (&typelib->gtypes, NULL, gtypes))
+	{
+	  g_free (gtypes);
+	  gtypes = g_atomic_pointer_get (&typelib->gtypes);
+	}
     }
-  return TRUE;
-}
 
-static void
-strsplit_iter_clear (StrSplitIter  *iter)
-{
-  g_free (iter->buf.str);
+  return &gtypes[mid];
 }
 
 /**
- * g_typelib_matches_gtype_name_prefix:
- * @typelib: TODO
- * @gtype_name: TODO
+ * g_typelib_lookup_field_offsets:
+ * @typelib: a #GITypelib
+ * @blob_offset: Offset of an object, struct or boxed blob
+ * @offsets: (out): Location for the field offset table of the
+ *   container, set to %NULL if its fields all have the same size
  *
- * TODO
+ * Looks up the offsets of the fields of a container in the field
+ * offset section, see #FieldOffsetsEntry.
  *
- * Returns: TODO
+ * Returns: %FALSE if the typelib has no field offset section, in which
+ *   case the caller has to walk the fields
  */
 gboolean
-g_typelib_matches_gtype_name_prefix (GITypelib *typelib,
-				     const gchar *gtype_name)
+g_typelib_lookup_field_offsets (GITypelib      *typelib,
+				guint32         blob_offset,
+				const guint32 **offsets)
 {
-  Header *header = (Header *)typelib->data;
-  const char *c_prefix;
-  gchar *prefix;
-  gboolean ret = FALSE;
-  StrSplitIter split_iter;
-  gsize gtype_name_len;
+  Section *section;
+  FieldOffsetsEntry *entries;
+  guint32 n_entries;
+  guint lo, hi;
 
-  c_prefix = g_typelib_get_string (typelib, header->c_prefix);
-  if (c_prefix == NULL || strlen (c_prefix) == 0)
+  section = get_section_by_id (typelib, GI_SECTION_FIELD_OFFSETS);
+  if (section == NULL)
     return FALSE;
 
-  gtype_name_len = strlen (gtype_name);
-
-  /* c_prefix is a comma separated string of supported prefixes
-   * in the typelib.
-   * We match the specified gtype_name if the gtype_name starts
-   * with the prefix, and is followed by a capital letter.
-   * For example, a typelib offering the 'Gdk' prefix does match
-   * GdkX11Cursor, however a typelib offering the 'G' prefix does not.
-   */
-  strsplit_iter_init (&split_iter, c_prefix, ",");
-  while (strsplit_iter_next (&split_iter, &prefix))
-    {
-      size_t len = strlen (prefix);
+  n_entries = *((guint32 *) &typelib->data[section->offset]);
+  entries = (FieldOffsetsEntry *) &typelib->data[section->offset + sizeof (guint32)];
 
-      if (gtype_name_len < len)
-        continue;
+  *offsets = NULL;
 
-      if (strncmp (prefix, gtype_name, len) != 0)
-        continue;
+  lo = 0;
+  hi = n_entries;
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
 
-      if (g_ascii_isupper (gtype_name[len]))
-        {
-          ret = TRUE;
-          break;
-        }
+      if (entries[mid].blob < blob_offset)
+	lo = mid + 1;
+      else if (entries[mid].blob > blob_offset)
+	hi = mid;
+      else
+	{
+	  *offsets = (const guint32 *) &typelib->data[entries[mid].offsets];
+	  break;
+	}
     }
-  strsplit_iter_clear (&split_iter);
-  return ret;
+
+  return TRUE;
 }
 
 /**
@@ -455,6 +562,9 @@ g_typelib_check_sanity (void)
   CHECK_SIZE (ConstantBlob, 24);
   CHECK_SIZE (AttributeBlob, 12);
   CHECK_SIZE (UnionBlob, 40);
+  CHECK_SIZE (BundleHeader, 32);
+  CHECK_SIZE (BundleEntry, 16);
+  CHECK_SIZE (AliasEntry, 8);
 #undef CHECK_SIZE
 
   g_assert (size_check_ok);
@@ -2024,90 +2134,77 @@ validate_blob (ValidateContext *ctx,
 }
 
 static gboolean
-validate_directory (ValidateContext   *ctx,
-		    GError            **error)
+validate_directory_entry (ValidateContext *ctx,
+			  gint             i,
+			  GError         **error)
 {
   GITypelib *typelib = ctx->typelib;
   Header *header = (Header *)typelib->data;
   DirEntry *entry;
-  gint i;
 
-  if (typelib->len < header->directory + header->n_entries * sizeof (DirEntry))
+  entry = g_typelib_get_dir_entry (typelib, i + 1);
+
+  if (!validate_name (typelib, "entry", typelib->data, entry->name, error))
+    return FALSE;
+
+  if ((entry->local && entry->blob_type == BLOB_TYPE_INVALID) ||
+      entry->blob_type > BLOB_TYPE_UNION)
     {
       g_set_error (error,
 		   G_TYPELIB_ERROR,
-		   G_TYPELIB_ERROR_INVALID,
-		   "The buffer is too short");
+		   G_TYPELIB_ERROR_INVALID_DIRECTORY,
+		   "Invalid entry type");
       return FALSE;
     }
 
-  for (i = 0; i < header->n_entries; i++)
+  if (i < header->n_local_entries)
     {
-      entry = g_typelib_get_dir_entry (typelib, i + 1);
-
-      if (!validate_name (typelib, "entry", typelib->data, entry->name, error))
-	return FALSE;
-
-      if ((entry->local && entry->blob_type == BLOB_TYPE_INVALID) ||
-	  entry->blob_type > BLOB_TYPE_UNION)
+      if (!entry->local)
 	{
 	  g_set_error (error,
 		       G_TYPELIB_ERROR,
 		       G_TYPELIB_ERROR_INVALID_DIRECTORY,
-		       "Invalid entry type");
+		       "Too few local directory entries");
 	  return FALSE;
 	}
 
-      if (i < header->n_local_entries)
+      if (!is_aligned (entry->offset))
 	{
-	  if (!entry->local)
-	    {
-	      g_set_error (error,
-			   G_TYPELIB_ERROR,
-			   G_TYPELIB_ERROR_INVALID_DIRECTORY,
-			   "Too few local directory entries");
-	      return FALSE;
-	    }
-
-	  if (!is_aligned (entry->offset))
-	    {
-	      g_set_error (error,
-			   G_TYPELIB_ERROR,
-			   G_TYPELIB_ERROR_INVALID_DIRECTORY,
-			   "Misaligned entry");
-	      return FALSE;
-	    }
-
-	  if (!validate_blob (ctx, entry->offset, error))
-	    return FALSE;
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID_DIRECTORY,
+		       "Misaligned entry");
+	  return FALSE;
 	}
-      else
-	{
-	  if (entry->local)
-	    {
-	      g_set_error (error,
-			   G_TYPELIB_ERROR,
-			   G_TYPELIB_ERROR_INVALID_DIRECTORY,
-			   "Too many local directory entries");
-	      return FALSE;
-	    }
 
-	  if (!validate_name (typelib, "namespace", typelib->data, entry->offset, error))
-	    return FALSE;
+      if (!validate_blob (ctx, entry->offset, error))
+	return FALSE;
+    }
+  else
+    {
+      if (entry->local)
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID_DIRECTORY,
+		       "Too many local directory entries");
+	  return FALSE;
 	}
+
+      if (!validate_name (typelib, "namespace", typelib->data, entry->offset, error))
+	return FALSE;
     }
 
   return TRUE;
 }
 
 static gboolean
-validate_attributes (ValidateContext *ctx,
-		     GError       **error)
+validate_directory_size (GITypelib *typelib,
+			 GError   **error)
 {
-  GITypelib *typelib = ctx->typelib;
   Header *header = (Header *)typelib->data;
 
-  if (header->size < header->attributes + header->n_attributes * sizeof (AttributeBlob))
+  if (typelib->len < header->directory + header->n_entries * sizeof (DirEntry))
     {
       g_set_error (error,
 		   G_TYPELIB_ERROR,
@@ -2119,89 +2216,664 @@ validate_attributes (ValidateContext *ctx,
   return TRUE;
 }
 
-static void
-prefix_with_context (GError **error,
-		     const char *section,
-		     ValidateContext *ctx)
+static gboolean
+validate_directory (ValidateContext   *ctx,
+		    GError            **error)
 {
-  GString *str = g_string_new (NULL);
-  GSList *link;
-  char *buf;
+  Header *header = (Header *)ctx->typelib->data;
+  gint i;
 
-  link = ctx->context_stack;
-  if (!link)
-    {
-      g_prefix_error (error, "In %s:", section);
-      return;
-    }
+  if (!validate_directory_size (ctx->typelib, error))
+    return FALSE;
 
-  for (; link; link = link->next)
+  for (i = 0; i < header->n_entries; i++)
     {
-      g_string_append (str, link->data);
-      if (link->next)
-	g_string_append_c (str, '/');
+      if (!validate_directory_entry (ctx, i, error))
+	return FALSE;
     }
-  g_string_append_c (str, ')');
-  buf = g_string_free (str, FALSE);
-  g_prefix_error (error, "In %s (Context: %s): ", section, buf);
-  g_free (buf);
+
+  return TRUE;
 }
 
-/**
- * g_typelib_validate:
- * @typelib: TODO
- * @error: TODO
- *
- * TODO
- *
- * Returns: TODO
- */
-gboolean
-g_typelib_validate (GITypelib     *typelib,
+static gboolean
+validate_attributes (ValidateContext *ctx,
 		     GError       **error)
 {
-  ValidateContext ctx;
-  ctx.typelib = typelib;
-  ctx.context_stack = NULL;
+  GITypelib *typelib = ctx->typelib;
+  Header *header = (Header *)typelib->data;
 
-  if (!validate_header (&ctx, error))
+  if (header->size < header->attributes + header->n_attributes * sizeof (AttributeBlob))
     {
-      prefix_with_context (error, "In header", &ctx);
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
       return FALSE;
     }
 
-  if (!validate_directory (&ctx, error))
-    {
-      prefix_with_context (error, "directory", &ctx);
-      return FALSE;
-    }
+  return TRUE;
+}
 
-  if (!validate_attributes (&ctx, error))
+/* Walks the @n_fields fields from @offset.  If @offsets is not %NULL,
+ * it must hold the offset of each field followed by the end offset. */
+static gboolean
+validate_field_walk (GITypelib     *typelib,
+		     guint32        offset,
+		     guint          n_fields,
+		     const guint32 *offsets,
+		     gboolean      *has_embedded_types,
+		     GError       **error)
+{
+  guint i;
+
+  *has_embedded_types = FALSE;
+
+  for (i = 0; i <= n_fields; i++)
     {
-      prefix_with_context (error, "attributes", &ctx);
-      return FALSE;
+      FieldBlob *blob;
+
+      if (offsets != NULL && offsets[i] != offset)
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "Wrong offset for field %u", i);
+	  return FALSE;
+	}
+
+      if (i == n_fields)
+	break;
+
+      if (typelib->len < offset + sizeof (FieldBlob))
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "The buffer is too short");
+	  return FALSE;
+	}
+
+      blob = (FieldBlob *)&typelib->data[offset];
+      offset += sizeof (FieldBlob);
+      if (blob->has_embedded_type)
+	{
+	  offset += sizeof (CallbackBlob);
+	  *has_embedded_types = TRUE;
+	}
     }
 
   return TRUE;
 }
 
-/**
- * g_typelib_error_quark:
- *
- * TODO
- *
- * Returns: TODO
- */
-GQuark
-g_typelib_error_quark (void)
+/* Finds the fields of the object, struct or boxed blob at @offset,
+ * returns %FALSE for other blobs */
+static gboolean
+get_container_fields (GITypelib *typelib,
+		      guint32    offset,
+		      guint32   *first_field,
+		      guint     *n_fields)
 {
-  static GQuark quark = 0;
-  if (quark == 0)
-    quark = g_quark_from_static_string ("g-typelib-error-quark");
-  return quark;
-}
+  CommonBlob *common = (CommonBlob *)&typelib->data[offset];
 
-static GSList *library_paths;
+  switch (common->blob_type)
+    {
+    case BLOB_TYPE_OBJECT:
+      {
+	ObjectBlob *blob = (ObjectBlob *)common;
+
+	if (typelib->len < offset + sizeof (ObjectBlob))
+	  return FALSE;
+	*first_field = offset + sizeof (ObjectBlob)
+	  + (blob->n_interfaces + blob->n_interfaces % 2) * 2;
+	*n_fields = blob->n_fields;
+	return TRUE;
+      }
+    case BLOB_TYPE_STRUCT:
+    case BLOB_TYPE_BOXED:
+      {
+	StructBlob *blob = (StructBlob *)common;
+
+	if (typelib->len < offset + sizeof (StructBlob))
+	  return FALSE;
+	*first_field = offset + sizeof (StructBlob);
+	*n_fields = blob->n_fields;
+	return TRUE;
+      }
+    default:
+      return FALSE;
+    }
+}
+
+/* The field offset tables are used instead of walking the fields, see
+ * #FieldOffsetsEntry.  Each must match the fields of its container,
+ * and every container with embedded types must have one. */
+static gboolean
+validate_field_offsets (ValidateContext *ctx,
+			GError         **error)
+{
+  GITypelib *typelib = ctx->typelib;
+  Header *header = (Header *)typelib->data;
+  Section *section;
+  FieldOffsetsEntry *entries;
+  guint32 n_entries, i;
+  gboolean has_embedded_types;
+
+  section = get_section_by_id (typelib, GI_SECTION_FIELD_OFFSETS);
+  if (section == NULL)
+    return TRUE;
+
+  if (typelib->len < section->offset + sizeof (guint32))
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  n_entries = *((guint32 *) &typelib->data[section->offset]);
+  if (typelib->len < section->offset + sizeof (guint32) +
+      (gsize) n_entries * sizeof (FieldOffsetsEntry))
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  entries = (FieldOffsetsEntry *) &typelib->data[section->offset + sizeof (guint32)];
+
+  for (i = 0; i < n_entries; i++)
+    {
+      guint32 first_field;
+      guint n_fields;
+
+      if (i > 0 && entries[i].blob <= entries[i - 1].blob)
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "Field offset entries not sorted");
+	  return FALSE;
+	}
+
+      if (typelib->len < entries[i].blob + sizeof (CommonBlob) ||
+	  !get_container_fields (typelib, entries[i].blob, &first_field, &n_fields))
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "Field offset entry not for a container");
+	  return FALSE;
+	}
+
+      if (typelib->len < entries[i].offsets + (n_fields + 1) * sizeof (guint32))
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "The buffer is too short");
+	  return FALSE;
+	}
+
+      if (!validate_field_walk (typelib, first_field, n_fields,
+				(const guint32 *) &typelib->data[entries[i].offsets],
+				&has_embedded_types, error))
+	return FALSE;
+    }
+
+  /* The directory is valid at this point */
+  for (i = 1; i <= header->n_local_entries; i++)
+    {
+      DirEntry *entry = g_typelib_get_dir_entry (typelib, i);
+      const guint32 *offsets;
+      guint32 first_field;
+      guint n_fields;
+
+      if (!get_container_fields (typelib, entry->offset, &first_field, &n_fields))
+	continue;
+
+      g_typelib_lookup_field_offsets (typelib, entry->offset, &offsets);
+      if (offsets != NULL)
+	continue;
+
+      if (!validate_field_walk (typelib, first_field, n_fields, NULL,
+				&has_embedded_types, error))
+	return FALSE;
+
+      if (has_embedded_types)
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "No field offsets for %s",
+		       get_string_nofail (typelib, entry->name));
+	  return FALSE;
+	}
+    }
+
+  return TRUE;
+}
+
+/* Checks the member name hash at @offset, which must follow the
+ * entries ending at @entries_end */
+static gboolean
+validate_member_hash (GITypelib *typelib,
+		      guint32    offset,
+		      guint32    entries_end,
+		      GError   **error)
+{
+  guint32 n_names, dirmap_offset;
+
+  if (offset == 0)
+    return TRUE;
+
+  if (offset < entries_end || offset % 4 != 0)
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "Misplaced member hash");
+      return FALSE;
+    }
+
+  if (typelib->len < (gsize) offset + 2 * sizeof (guint32))
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  /* The hash is followed by the table of member indices */
+  n_names = *((guint32 *) &typelib->data[offset]);
+  dirmap_offset = *((guint32 *) &typelib->data[offset + sizeof (guint32)]);
+  if (n_names == 0 ||
+      typelib->len < (gsize) offset + sizeof (guint32) + dirmap_offset +
+      (gsize) n_names * sizeof (guint16))
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* See #MemberIndexEntry.  The hashes themselves can't be checked, but
+ * the member they return is always compared with the name looked up. */
+static gboolean
+validate_member_index (ValidateContext *ctx,
+		       GError         **error)
+{
+  GITypelib *typelib = ctx->typelib;
+  Section *section;
+  MemberIndexEntry *entries;
+  guint32 n_entries, entries_end, i;
+
+  section = get_section_by_id (typelib, GI_SECTION_MEMBER_INDEX);
+  if (section == NULL)
+    return TRUE;
+
+  if (typelib->len < section->offset + sizeof (guint32))
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  n_entries = *((guint32 *) &typelib->data[section->offset]);
+  if (typelib->len < section->offset + sizeof (guint32) +
+      (gsize) n_entries * sizeof (MemberIndexEntry))
+    {
+      g_set_error (error,
+		   G_TYPELIB_ERROR,
+		   G_TYPELIB_ERROR_INVALID,
+		   "The buffer is too short");
+      return FALSE;
+    }
+
+  entries = (MemberIndexEntry *) &typelib->data[section->offset + sizeof (guint32)];
+  entries_end = section->offset + sizeof (guint32) + n_entries * sizeof (MemberIndexEntry);
+
+  for (i = 0; i < n_entries; i++)
+    {
+      CommonBlob *common;
+
+      if (i > 0 && entries[i].blob <= entries[i - 1].blob)
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "Member index entries not sorted");
+	  return FALSE;
+	}
+
+      if (typelib->len < entries[i].blob + sizeof (CommonBlob))
+	{
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "The buffer is too short");
+	  return FALSE;
+	}
+
+      common = (CommonBlob *)&typelib->data[entries[i].blob];
+      switch (common->blob_type)
+	{
+	case BLOB_TYPE_OBJECT:
+	case BLOB_TYPE_INTERFACE:
+	  break;
+	case BLOB_TYPE_STRUCT:
+	case BLOB_TYPE_BOXED:
+	case BLOB_TYPE_UNION:
+	  if (entries[i].signals == 0 && entries[i].vfuncs == 0)
+	    break;
+	  /* fall through */
+	default:
+	  g_set_error (error,
+		       G_TYPELIB_ERROR,
+		       G_TYPELIB_ERROR_INVALID,
+		       "Member index entry not for a container");
+	  return FALSE;
+	}
+
+      if (!validate_member_hash (typelib, entries[i].methods, entries_end, error) ||
+	  !validate_member_hash (typelib, entries[i].signals, entries_end, error) ||
+	  !validate_member_hash (typelib, entries[i].vfuncs, entries_end, error))
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+prefix_with_context (GError **error,
+		     const char *section,
+		     ValidateContext *ctx)
+{
+  GString *str = g_string_new (NULL);
+  GSList *link;
+  char *buf;
+
+  link = ctx->context_stack;
+  if (!link)
+    {
+      g_prefix_error (error, "In %s:", section);
+      return;
+    }
+
+  for (; link; link = link->next)
+    {
+      g_string_append (str, link->data);
+      if (link->next)
+	g_string_append_c (str, '/');
+    }
+  g_string_append_c (str, ')');
+  buf = g_string_free (str, FALSE);
+  g_prefix_error (error, "In %s (Context: %s): ", section, buf);
+  g_free (buf);
+}
+
+/* Typelibs with fewer entries are not worth the thread pool */
+#define PARALLEL_VALIDATE_MIN_ENTRIES 256
+#define PARALLEL_VALIDATE_CHUNKS_PER_THREAD 4
+
+typedef struct {
+  GITypelib *typelib;
+  gint first_failed; /* index of the first failed chunk, atomic */
+} ParallelValidateData;
+
+typedef struct {
+  gint index;
+  gint start;
+  gint end;
+  GError *error;
+} ValidateChunk;
+
+static void
+validate_chunk (gpointer data,
+		gpointer user_data)
+{
+  ValidateChunk *chunk = data;
+  ParallelValidateData *pdata = user_data;
+  ValidateContext ctx;
+  gint i, failed;
+
+  ctx.typelib = pdata->typelib;
+  ctx.context_stack = NULL;
+
+  for (i = chunk->start; i < chunk->end; i++)
+    {
+      /* An error in an earlier chunk is the one which will be reported */
+      if (g_atomic_int_get (&pdata->first_failed) < chunk->index)
+	break;
+
+      if (!validate_directory_entry (&ctx, i, &chunk->error))
+	{
+	  prefix_with_context (&chunk->error, "directory", &ctx);
+	  do
+	    {
+	      failed = g_atomic_int_get (&pdata->first_failed);
+	      if (failed < chunk->index)
+		break;
+	    }
+	  while (!g_atomic_int_compare_and_exchange (&pdata->first_failed,
+						     failed, chunk->index));
+	  break;
+	}
+    }
+
+  g_slist_free (ctx.context_stack);
+}
+
+static gboolean
+validate_directory_parallel (GITypelib *typelib,
+			     GError   **error)
+{
+  Header *header = (Header *)typelib->data;
+  ValidateContext ctx;
+  ParallelValidateData pdata;
+  ValidateChunk *chunks;
+  GThreadPool *pool;
+  gint n_threads, n_chunks, chunk_size, i;
+  gboolean ret = TRUE;
+
+  ctx.typelib = typelib;
+  ctx.context_stack = NULL;
+
+  if (!validate_directory_size (typelib, error))
+    {
+      prefix_with_context (error, "directory", &ctx);
+      return FALSE;
+    }
+
+  n_threads = g_get_num_processors ();
+  n_chunks = MIN (n_threads * PARALLEL_VALIDATE_CHUNKS_PER_THREAD, header->n_entries);
+  chunk_size = (header->n_entries + n_chunks - 1) / n_chunks;
+
+  pdata.typelib = typelib;
+  pdata.first_failed = G_MAXINT;
+
+  pool = g_thread_pool_new (validate_chunk, &pdata, n_threads, FALSE, NULL);
+  chunks = g_new0 (ValidateChunk, n_chunks);
+  for (i = 0; i < n_chunks; i++)
+    {
+      chunks[i].index = i;
+      chunks[i].start = i * chunk_size;
+      chunks[i].end = MIN ((i + 1) * chunk_size, header->n_entries);
+      g_thread_pool_push (pool, &chunks[i], NULL);
+    }
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  for (i = 0; i < n_chunks; i++)
+    {
+      if (chunks[i].error == NULL)
+	continue;
+
+      if (ret)
+	{
+	  g_propagate_error (error, chunks[i].error);
+	  ret = FALSE;
+	}
+      else
+	g_error_free (chunks[i].error);
+    }
+  g_free (chunks);
+
+  return ret;
+}
+
+static gchar *
+get_validated_stamp_path (GITypelib *typelib)
+{
+  gchar *checksum;
+  gchar *path;
+
+  checksum = g_compute_checksum_for_data (G_CHECKSUM_SHA256,
+					  typelib->data, typelib->len);
+  path = g_build_filename (g_get_user_cache_dir (), "gobject-introspection",
+			   "validated-" PACKAGE_VERSION, checksum, NULL);
+  g_free (checksum);
+
+  return path;
+}
+
+static void
+write_validated_stamp (const gchar *path)
+{
+  gchar *dir;
+
+  /* Failing to record the stamp only costs another validation */
+  dir = g_path_get_dirname (path);
+  if (g_mkdir_with_parents (dir, 0755) == 0)
+    g_file_set_contents (path, "", 0, NULL);
+  g_free (dir);
+}
+
+/**
+ * g_typelib_validate_full:
+ * @typelib: a #GITypelib
+ * @flags: a set of #GITypelibValidateFlags
+ * @error: a #GError
+ *
+ * Checks that @typelib is well-formed, like g_typelib_validate().
+ * The directory entries, which are independent once the header and
+ * the directory itself have been checked, can be validated in
+ * parallel, and validation of data seen before can be skipped.
+ *
+ * Returns: %TRUE if @typelib is valid
+ *
+ * Since: 1.46
+ */
+gboolean
+g_typelib_validate_full (GITypelib              *typelib,
+			 GITypelibValidateFlags  flags,
+			 GError                **error)
+{
+  ValidateContext ctx;
+  Header *header;
+  gchar *stamp_path = NULL;
+  gboolean ret = FALSE;
+
+  if (flags & G_TYPELIB_VALIDATE_STAMP)
+    {
+      stamp_path = get_validated_stamp_path (typelib);
+      if (g_file_test (stamp_path, G_FILE_TEST_EXISTS))
+	{
+	  g_free (stamp_path);
+	  return TRUE;
+	}
+    }
+
+  ctx.typelib = typelib;
+  ctx.context_stack = NULL;
+
+  if (!validate_header (&ctx, error))
+    {
+      prefix_with_context (error, "In header", &ctx);
+      goto out;
+    }
+
+  header = (Header *)typelib->data;
+  if ((flags & G_TYPELIB_VALIDATE_PARALLEL) &&
+      header->n_entries >= PARALLEL_VALIDATE_MIN_ENTRIES)
+    {
+      if (!validate_directory_parallel (typelib, error))
+	goto out;
+    }
+  else if (!validate_directory (&ctx, error))
+    {
+      prefix_with_context (error, "directory", &ctx);
+      goto out;
+    }
+
+  if (!validate_attributes (&ctx, error))
+    {
+      prefix_with_context (error, "attributes", &ctx);
+      goto out;
+    }
+
+  if (!validate_field_offsets (&ctx, error))
+    {
+      prefix_with_context (error, "field offsets", &ctx);
+      goto out;
+    }
+
+  if (!validate_member_index (&ctx, error))
+    {
+      prefix_with_context (error, "member index", &ctx);
+      goto out;
+    }
+
+  if (stamp_path != NULL)
+    write_validated_stamp (stamp_path);
+
+  ret = TRUE;
+ out:
+  g_free (stamp_path);
+  return ret;
+}
+
+/**
+ * g_typelib_validate:
+ * @typelib: TODO
+ * @error: TODO
+ *
+ * TODO
+ *
+ * Returns: TODO
+ */
+gboolean
+g_typelib_validate (GITypelib     *typelib,
+		     GError       **error)
+{
+  return g_typelib_validate_full (typelib, 0, error);
+}
+
+/**
+ * g_typelib_error_quark:
+ *
+ * TODO
+ *
+ * Returns: TODO
+ */
+GQuark
+g_typelib_error_quark (void)
+{
+  static GQuark quark = 0;
+  if (quark == 0)
+    quark = g_quark_from_static_string ("g-typelib-error-quark");
+  return quark;
+}
+
+static GSList *library_paths;
 
 /**
  * g_irepository_prepend_library_path:
@@ -2329,12 +3001,27 @@ _g_typelib_do_dlopen (GITypelib *typelib)
 static inline void
 _g_typelib_ensure_open (GITypelib *typelib)
 {
-  if (typelib->open_attempted)
+  static GMutex open_lock;
+
+  if (g_atomic_int_get (&typelib->open_attempted))
     return;
-  typelib->open_attempted = TRUE;
-  _g_typelib_do_dlopen (typelib);
+
+  /* Symbols may be looked up from several threads at once */
+  g_mutex_lock (&open_lock);
+  if (!typelib->open_attempted)
+    {
+      _g_typelib_do_dlopen (typelib);
+      g_atomic_int_set (&typelib->open_attempted, TRUE);
+    }
+  g_mutex_unlock (&open_lock);
 }
 
+struct _GITypelibSymbolTable {
+  guint n_symbols;
+  guint32 *names;      /* string offsets, sorted */
+  gpointer *addresses; /* NULL for symbols that were not found */
+};
+
 /**
  * g_typelib_new_from_memory: (skip)
  * @memory: address of memory chunk containing the typelib
@@ -2362,6 +3049,7 @@ g_typelib_new_from_memory (guint8  *memory,
   meta->len = len;
   meta->owns_memory = TRUE;
   meta->modules = NULL;
+  g_mutex_init (&meta->symbols_lock);
 
   return meta;
 }
@@ -2391,6 +3079,7 @@ g_typelib_new_from_const_memory (const guchar *memory,
   meta->len = len;
   meta->owns_memory = FALSE;
   meta->modules = NULL;
+  g_mutex_init (&meta->symbols_lock);
 
   return meta;
 }
@@ -2420,6 +3109,7 @@ g_typelib_new_from_mapped_file (GMappedFile  *mfile,
   meta->owns_memory = FALSE;
   meta->data = data; 
   meta->len = len;
+  g_mutex_init (&meta->symbols_lock);
 
   return meta;
 }
@@ -2443,6 +3133,16 @@ g_typelib_free (GITypelib *typelib)
       g_list_foreach (typelib->modules, (GFunc) g_module_close, NULL);
       g_list_free (typelib->modules);
     }
+  g_free (typelib->gtypes);
+  if (typelib->symbols)
+    g_hash_table_unref (typelib->symbols);
+  if (typelib->symbol_table)
+    {
+      g_free (typelib->symbol_table->names);
+      g_free (typelib->symbol_table->addresses);
+      g_free (typelib->symbol_table);
+    }
+  g_mutex_clear (&typelib->symbols_lock);
   g_slice_free (GITypelib, typelib);
 }
 
@@ -2466,7 +3166,9 @@ g_typelib_get_namespace (GITypelib *typelib)
  * @symbol_name: name of symbol to be loaded
  * @symbol: returns a pointer to the symbol value
  *
- * Loads a symbol from #GITypelib.
+ * Loads a symbol from #GITypelib.  Symbols that are found are cached
+ * with the typelib, so that they are only looked up once in its shared
+ * libraries.
  *
  * Returns: #TRUE on success
  */
@@ -2474,6 +3176,14 @@ gboolean
 g_typelib_symbol (GITypelib *typelib, const char *symbol_name, gpointer *symbol)
 {
   GList *l;
+  gboolean found;
+
+  g_mutex_lock (&typelib->symbols_lock);
+  found = typelib->symbols != NULL &&
+    g_hash_table_lookup_extended (typelib->symbols, symbol_name, NULL, symbol);
+  g_mutex_unlock (&typelib->symbols_lock);
+  if (found)
+    return TRUE;
 
   _g_typelib_ensure_open (typelib);
 
@@ -2493,8 +3203,123 @@ g_typelib_symbol (GITypelib *typelib, const char *symbol_name, gpointer *symbol)
       GModule *module = l->data;
 
       if (g_module_symbol (module, symbol_name, symbol))
-        return TRUE;
+        {
+          /* Failures are not cached, so that g_module_error() stays
+           * meaningful for the callers reporting them */
+          g_mutex_lock (&typelib->symbols_lock);
+          if (typelib->symbols == NULL)
+            typelib->symbols = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                      g_free, NULL);
+          g_hash_table_insert (typelib->symbols, g_strdup (symbol_name), *symbol);
+          g_mutex_unlock (&typelib->symbols_lock);
+          return TRUE;
+        }
     }
 
   return FALSE;
 }
+
+static int
+compare_name_offsets (gconstpointer a,
+                      gconstpointer b)
+{
+  guint32 name_a = *(const guint32 *) a;
+  guint32 name_b = *(const guint32 *) b;
+
+  return name_a < name_b ? -1 : name_a > name_b;
+}
+
+/**
+ * _g_typelib_resolve_symbols:
+ * @typelib: a #GITypelib
+ * @names: string offsets of symbol names
+ * @n_names: number of elements of @names
+ *
+ * Looks up all the symbols named by @names at once, and keeps their
+ * addresses in a table of @typelib which _g_typelib_symbol_at() searches
+ * without taking a lock.  The table can only be built once; later calls
+ * leave it unchanged.
+ *
+ * Returns: the number of distinct symbols found
+ */
+guint
+_g_typelib_resolve_symbols (GITypelib     *typelib,
+                            const guint32 *names,
+                            guint          n_names)
+{
+  struct _GITypelibSymbolTable *table;
+  guint i, n_found;
+
+  table = g_atomic_pointer_get (&typelib->symbol_table);
+  if (table == NULL)
+    {
+      table = g_new0 (struct _GITypelibSymbolTable, 1);
+      table->names = g_memdup (names, n_names * sizeof (guint32));
+      qsort (table->names, n_names, sizeof (guint32), compare_name_offsets);
+
+      /* Strings are shared in the typelib, so the same offset can be
+       * listed several times */
+      for (i = 0; i < n_names; i++)
+        if (table->n_symbols == 0 ||
+            table->names[table->n_symbols - 1] != table->names[i])
+          table->names[table->n_symbols++] = table->names[i];
+
+      table->addresses = g_new0 (gpointer, table->n_symbols);
+      for (i = 0; i < table->n_symbols; i++)
+        if (!g_typelib_symbol (typelib,
+                               g_typelib_get_string (typelib, table->names[i]),
+                               &table->addresses[i]))
+          table->addresses[i] = NULL;
+
+      if (!g_atomic_pointer_compare_and_exchange (&typelib->symbol_table, NULL, table))
+        {
+          g_free (table->names);
+          g_free (table->addresses);
+          g_free (table);
+          table = g_atomic_pointer_get (&typelib->symbol_table);
+        }
+    }
+
+  n_found = 0;
+  for (i = 0; i < table->n_symbols; i++)
+    if (table->addresses[i] != NULL)
+      n_found++;
+
+  return n_found;
+}
+
+/**
+ * _g_typelib_symbol_at:
+ * @typelib: a #GITypelib
+ * @name: string offset of the symbol name
+ * @symbol: returns a pointer to the symbol value
+ *
+ * Like g_typelib_symbol(), but for a symbol named by a string of
+ * @typelib, which is first searched in the table built by
+ * _g_typelib_resolve_symbols().
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+_g_typelib_symbol_at (GITypelib *typelib,
+                      guint32    name,
+                      gpointer  *symbol)
+{
+  struct _GITypelibSymbolTable *table;
+
+  table = g_atomic_pointer_get (&typelib->symbol_table);
+  if (table != NULL)
+    {
+      guint32 *found;
+
+      found = bsearch (&name, table->names, table->n_symbols,
+                       sizeof (guint32), compare_name_offsets);
+      if (found != NULL && table->addresses[found - table->names] != NULL)
+        {
+          *symbol = table->addresses[found - table->names];
+          return TRUE;
+        }
+    }
+
+  return g_typelib_symbol (typelib, g_typelib_get_string (typelib, name), symbol);
+}
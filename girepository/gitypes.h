@@ -197,6 +197,17 @@ typedef GIBaseInfo GITypeInfo;
  */
 typedef struct _GIUnresolvedInfo GIUnresolvedInfo;
 
+/**
+ * GIPreparedCallable:
+ *
+ * An opaque structure holding the libffi call interface and the
+ * argument layout of a #GICallableInfo, so that it can be invoked
+ * repeatedly without inspecting the typelib again.
+ *
+ * Since: 1.46
+ */
+typedef struct _GIPreparedCallable GIPreparedCallable;
+
 union _GIArgument
 {
   gboolean v_boolean;
@@ -49,6 +49,27 @@
  * </refsect1>
  */
 
+static gint32
+g_union_get_field_offset (GIUnionInfo *info,
+                          gint         n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  Header *header = (Header *)rinfo->typelib->data;
+
+  return rinfo->offset + header->union_blob_size + n * header->field_blob_size;
+}
+
+static gint32
+g_union_get_method_offset (GIUnionInfo *info,
+                           gint         n)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+  UnionBlob *blob = (UnionBlob *)&rinfo->typelib->data[rinfo->offset];
+  Header *header = (Header *)rinfo->typelib->data;
+
+  return g_union_get_field_offset (info, blob->n_fields) + n * header->function_blob_size;
+}
+
 /**
  * g_union_info_get_n_fields:
  * @info: a #GIUnionInfo
@@ -81,11 +102,38 @@ g_union_info_get_field (GIUnionInfo *info,
 			gint         n)
 {
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header = (Header *)rinfo->typelib->data;
 
   return (GIFieldInfo *) g_info_new (GI_INFO_TYPE_FIELD, (GIBaseInfo*)info, rinfo->typelib,
-				     rinfo->offset + header->union_blob_size +
-				     n * header->field_blob_size);
+				     g_union_get_field_offset (info, n));
+}
+
+/**
+ * g_union_info_load_field:
+ * @info: a #GIUnionInfo
+ * @n: a field index
+ * @field: (out caller-allocates): Initialized with the type information for
+ *   field with specified index
+ *
+ * Obtain the type information for field with specified index; this function
+ * is a variant of g_union_info_get_field() designed for stack allocation.
+ *
+ * The initialized @field must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_union_info_load_field (GIUnionInfo *info,
+                         gint         n,
+                         GIFieldInfo *field)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_UNION_INFO (info));
+
+  _g_info_init ((GIRealInfo *) field, GI_INFO_TYPE_FIELD, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_union_get_field_offset (info, n));
 }
 
 /**
@@ -120,15 +168,39 @@ g_union_info_get_method (GIUnionInfo *info,
 			 gint         n)
 {
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  UnionBlob *blob = (UnionBlob *)&rinfo->typelib->data[rinfo->offset];
-  Header *header = (Header *)rinfo->typelib->data;
-  gint offset;
 
-  offset = rinfo->offset + header->union_blob_size
-    + blob->n_fields * header->field_blob_size
-    + n * header->function_blob_size;
   return (GIFunctionInfo *) g_info_new (GI_INFO_TYPE_FUNCTION, (GIBaseInfo*)info,
-					rinfo->typelib, offset);
+					rinfo->typelib, g_union_get_method_offset (info, n));
+}
+
+/**
+ * g_union_info_load_method:
+ * @info: a #GIUnionInfo
+ * @n: a method index
+ * @method: (out caller-allocates): Initialized with the type information
+ *   for method with specified index
+ *
+ * Obtain the type information for method with specified index; this
+ * function is a variant of g_union_info_get_method() designed for stack
+ * allocation.
+ *
+ * The initialized @method must not be referenced after @info is
+ * deallocated.
+ *
+ * Since: 1.46
+ */
+void
+g_union_info_load_method (GIUnionInfo    *info,
+                          gint            n,
+                          GIFunctionInfo *method)
+{
+  GIRealInfo *rinfo = (GIRealInfo *)info;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (GI_IS_UNION_INFO (info));
+
+  _g_info_init ((GIRealInfo *) method, GI_INFO_TYPE_FUNCTION, rinfo->repository,
+                (GIBaseInfo *) info, rinfo->typelib, g_union_get_method_offset (info, n));
 }
 
 /**
@@ -234,11 +306,9 @@ g_union_info_find_method (GIUnionInfo *info,
 {
   gint offset;
   GIRealInfo *rinfo = (GIRealInfo *)info;
-  Header *header = (Header *)rinfo->typelib->data;
   UnionBlob *blob = (UnionBlob *)&rinfo->typelib->data[rinfo->offset];
 
-  offset = rinfo->offset + header->union_blob_size
-    + blob->n_fields * header->field_blob_size;
+  offset = g_union_get_method_offset (info, 0);
 
   return _g_base_info_find_method ((GIBaseInfo*)info, offset, blob->n_functions, name);
 }
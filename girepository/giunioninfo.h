@@ -47,6 +47,11 @@ GI_AVAILABLE_IN_ALL
 GIFieldInfo *    g_union_info_get_field                (GIUnionInfo *info,
 							gint         n);
 
+GI_AVAILABLE_IN_1_46
+void             g_union_info_load_field               (GIUnionInfo *info,
+                                                        gint         n,
+                                                        GIFieldInfo *field);
+
 GI_AVAILABLE_IN_ALL
 gint             g_union_info_get_n_methods            (GIUnionInfo *info);
 
@@ -54,6 +59,11 @@ GI_AVAILABLE_IN_ALL
 GIFunctionInfo * g_union_info_get_method               (GIUnionInfo *info,
 							gint         n);
 
+GI_AVAILABLE_IN_1_46
+void             g_union_info_load_method              (GIUnionInfo    *info,
+                                                        gint            n,
+                                                        GIFunctionInfo *method);
+
 GI_AVAILABLE_IN_ALL
 gboolean         g_union_info_is_discriminated         (GIUnionInfo *info);
 
@@ -56,10 +56,27 @@ _g_base_info_find_vfunc (GIRealInfo   *rinfo,
 			 gint          n_vfuncs,
 			 const gchar  *name)
 {
-  /* FIXME hash */
   Header *header = (Header *)rinfo->typelib->data;
+  guint16 index;
   gint i;
 
+  if (g_typelib_lookup_member (rinfo->typelib, rinfo->offset,
+			       GI_MEMBER_INDEX_VFUNCS, name, &index))
+    {
+      VFuncBlob *fblob;
+
+      if (index >= n_vfuncs)
+	return NULL;
+
+      offset += index * header->vfunc_blob_size;
+      fblob = (VFuncBlob *)&rinfo->typelib->data[offset];
+      if (strcmp (name, (const gchar *)&rinfo->typelib->data[fblob->name]) != 0)
+	return NULL;
+
+      return (GIVFuncInfo *) g_info_new (GI_INFO_TYPE_VFUNC, (GIBaseInfo*) rinfo,
+					 rinfo->typelib, offset);
+    }
+
   for (i = 0; i < n_vfuncs; i++)
     {
       VFuncBlob *fblob = (VFuncBlob *)&rinfo->typelib->data[offset];
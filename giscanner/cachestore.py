@@ -22,12 +22,15 @@ import errno
 import cPickle
 import glob
 import hashlib
+import mmap
 import os
+import struct
 import shutil
 import sys
 import tempfile
 
 import giscanner
+from .namespacecache import CachedNamespace, write_namespace
 
 _CACHE_VERSION_FILENAME = '.cache-version'
 
@@ -36,6 +39,8 @@ def _get_versionhash():
     toplevel = os.path.dirname(giscanner.__file__)
     # Use pyc instead of py to avoid extra IO
     sources = glob.glob(os.path.join(toplevel, '*.pyc'))
+    # The C scanner produces the cached source symbols
+    sources.extend(glob.glob(os.path.join(toplevel, '_giscanner*')))
     sources.append(sys.argv[0])
     # Using mtimes is a bit (5x) faster than hashing the file contents
     mtimes = (str(os.stat(source).st_mtime) for source in sources)
@@ -153,24 +158,22 @@ class CacheStore(object):
                 continue
             self._remove_filename(os.path.join(self._directory, filename))
 
-    def store(self, filename, data):
-        store_filename = self._get_filename(filename)
-        if store_filename is None:
-            return
-
-        if (os.path.exists(store_filename) and self._cache_is_valid(store_filename, filename)):
-            return None
-
+    def _write(self, store_filename, write):
         tmp_fd, tmp_filename = tempfile.mkstemp(prefix='g-ir-scanner-cache-')
         try:
-            cPickle.dump(data, os.fdopen(tmp_fd, 'w'))
+            fp = os.fdopen(tmp_fd, 'wb')
+            write(fp)
+            fp.close()
         except IOError as e:
+            self._remove_filename(tmp_filename)
             # No space left on device
             if e.errno == errno.ENOSPC:
-                self._remove_filename(tmp_filename)
                 return
             else:
                 raise
+        except:
+            self._remove_filename(tmp_filename)
+            raise
 
         try:
             shutil.move(tmp_filename, store_filename)
@@ -181,23 +184,100 @@ class CacheStore(object):
             else:
                 raise
 
-    def load(self, filename):
-        store_filename = self._get_filename(filename)
-        if store_filename is None:
-            return
+    def _read(self, store_filename, fd):
+        try:
+            data = cPickle.load(fd)
+        except (AttributeError, EOFError, ValueError, cPickle.BadPickleGet):
+            # Broken cache entry, remove it
+            self._remove_filename(store_filename)
+            data = None
+        return data
+
+    def _open(self, store_filename):
         try:
-            fd = open(store_filename)
+            return open(store_filename, 'rb')
         except IOError as e:
             if e.errno == errno.ENOENT:
                 return None
             else:
                 raise
+
+    def store(self, filename, data):
+        store_filename = self._get_filename(filename)
+        if store_filename is None:
+            return
+
+        if (os.path.exists(store_filename) and self._cache_is_valid(store_filename, filename)):
+            return None
+
+        self._write(store_filename, lambda fp: cPickle.dump(data, fp))
+
+    def load(self, filename):
+        store_filename = self._get_filename(filename)
+        if store_filename is None:
+            return
+        fd = self._open(store_filename)
+        if fd is None:
+            return None
         if not self._cache_is_valid(store_filename, filename):
             return None
+        return self._read(store_filename, fd)
+
+    def is_enabled(self):
+        """Whether entries can be stored at all, so that callers can
+skip building entries which would be discarded."""
+        return self._directory is not None
+
+    def store_keyed(self, key, data):
+        """Store data under an arbitrary key. Unlike store(), the entry
+is not tied to the mtime of a file, so the caller must put whatever it
+needs to check the entry's validity into data."""
+        store_filename = self._get_filename(key)
+        if store_filename is None:
+            return
+        self._write(store_filename,
+                    lambda fp: cPickle.dump(data, fp, cPickle.HIGHEST_PROTOCOL))
+
+    def load_keyed(self, key):
+        store_filename = self._get_filename(key)
+        if store_filename is None:
+            return None
+        fd = self._open(store_filename)
+        if fd is None:
+            return None
+        return self._read(store_filename, fd)
+
+    def store_namespace(self, filename, namespace):
+        """Store a namespace parsed with GIRParser(types_only=True) from
+filename, in the format of giscanner.namespacecache."""
+        # The format has no room for functions and other symbols
+        if namespace.symbols:
+            return
+
+        store_filename = self._get_filename('namespace:' + filename)
+        if store_filename is None:
+            return
+
+        if (os.path.exists(store_filename) and self._cache_is_valid(store_filename, filename)):
+            return
+
+        self._write(store_filename, lambda fp: write_namespace(namespace, fp))
+
+    def load_namespace(self, filename):
+        store_filename = self._get_filename('namespace:' + filename)
+        if store_filename is None:
+            return None
+        fd = self._open(store_filename)
+        if fd is None:
+            return None
         try:
-            data = cPickle.load(fd)
-        except (AttributeError, EOFError, ValueError, cPickle.BadPickleGet):
-            # Broken cache entry, remove it
+            if not self._cache_is_valid(store_filename, filename):
+                return None
+            buf = mmap.mmap(fd.fileno(), 0, access=mmap.ACCESS_READ)
+            return CachedNamespace(buf)
+        except (ValueError, struct.error, mmap.error):
+            # Empty or broken cache entry, remove it
             self._remove_filename(store_filename)
-            data = None
-        return data
+            return None
+        finally:
+            fd.close()
@@ -25,6 +25,7 @@ import subprocess
 import shutil
 import tempfile
 
+import giscanner
 from .gdumpparser import IntrospectionBinary
 from . import utils
 from .ccompiler import CCompiler
@@ -68,6 +69,21 @@ main(int argc, char **argv)
 """
 
 
+def _find_generic_dumper():
+    builddir = os.environ.get('UNINSTALLED_INTROSPECTION_BUILDDIR')
+    if builddir is not None:
+        dirname = builddir
+    else:
+        # Installed in the private directory holding the giscanner package
+        dirname = os.path.join(os.path.dirname(giscanner.__file__), os.pardir)
+    path = os.path.join(dirname, 'g-ir-dumper')
+    if os.name == 'nt':
+        path += '.exe'
+    if os.path.isfile(path) and os.access(path, os.X_OK):
+        return path
+    return None
+
+
 class CompilerError(Exception):
     pass
 
@@ -100,6 +116,49 @@ class DumpCompiler(object):
 
     # Public API
 
+    def get_generic_binary(self):
+        """Return an IntrospectionBinary which loads the libraries into the
+prebuilt g-ir-dumper, or None if a dumper program has to be compiled.
+Should g-ir-dumper fail, for instance because it cannot find an
+uninstalled dependency of the library, the program is compiled after all."""
+        # Initialization code has to be compiled into the program
+        if self._options.init_sections or not self._options.libraries:
+            return None
+        dumper = _find_generic_dumper()
+        if dumper is None:
+            return None
+
+        libraries = []
+        dependencies = []
+        for library in self._options.libraries:
+            # Only libtool archives tell where the shared library is
+            if not library.endswith('.la') or not os.path.isfile(library):
+                return None
+            try:
+                shlib = utils.extract_libtool(library)
+            except ValueError:
+                # A static library has to be linked in
+                return None
+            if not os.path.isfile(shlib):
+                return None
+            libraries.append(os.path.abspath(shlib))
+
+            for dependency in utils.extract_libtool_dependencies(library):
+                if not os.path.isfile(dependency):
+                    continue
+                try:
+                    shlib = os.path.abspath(utils.extract_libtool(dependency))
+                except ValueError:
+                    continue
+                if os.path.isfile(shlib) and shlib not in dependencies:
+                    dependencies.append(shlib)
+
+        return IntrospectionBinary([dumper] + libraries,
+                                   libraries=libraries,
+                                   dependencies=dependencies,
+                                   fallback=self.run,
+                                   binary_dump=True)
+
     def run(self):
         # We have to use the current directory to work around Unix
         # sysadmins who mount /tmp noexec
@@ -181,7 +240,7 @@ class DumpCompiler(object):
                 shutil.rmtree(tmpdir)
             raise SystemExit('linking of temporary binary failed: ' + str(e))
 
-        return IntrospectionBinary([bin_path], tmpdir)
+        return IntrospectionBinary([bin_path], tmpdir, binary_dump=True)
 
     # Private API
 
@@ -335,4 +394,8 @@ class DumpCompiler(object):
 def compile_introspection_binary(options, get_type_functions,
                                  error_quark_functions):
     dc = DumpCompiler(options, get_type_functions, error_quark_functions)
+    if options.generic_dumper:
+        binary = dc.get_generic_binary()
+        if binary is not None:
+            return binary
     return dc.run()
@@ -20,14 +20,18 @@
 
 import os
 import sys
+import hashlib
 import tempfile
 import shutil
+import struct
 import subprocess
-from xml.etree.cElementTree import parse
+from cStringIO import StringIO
+from xml.etree.cElementTree import Element, ElementTree, SubElement, parse
 
 from . import ast
 from . import message
 from . import utils
+from .cachestore import CacheStore
 from .transformer import TransformerException
 from .utils import to_underscores
 
@@ -41,15 +45,107 @@ G_PARAM_STATIC_NAME = 1 << 5
 G_PARAM_STATIC_NICK = 1 << 6
 G_PARAM_STATIC_BLURB = 1 << 7
 
+# Binary dump format, see girepository/gdump.c
+DUMP_BINARY_MAGIC = 'GIDUMP\x00\x01'
+_U32 = struct.Struct('<I')
+
+
+def parse_binary_dump(data):
+    """Build the element tree of a dump written by g_irepository_dump()
+in the binary format; it is the same tree as the XML format gives."""
+    if not data.startswith(DUMP_BINARY_MAGIC):
+        raise ValueError("not a binary dump")
+    unpack_u32 = _U32.unpack_from
+    root = None
+    stack = []
+    offset = len(DUMP_BINARY_MAGIC)
+    end = len(data)
+    try:
+        while offset < end:
+            record = data[offset]
+            offset += 1
+            if record == '=':
+                length = unpack_u32(data, offset)[0]
+                offset += 4
+                name = data[offset:offset + length]
+                offset += length
+                length = unpack_u32(data, offset)[0]
+                offset += 4
+                stack[-1].set(name, data[offset:offset + length])
+                offset += length
+            elif record == '<':
+                length = unpack_u32(data, offset)[0]
+                offset += 4
+                tag = data[offset:offset + length]
+                offset += length
+                if stack:
+                    stack.append(SubElement(stack[-1], tag))
+                elif root is None:
+                    root = Element(tag)
+                    stack.append(root)
+                else:
+                    raise ValueError("more than one root element")
+            elif record == '>':
+                stack.pop()
+            else:
+                raise ValueError("unknown record %r" % (record, ))
+    except (IndexError, struct.error) as e:
+        raise ValueError("corrupt binary dump at offset %d: %s" % (offset, e))
+    if stack or root is None or offset != end:
+        raise ValueError("truncated binary dump")
+    return ElementTree(root)
+
+
+def _parse_dump(data):
+    if data.startswith(DUMP_BINARY_MAGIC):
+        return parse_binary_dump(data)
+    return parse(StringIO(data))
+
 
 class IntrospectionBinary(object):
 
-    def __init__(self, args, tmpdir=None):
+    def __init__(self, args, tmpdir=None, libraries=None, dependencies=None,
+                 fallback=None, binary_dump=False):
         self.args = args
         if tmpdir is None:
             self.tmpdir = tempfile.mkdtemp('', 'tmp-introspect')
         else:
             self.tmpdir = tmpdir
+        # Shared libraries loaded by a generic dumper; their dump
+        # can be cached.
+        self.libraries = libraries
+        # The shared libraries of the libtool archives they link to
+        self.dependencies = dependencies or []
+        # Returns another binary to use if this one fails
+        self.fallback = fallback
+        # Only binaries built against this libgirepository, not programs
+        # passed with --program, understand the binary dump format
+        self.binary_dump = binary_dump
+
+
+def _get_dump_cache_key(binary, functions):
+    """The dumped types depend on the libraries and, for instance through
+their parent types, on the libraries they link to.  The libraries are
+hashed, their libtool dependencies only identified by modification time
+and size.  Dependencies linked with -l flags, usually installed ones,
+are not part of the key: the dump of a library is not updated when they
+change unless the library itself is rebuilt."""
+    key = hashlib.sha1()
+    key.update(functions)
+    key.update(str(os.stat(binary.args[0]).st_mtime))
+    for library in binary.libraries:
+        key.update(library)
+        fp = open(library, 'rb')
+        while True:
+            data = fp.read(65536)
+            if not data:
+                break
+            key.update(data)
+        fp.close()
+    for dependency in binary.dependencies:
+        st = os.stat(dependency)
+        key.update('%s\0%s\0%d' % (dependency, st.st_mtime, st.st_size))
+    return 'dump:' + key.hexdigest()
 
 
 class Unresolved(object):
@@ -106,7 +202,7 @@ class GDumpParser(object):
         """Do remaining parsing steps requiring introspection binary"""
 
         # Get all the GObject data by passing our list of get_type
-        # functions to the compiled binary, returning an XML blob.
+        # functions to the compiled binary, returning an element tree.
         tree = self._execute_binary_get_tree()
         root = tree.getroot()
         for child in root:
@@ -142,36 +238,67 @@ class GDumpParser(object):
     # Helper functions
 
     def _execute_binary_get_tree(self):
-        """Load the library (or executable), returning an XML
-blob containing data gleaned from GObject's primitive introspection."""
-        in_path = os.path.join(self._binary.tmpdir, 'functions.txt')
-        f = open(in_path, 'w')
+        """Load the library (or executable), returning an element
+tree containing data gleaned from GObject's primitive introspection."""
+        functions = []
         for func in self._get_type_functions:
-            f.write('get-type:')
-            f.write(func)
-            f.write('\n')
+            functions.append('get-type:%s\n' % (func, ))
         for func in self._error_quark_functions:
-            f.write('error-quark:')
-            f.write(func)
-            f.write('\n')
+            functions.append('error-quark:%s\n' % (func, ))
+        functions = ''.join(functions)
+
+        cachestore = None
+        cache_key = None
+        if self._binary.libraries is not None:
+            cachestore = CacheStore()
+            cache_key = _get_dump_cache_key(self._binary, functions)
+            data = cachestore.load_keyed(cache_key)
+            if data is not None:
+                self._remove_binary_tmpdir()
+                return _parse_dump(data)
+
+        while True:
+            try:
+                data = self._execute_binary(functions)
+                break
+            except subprocess.CalledProcessError as e:
+                if (self._binary.fallback is None or
+                        utils.have_debug_flag('no-dumper-fallback')):
+                    raise SystemExit(e)
+                self._binary = self._binary.fallback()
+
+        if cache_key is not None:
+            cachestore.store_keyed(cache_key, data)
+        return _parse_dump(data)
+
+    def _execute_binary(self, functions):
+        in_path = os.path.join(self._binary.tmpdir, 'functions.txt')
+        f = open(in_path, 'w')
+        f.write(functions)
         f.close()
-        out_path = os.path.join(self._binary.tmpdir, 'dump.xml')
+        out_path = os.path.join(self._binary.tmpdir, 'dump.bin')
 
         args = []
         args.extend(self._binary.args)
-        args.append('--introspect-dump=%s,%s' % (in_path, out_path))
+        if self._binary.binary_dump:
+            args.append('--introspect-dump=%s,%s,binary' % (in_path, out_path))
+        else:
+            args.append('--introspect-dump=%s,%s' % (in_path, out_path))
 
         # Invoke the binary, having written our get_type functions to types.txt
         try:
-            try:
-                subprocess.check_call(args, stdout=sys.stdout, stderr=sys.stderr)
-            except subprocess.CalledProcessError as e:
-                # Clean up temporaries
-                raise SystemExit(e)
-            return parse(out_path)
+            subprocess.check_call(args, stdout=sys.stdout, stderr=sys.stderr)
+            f = open(out_path, 'rb')
+            data = f.read()
+            f.close()
+            return data
         finally:
-            if not utils.have_debug_flag('save-temps'):
-                shutil.rmtree(self._binary.tmpdir)
+            self._remove_binary_tmpdir()
+
+    def _remove_binary_tmpdir(self):
+        # Clean up temporaries
+        if not utils.have_debug_flag('save-temps'):
+            shutil.rmtree(self._binary.tmpdir)
 
     # Parser
 
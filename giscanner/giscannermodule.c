@@ -544,6 +544,30 @@ pygi_source_scanner_lex_filename (PyGISourceScanner *self,
   return Py_None;
 }
 
+static PyObject *
+pygi_source_scanner_parse_captured_macros (PyGISourceScanner *self)
+{
+  gi_source_scanner_parse_captured_macros (self->scanner);
+
+  Py_INCREF (Py_None);
+  return Py_None;
+}
+
+static PyObject *
+pygi_source_scanner_set_capture_macros (PyGISourceScanner *self,
+					PyObject          *args)
+{
+  int capture_macros;
+
+  if (!PyArg_ParseTuple (args, "b:SourceScanner.set_capture_macros", &capture_macros))
+    return NULL;
+
+  gi_source_scanner_set_capture_macros (self->scanner, capture_macros);
+
+  Py_INCREF (Py_None);
+  return Py_None;
+}
+
 static PyObject *
 pygi_source_scanner_set_macro_scan (PyGISourceScanner *self,
 				    PyObject          *args)
@@ -610,8 +634,10 @@ static const PyMethodDef _PyGISourceScanner_methods[] = {
   { "append_filename", (PyCFunction) pygi_source_scanner_append_filename, METH_VARARGS },
   { "parse_file", (PyCFunction) pygi_source_scanner_parse_file, METH_VARARGS },
   { "parse_macros", (PyCFunction) pygi_source_scanner_parse_macros, METH_VARARGS },
+  { "parse_captured_macros", (PyCFunction) pygi_source_scanner_parse_captured_macros, METH_NOARGS },
   { "lex_filename", (PyCFunction) pygi_source_scanner_lex_filename, METH_VARARGS },
   { "set_macro_scan", (PyCFunction) pygi_source_scanner_set_macro_scan, METH_VARARGS },
+  { "set_capture_macros", (PyCFunction) pygi_source_scanner_set_capture_macros, METH_VARARGS },
   { NULL, NULL, 0 }
 };
 
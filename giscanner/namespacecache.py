@@ -0,0 +1,331 @@
+# -*- Mode: Python -*-
+# GObject-Introspection - a framework for introspecting GObject libraries
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the
+# Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+# Boston, MA 02111-1307, USA.
+#
+
+"""Compact cache format for the namespaces of included GIRs.
+
+Includes are parsed with GIRParser(types_only=True), and all the
+scanner asks of them is a lookup by name, C type or GType name, plus
+the identifier and symbol prefixes.  Rather than unpickling the whole
+tree, this format keeps those indexes in sorted tables that are
+searched in place in a memory mapped file, and pickles every node on
+its own so that it is only loaded once it is looked up.
+
+All integers are unsigned, 32 bit and little endian:
+
+  header      magic, then the offsets of the sections below
+  strings     length + UTF-8 data, referred to by offset
+  metadata    eight string lists: name, version, identifier prefixes,
+              symbol prefixes, includes, shared libraries, C includes
+              and exported packages
+  nodes       count, then (name, blob offset, blob length) per node,
+              in namespace order
+  names       count, then (name, node) sorted by name
+  ctypes      count, then (ctype, node) sorted by C type
+  type names  count, then (GType name, node) sorted by GType name
+  blobs       one pickle per node
+"""
+
+import cPickle
+import struct
+from cStringIO import StringIO
+
+from . import ast
+
+MAGIC = 'GINSC\x00\x00\x01'
+
+_HEADER = struct.Struct('<8s7I')
+_U32 = struct.Struct('<I')
+_ENTRY = struct.Struct('<II')
+_NODE = struct.Struct('<III')
+
+_NAMESPACE_ID = 'namespace'
+
+
+def _encode(string):
+    if isinstance(string, unicode):
+        return string.encode('utf-8')
+    return string
+
+
+class _StringTable(object):
+
+    def __init__(self):
+        self._offsets = {}
+        self._data = StringIO()
+
+    def add(self, string):
+        string = _encode(string)
+        offset = self._offsets.get(string)
+        if offset is None:
+            offset = self._data.tell()
+            self._data.write(_U32.pack(len(string)))
+            self._data.write(string)
+            self._offsets[string] = offset
+        return offset
+
+    def getvalue(self):
+        return self._data.getvalue()
+
+
+def _pickle_node(namespace, node):
+    # The namespace back reference is restored on load, rather than
+    # dragging the whole namespace into every blob.
+    data = StringIO()
+    pickler = cPickle.Pickler(data, cPickle.HIGHEST_PROTOCOL)
+    pickler.persistent_id = lambda obj: _NAMESPACE_ID if obj is namespace else None
+    pickler.dump(node)
+    return data.getvalue()
+
+
+def write_namespace(namespace, fp):
+    """Write a namespace parsed with GIRParser(types_only=True) to fp"""
+    if namespace.symbols:
+        raise ValueError("%s: only namespaces without functions can be cached"
+                         % (namespace.name, ))
+
+    strings = _StringTable()
+    nodes = list(namespace.itervalues())
+    node_indexes = dict((id(node), i) for i, node in enumerate(nodes))
+
+    def pack_string_lists(lists):
+        data = StringIO()
+        for strings_ in lists:
+            data.write(_U32.pack(len(strings_)))
+            for string in strings_:
+                data.write(_U32.pack(strings.add(string)))
+        return data.getvalue()
+
+    def pack_index(mapping):
+        entries = []
+        for key, node in mapping.iteritems():
+            index = node_indexes.get(id(node))
+            if key is None or index is None:
+                continue
+            entries.append((_encode(key), index))
+        entries.sort()
+        data = StringIO()
+        data.write(_U32.pack(len(entries)))
+        for key, index in entries:
+            data.write(_ENTRY.pack(strings.add(key), index))
+        return data.getvalue()
+
+    metadata = pack_string_lists([
+        [namespace.name],
+        [namespace.version],
+        namespace.identifier_prefixes,
+        namespace.symbol_prefixes,
+        sorted(str(include) for include in namespace.includes),
+        namespace.shared_libraries,
+        sorted(namespace.c_includes),
+        sorted(namespace.exported_packages)])
+
+    blobs = StringIO()
+    node_table = StringIO()
+    node_table.write(_U32.pack(len(nodes)))
+    for node in nodes:
+        blob = _pickle_node(namespace, node)
+        node_table.write(_NODE.pack(strings.add(node.name), blobs.tell(), len(blob)))
+        blobs.write(blob)
+
+    sections = [metadata,
+                node_table.getvalue(),
+                pack_index(namespace.names),
+                pack_index(namespace.ctypes),
+                pack_index(namespace.type_names),
+                blobs.getvalue()]
+    # Only complete once everything else is packed
+    sections.insert(0, strings.getvalue())
+
+    offsets = []
+    offset = _HEADER.size
+    for section in sections:
+        offsets.append(offset)
+        offset += len(section)
+
+    fp.write(_HEADER.pack(MAGIC, *offsets))
+    for section in sections:
+        fp.write(section)
+
+
+class _Index(object):
+    """Read-only mapping from a string to a node of a CachedNamespace,
+binary searched in place."""
+
+    def __init__(self, namespace, offset):
+        self._namespace = namespace
+        self._buf = namespace._buf
+        self._n_entries = _U32.unpack_from(self._buf, offset)[0]
+        self._entries = offset + _U32.size
+
+    def _entry(self, i):
+        return _ENTRY.unpack_from(self._buf, self._entries + i * _ENTRY.size)
+
+    def _find(self, key):
+        if not isinstance(key, basestring):
+            return None
+        key = _encode(key)
+        lo, hi = 0, self._n_entries
+        while lo < hi:
+            mid = (lo + hi) // 2
+            string, index = self._entry(mid)
+            entry_key = self._namespace._raw_string(string)
+            if entry_key < key:
+                lo = mid + 1
+            elif entry_key > key:
+                hi = mid
+            else:
+                return index
+        return None
+
+    def get(self, key, default=None):
+        index = self._find(key)
+        if index is None:
+            return default
+        return self._namespace._node(index)
+
+    def __getitem__(self, key):
+        index = self._find(key)
+        if index is None:
+            raise KeyError(key)
+        return self._namespace._node(index)
+
+    def __contains__(self, key):
+        return self._find(key) is not None
+
+    def __len__(self):
+        return self._n_entries
+
+    def __nonzero__(self):
+        return self._n_entries > 0
+
+    def iteritems(self):
+        for i in xrange(self._n_entries):
+            string, index = self._entry(i)
+            yield (self._namespace._string(string), self._namespace._node(index))
+
+    def iterkeys(self):
+        for i in xrange(self._n_entries):
+            yield self._namespace._string(self._entry(i)[0])
+
+    def itervalues(self):
+        for key, node in self.iteritems():
+            yield node
+
+    __iter__ = iterkeys
+
+    def keys(self):
+        return list(self.iterkeys())
+
+    def values(self):
+        return list(self.itervalues())
+
+    def items(self):
+        return list(self.iteritems())
+
+
+class _NameIndex(_Index):
+    """Like _Index, but iterates in namespace order, as the
+OrderedDict of ast.Namespace does."""
+
+    def iteritems(self):
+        for i in xrange(self._namespace._n_nodes):
+            yield (self._namespace._node_name(i), self._namespace._node(i))
+
+    def iterkeys(self):
+        for i in xrange(self._namespace._n_nodes):
+            yield self._namespace._node_name(i)
+
+    __iter__ = iterkeys
+
+
+class CachedNamespace(ast.Namespace):
+    """A namespace read from write_namespace() output.  Nodes are
+unpickled on first access; the namespace is read-only."""
+
+    def __init__(self, buf):
+        header = _HEADER.unpack_from(buf, 0)
+        if header[0] != MAGIC:
+            raise ValueError("not a namespace cache")
+        (self._strings, metadata, nodes,
+         names, ctypes, type_names, self._blobs) = header[1:]
+        self._buf = buf
+
+        lists = []
+        offset = metadata
+        for i in xrange(8):
+            n_strings = _U32.unpack_from(buf, offset)[0]
+            offset += _U32.size
+            lists.append([self._string(_U32.unpack_from(buf, offset + j * _U32.size)[0])
+                          for j in xrange(n_strings)])
+            offset += n_strings * _U32.size
+        (name, version, identifier_prefixes, symbol_prefixes,
+         includes, shared_libraries, c_includes, exported_packages) = lists
+
+        ast.Namespace.__init__(self, name[0], version[0],
+                               identifier_prefixes=identifier_prefixes,
+                               symbol_prefixes=symbol_prefixes)
+        self.includes = set(ast.Include.from_string(include) for include in includes)
+        self.shared_libraries = shared_libraries
+        self.c_includes = set(c_includes)
+        self.exported_packages = set(exported_packages)
+
+        self._n_nodes = _U32.unpack_from(buf, nodes)[0]
+        self._node_table = nodes + _U32.size
+        self._nodes = [None] * self._n_nodes
+
+        self.names = _NameIndex(self, names)
+        self.ctypes = _Index(self, ctypes)
+        self.type_names = _Index(self, type_names)
+
+    def _raw_string(self, offset):
+        offset += self._strings
+        length = _U32.unpack_from(self._buf, offset)[0]
+        offset += _U32.size
+        return self._buf[offset:offset + length]
+
+    def _string(self, offset):
+        string = self._raw_string(offset)
+        try:
+            string.decode('ascii')
+        except UnicodeDecodeError:
+            return string.decode('utf-8')
+        return string
+
+    def _node_name(self, i):
+        return self._string(_NODE.unpack_from(self._buf, self._node_table + i * _NODE.size)[0])
+
+    def _node(self, i):
+        node = self._nodes[i]
+        if node is None:
+            name, offset, length = _NODE.unpack_from(self._buf,
+                                                     self._node_table + i * _NODE.size)
+            offset += self._blobs
+            unpickler = cPickle.Unpickler(StringIO(self._buf[offset:offset + length]))
+            unpickler.persistent_load = self._persistent_load
+            node = unpickler.load()
+            self._nodes[i] = node
+        return node
+
+    def _persistent_load(self, pid):
+        if pid != _NAMESPACE_ID:
+            raise cPickle.UnpicklingError("unknown persistent id %r" % (pid, ))
+        return self
+
+    def __contains__(self, name):
+        return name in self.names
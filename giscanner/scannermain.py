@@ -20,6 +20,8 @@
 # 02110-1301, USA.
 #
 
+from __future__ import with_statement
+
 import errno
 import optparse
 import os
@@ -121,6 +123,10 @@ def _get_option_parser():
     parser.add_option("", "--program-arg",
                       action="append", dest="program_args", default=[],
                       help="extra arguments to program")
+    parser.add_option("", "--generic-dumper",
+                      action="store_true", dest="generic_dumper", default=False,
+                      help="load shared libraries into a prebuilt dumper instead of "
+                      "compiling one, and cache its output")
     parser.add_option("", "--libtool",
                       action="store", dest="libtool_path", default=None,
                       help="full path to libtool")
@@ -433,8 +439,10 @@ def create_source_scanner(options, args):
                        options.cpp_defines,
                        options.cpp_undefines,
                        cflags=options.cflags)
-    ss.parse_files(filenames)
-    ss.parse_macros(filenames)
+    with utils.debug_timing('preprocess and parse'):
+        ss.parse_files(filenames)
+    with utils.debug_timing('macros'):
+        ss.parse_macros(filenames)
     return ss
 
 
@@ -522,26 +530,31 @@ def scanner_main(args):
 
     ss = create_source_scanner(options, args)
 
-    cbp = GtkDocCommentBlockParser()
-    blocks = cbp.parse_comment_blocks(ss.get_comments())
+    with utils.debug_timing('comment blocks'):
+        cbp = GtkDocCommentBlockParser()
+        blocks = cbp.parse_comment_blocks(ss.get_comments())
 
     # Transform the C symbols into AST nodes
-    transformer.parse(ss.get_symbols())
+    with utils.debug_timing('transform symbols'):
+        transformer.parse(ss.get_symbols())
 
     if not options.header_only:
-        shlibs = create_binary(transformer, options, args)
+        with utils.debug_timing('introspection binary'):
+            shlibs = create_binary(transformer, options, args)
     else:
         shlibs = []
 
     transformer.namespace.shared_libraries = shlibs
 
     main = MainTransformer(transformer, blocks)
-    main.transform()
+    with utils.debug_timing('main transform'):
+        main.transform()
 
     utils.break_on_debug_flag('tree')
 
     final = IntrospectablePass(transformer, blocks)
-    final.validate()
+    with utils.debug_timing('introspectable pass'):
+        final.validate()
 
     warning_count = logger.get_warning_count()
     if options.warn_fatal and warning_count > 0:
@@ -559,9 +572,10 @@ def scanner_main(args):
 
     transformer.namespace.c_includes = options.c_includes
     transformer.namespace.exported_packages = exported_packages
-    writer = Writer(transformer.namespace)
-    data = writer.get_xml()
+    with utils.debug_timing('write'):
+        writer = Writer(transformer.namespace)
+        data = writer.get_xml()
 
-    write_output(data, options)
+        write_output(data, options)
 
     return 0
@@ -1758,6 +1758,36 @@ gi_source_scanner_parse_macros (GISourceScanner *scanner, GList *filenames)
   gi_source_scanner_parse_file (scanner, fmacros);
 }
 
+/*
+ * Parse the #define lines that were captured while parsing the cpp -dD
+ * output, so that the headers do not have to be read a second time.
+ */
+void
+gi_source_scanner_parse_captured_macros (GISourceScanner *scanner)
+{
+  GError *error = NULL;
+  char *tmp_name = NULL;
+  FILE *fmacros;
+
+  if (scanner->macros == NULL)
+    return;
+
+  if (scanner->macros->len > 0)
+    {
+      fmacros = fdopen (g_file_open_tmp ("gen-introspect-XXXXXX.h", &tmp_name, &error),
+                        "w+");
+      g_unlink (tmp_name);
+      g_free (tmp_name);
+
+      fwrite (scanner->macros->str, 1, scanner->macros->len, fmacros);
+      rewind (fmacros);
+      gi_source_scanner_parse_file (scanner, fmacros);
+      fclose (fmacros);
+    }
+
+  gi_source_scanner_set_capture_macros (scanner, FALSE);
+}
+
 gboolean
 gi_source_scanner_parse_file (GISourceScanner *scanner, FILE *file)
 {
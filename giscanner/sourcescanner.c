@@ -247,6 +247,9 @@ gi_source_scanner_free (GISourceScanner *scanner)
   g_hash_table_unref (scanner->files);
 
   g_queue_clear (&scanner->conditionals);
+
+  if (scanner->macros)
+    g_string_free (scanner->macros, TRUE);
 }
 
 gboolean
@@ -264,6 +267,19 @@ gi_source_scanner_set_macro_scan (GISourceScanner  *scanner,
   scanner->macro_scan = macro_scan;
 }
 
+void
+gi_source_scanner_set_capture_macros (GISourceScanner *scanner,
+				      gboolean         capture_macros)
+{
+  if (capture_macros && scanner->macros == NULL)
+    scanner->macros = g_string_new (NULL);
+  else if (!capture_macros && scanner->macros != NULL)
+    {
+      g_string_free (scanner->macros, TRUE);
+      scanner->macros = NULL;
+    }
+}
+
 void
 gi_source_scanner_add_symbol (GISourceScanner  *scanner,
 			      GISourceSymbol   *symbol)
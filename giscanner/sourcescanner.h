@@ -116,6 +116,7 @@ struct _GISourceScanner
   GHashTable *typedef_table;
   gboolean skipping;
   GQueue conditionals;
+  GString *macros; /* #define lines captured from the cpp -dD output */
 };
 
 struct _GISourceSymbol
@@ -156,6 +157,9 @@ gboolean            gi_source_scanner_parse_file       (GISourceScanner  *igener
 						        FILE             *file);
 void                gi_source_scanner_parse_macros     (GISourceScanner  *scanner,
 							GList            *filenames);
+void                gi_source_scanner_parse_captured_macros (GISourceScanner *scanner);
+void                gi_source_scanner_set_capture_macros (GISourceScanner *scanner,
+							  gboolean         capture_macros);
 void                gi_source_scanner_set_macro_scan   (GISourceScanner  *scanner,
 							gboolean          macro_scan);
 GSList *            gi_source_scanner_get_symbols      (GISourceScanner  *scanner);
@@ -19,10 +19,14 @@
 #
 
 from __future__ import with_statement
+import errno
+import hashlib
 import os
 import subprocess
 import tempfile
 
+from . import utils
+from .cachestore import CacheStore
 from .libtoolimporter import LibtoolImporter
 from .message import Position
 
@@ -220,12 +224,80 @@ class SourceSymbol(object):
                         self._symbol.line)
 
 
+class _CachedType(object):
+    """Picklable copy of a C scanner type, see _CachedSymbol"""
+    __slots__ = ['type', 'storage_class_specifier', 'type_qualifier',
+                 'function_specifier', 'name', 'base_type', 'child_list',
+                 'is_bitfield']
+
+    def __init__(self, stype):
+        self.type = stype.type
+        self.storage_class_specifier = stype.storage_class_specifier
+        self.type_qualifier = stype.type_qualifier
+        self.function_specifier = stype.function_specifier
+        self.name = stype.name
+        self.is_bitfield = stype.is_bitfield
+        if stype.base_type is not None:
+            self.base_type = _CachedType(stype.base_type)
+        else:
+            self.base_type = None
+        self.child_list = [_CachedSymbol(symbol) if symbol is not None else None
+                           for symbol in stype.child_list]
+
+
+class _CachedSymbol(object):
+    """Picklable copy of a C scanner symbol, with the same attributes,
+so that SourceSymbol can wrap either one."""
+    __slots__ = ['type', 'ident', 'base_type', 'const_int', 'const_double',
+                 'const_string', 'const_boolean', 'source_filename', 'line',
+                 'private']
+
+    def __init__(self, symbol):
+        self.type = symbol.type
+        self.ident = symbol.ident
+        self.const_int = symbol.const_int
+        self.const_double = symbol.const_double
+        self.const_string = symbol.const_string
+        self.const_boolean = symbol.const_boolean
+        self.source_filename = symbol.source_filename
+        self.line = symbol.line
+        self.private = symbol.private
+        if symbol.base_type is not None:
+            self.base_type = _CachedType(symbol.base_type)
+        else:
+            self.base_type = None
+
+
+def _hash_file(filename):
+    digest = hashlib.sha1()
+    with open(filename, 'rb') as fp:
+        while True:
+            data = fp.read(65536)
+            if not data:
+                break
+            digest.update(data)
+    return digest.hexdigest()
+
+
+def _read_depfile(filename):
+    """Return the prerequisites listed in a cpp -MD dependency file"""
+    with open(filename) as fp:
+        data = fp.read()
+    data = data.replace('\\\n', ' ').replace('\\ ', '\0')
+    if ':' in data:
+        data = data.split(':', 1)[1]
+    return [dep.replace('\0', ' ') for dep in data.split()]
+
+
 class SourceScanner(object):
 
     def __init__(self):
         self._scanner = CSourceScanner()
         self._filenames = []
         self._cpp_options = []
+        self._macros_captured = False
+        self._cached_symbols = []
+        self._cached_comments = []
 
     # Public API
 
@@ -256,21 +328,30 @@ class SourceScanner(object):
         self._parse(headers)
 
     def parse_macros(self, filenames):
+        if self._macros_captured:
+            # The headers' #defines were kept while parsing the
+            # preprocessor output, only the sources still need reading.
+            filenames = [f for f in filenames
+                         if os.path.splitext(f)[1] in SOURCE_EXTS]
+        if not filenames:
+            return
         self._scanner.set_macro_scan(True)
         # self._scanner expects file names to be canonicalized and symlinks to be resolved
         self._scanner.parse_macros([os.path.realpath(f) for f in filenames])
         self._scanner.set_macro_scan(False)
 
     def get_symbols(self):
+        for symbol in self._cached_symbols:
+            yield SourceSymbol(self._scanner, symbol)
         for symbol in self._scanner.get_symbols():
             yield SourceSymbol(self._scanner, symbol)
 
     def get_comments(self):
-        return self._scanner.get_comments()
+        return self._scanner.get_comments() + self._cached_comments
 
     def dump(self):
         print '-' * 30
-        for symbol in self._scanner.get_symbols():
+        for symbol in self.get_symbols():
             print symbol.ident, symbol.base_type.name, symbol.type
 
     # Private
@@ -294,6 +375,12 @@ class SourceScanner(object):
         cpp_args += ['-E', '-C', '-I.', '-']
         cpp_args += self._cpp_options
 
+        # Have cpp pass the #defines through, so that the macro scan
+        # does not need to read and lex the headers a second time.
+        if not utils.have_debug_flag('macro-rescan'):
+            cpp_args.append('-dD')
+            self._macros_captured = True
+
         # We expect the preprocessor to remove macros. If debugging is turned
         # up high enough that won't happen, so strip these out. Bug #720504
         for flag in ['-g3', '-ggdb3', '-gstabs3', '-gcoff3', '-gxcoff3', '-gvms3']:
@@ -302,6 +389,80 @@ class SourceScanner(object):
             except ValueError:
                 pass
 
+        cachestore = CacheStore()
+        if not cachestore.is_enabled():
+            # Nothing to validate or store an entry with
+            self._run_cpp(cpp_args, defines, undefs, filenames)
+            return
+
+        cache_key = self._get_cache_key(cpp_args, filenames)
+        if self._load_cache(cachestore, cache_key):
+            return
+
+        # Have cpp list every file it reads, to validate the cache entry
+        dep_fd, dep_filename = tempfile.mkstemp(suffix='.d')
+        os.close(dep_fd)
+        cpp_args += ['-MD', '-MF', dep_filename]
+
+        n_comments = len(self._scanner.get_comments())
+        try:
+            self._run_cpp(cpp_args, defines, undefs, filenames)
+            self._store_cache(cachestore, cache_key, dep_filename, n_comments)
+        finally:
+            os.unlink(dep_filename)
+
+    def _get_cache_key(self, cpp_args, filenames):
+        # The headers themselves are among the dependencies checked by
+        # _load_cache(), so only the flags and names go into the key.
+        return 'symbols:' + '\0'.join([os.getcwd()] + cpp_args + ['--'] + filenames)
+
+    def _load_cache(self, cachestore, cache_key):
+        entry = cachestore.load_keyed(cache_key)
+        if entry is None:
+            return False
+
+        for filename, mtime, size, digest in entry['dependencies']:
+            try:
+                stat = os.stat(filename)
+            except OSError:
+                return False
+            if stat.st_mtime == mtime and stat.st_size == size:
+                continue
+            # Touched, but possibly not modified
+            if stat.st_size != size or _hash_file(filename) != digest:
+                return False
+
+        self._cached_symbols = entry['symbols']
+        self._cached_comments = entry['comments']
+        return True
+
+    def _store_cache(self, cachestore, cache_key, dep_filename, n_comments):
+        try:
+            dependencies = []
+            for filename in _read_depfile(dep_filename):
+                if filename == '-':
+                    continue
+                stat = os.stat(filename)
+                dependencies.append((os.path.realpath(filename), stat.st_mtime,
+                                     stat.st_size, _hash_file(filename)))
+        except (IOError, OSError) as e:
+            # No usable dependency list, just don't cache the result
+            if e.errno in (errno.ENOENT, errno.EACCES):
+                return
+            raise
+
+        # Only the headers have been parsed so far; the sources were
+        # lexed for their comments before, and those are kept out.
+        entry = {'dependencies': dependencies,
+                 'symbols': [_CachedSymbol(symbol)
+                             for symbol in self._scanner.get_symbols()],
+                 'comments': self._scanner.get_comments()[n_comments:]}
+        cachestore.store_keyed(cache_key, entry)
+
+    def _run_cpp(self, cpp_args, defines, undefs, filenames):
+        if self._macros_captured:
+            self._scanner.set_capture_macros(True)
+
         proc = subprocess.Popen(cpp_args,
                                 stdin=subprocess.PIPE,
                                 stdout=subprocess.PIPE)
@@ -316,7 +477,27 @@ class SourceScanner(object):
             proc.stdin.write('#include <%s>\n' % (filename, ))
         proc.stdin.close()
 
-        tmp_fd, tmp_name = tempfile.mkstemp()
+        if utils.have_debug_flag('cpp-tempfile'):
+            self._parse_tempfile(proc)
+        else:
+            # Lex the preprocessed source straight from the pipe, while cpp
+            # is still producing it.
+            self._scanner.parse_file(proc.stdout.fileno())
+            # Should the parser stop early, don't let cpp die of SIGPIPE
+            proc.stdout.read()
+            proc.stdout.close()
+
+            proc.wait()
+            if proc.returncode != 0:
+                raise SystemExit('Error while processing the source.')
+
+        if self._macros_captured:
+            self._scanner.set_macro_scan(True)
+            self._scanner.parse_captured_macros()
+            self._scanner.set_macro_scan(False)
+
+    def _parse_tempfile(self, proc):
+        tmp_fd, tmp_name = tempfile.mkstemp(suffix='.i')
         fp = os.fdopen(tmp_fd, 'w+b')
         while True:
             data = proc.stdout.read(4096)
@@ -334,4 +515,5 @@ class SourceScanner(object):
 
         self._scanner.parse_file(fp.fileno())
         fp.close()
-        os.unlink(tmp_name)
+        if not utils.have_debug_flag('save-temps'):
+            os.unlink(tmp_name)
@@ -202,32 +202,44 @@ None."""
         if extra_include_dirs is not None:
             self.set_include_paths(extra_include_dirs)
         self.set_passthrough_mode()
-        parser = self._parse_include(filename)
-        self._namespace = parser.get_namespace()
+        self._namespace = self._parse_include(filename)
         del self._parsed_includes[self._namespace.name]
         return self
 
     def _parse_include(self, filename, uninstalled=False):
-        parser = None
-        if self._cachestore is not None:
-            parser = self._cachestore.load(filename)
-        if parser is None:
+        namespace = self._load_cached_include(filename)
+        if namespace is None:
             parser = GIRParser(types_only=not self._passthrough_mode)
             parser.parse(filename)
+            namespace = parser.get_namespace()
             if self._cachestore is not None:
-                self._cachestore.store(filename, parser)
+                if self._passthrough_mode:
+                    self._cachestore.store(filename, parser)
+                else:
+                    self._cachestore.store_namespace(filename, namespace)
 
-        for include in parser.get_namespace().includes:
+        for include in namespace.includes:
             if include.name not in self._parsed_includes:
                 dep_filename = self._find_include(include)
                 self._parse_include(dep_filename)
 
         if not uninstalled:
-            for pkg in parser.get_namespace().exported_packages:
+            for pkg in namespace.exported_packages:
                 self._pkg_config_packages.add(pkg)
-        namespace = parser.get_namespace()
         self._parsed_includes[namespace.name] = namespace
-        return parser
+        return namespace
+
+    def _load_cached_include(self, filename):
+        if self._cachestore is None:
+            return None
+        # Only the types are needed from includes, which can be looked
+        # up without loading the whole namespace.
+        if not self._passthrough_mode:
+            return self._cachestore.load_namespace(filename)
+        parser = self._cachestore.load(filename)
+        if parser is None:
+            return None
+        return parser.get_namespace()
 
     def _iter_namespaces(self):
         """Return an iterator over all included namespaces; the
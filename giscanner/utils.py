@@ -22,6 +22,9 @@ import re
 import os
 import subprocess
 import platform
+import sys
+import time
+from contextlib import contextmanager
 
 
 _debugflags = None
@@ -34,6 +37,13 @@ Well-known flags:
  * exception: Drop into debugger on fatalexception
  * warning: Drop into debugger on warning
  * posttrans: Drop into debugger just before introspectable pass
+ * cpp-tempfile: Spool the preprocessor output to a temporary file
+   before parsing it, instead of parsing it from the pipe
+ * macro-rescan: Find #define constants by reading the headers again
+   instead of capturing them from the preprocessor output
+ * timing: Print the time spent in each scanner phase to stderr
+ * no-dumper-fallback: Fail instead of compiling a dumper program when
+   g-ir-dumper cannot load the library
 """
     global _debugflags
     if _debugflags is None:
@@ -48,6 +58,21 @@ def break_on_debug_flag(flag):
         import pdb
         pdb.set_trace()
 
+
+@contextmanager
+def debug_timing(phase):
+    """Report the wall clock time spent in the body of the with
+statement, when the 'timing' debug flag is enabled."""
+    if not have_debug_flag('timing'):
+        yield
+        return
+    start = time.time()
+    try:
+        yield
+    finally:
+        sys.stderr.write("g-ir-scanner: timing: %s: %.3fs\n"
+                         % (phase, time.time() - start))
+
 # Copied from h2defs.py
 _upperstr_pat1 = re.compile(r'([^A-Z])([A-Z])')
 _upperstr_pat2 = re.compile(r'([A-Z][A-Z])([A-Z][0-9a-z])')
@@ -103,6 +128,21 @@ def _extract_libdir_field(la_file):
         return None
 
 
+_libtool_dependency_libs_pat = re.compile("dependency_libs='([^']*)'")
+
+
+# Returns the libtool archives the library of this .la file links to;
+# libraries given as -l flags are left out
+def extract_libtool_dependencies(la_file):
+    f = open(la_file)
+    data = f.read()
+    f.close()
+    m = _libtool_dependency_libs_pat.search(data)
+    if not m:
+        return []
+    return [arg for arg in m.groups()[0].split() if arg.endswith('.la')]
+
+
 # Returns the name that we would pass to dlopen() the library
 # corresponding to this .la file
 def extract_libtool_shlib(la_file):
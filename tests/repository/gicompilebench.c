@@ -0,0 +1,127 @@
+#include "girparser.h"
+#include "girmodule.h"
+
+#include <stdlib.h>
+
+/* gitestcompile is built from this file with fewer entries */
+#ifndef DEFAULT_ENTRIES
+#define DEFAULT_ENTRIES 20000
+#endif
+
+/* Used by the parser, normally defined by g-ir-compiler */
+GLogLevelFlags logged_levels;
+
+static void
+log_handler (const gchar    *log_domain,
+             GLogLevelFlags  log_level,
+             const gchar    *message,
+             gpointer        user_data)
+{
+  if (log_level & logged_levels)
+    g_log_default_handler (log_domain, log_level, message, user_data);
+}
+
+/* Records pointing at other records, and functions taking records of
+ * another namespace, so that both local lookups and cross references
+ * are exercised. */
+static gchar *
+generate_gir (guint n_entries)
+{
+  GString *gir;
+  guint i;
+
+  gir = g_string_new ("<?xml version=\"1.0\"?>\n"
+                      "<repository version=\"1.2\"\n"
+                      "            xmlns=\"http://www.gtk.org/introspection/core/1.0\"\n"
+                      "            xmlns:c=\"http://www.gtk.org/introspection/c/1.0\">\n"
+                      "  <namespace name=\"Bench\" version=\"1.0\"\n"
+                      "             c:identifier-prefixes=\"Bench\" c:symbol-prefixes=\"bench\">\n");
+
+  for (i = 0; i < n_entries; i++)
+    {
+      guint other = (i * 7 + 1) % n_entries;
+
+      if (i % 2 == 0)
+        g_string_append_printf (gir,
+                                "    <record name=\"Rec%u\" c:type=\"BenchRec%u\">\n"
+                                "      <field name=\"next\" writable=\"1\">\n"
+                                "        <type name=\"Rec%u\" c:type=\"BenchRec%u*\"/>\n"
+                                "      </field>\n"
+                                "      <field name=\"value\" writable=\"1\">\n"
+                                "        <type name=\"gint\" c:type=\"gint\"/>\n"
+                                "      </field>\n"
+                                "    </record>\n",
+                                i, i, other & ~1, other & ~1);
+      else
+        g_string_append_printf (gir,
+                                "    <function name=\"func%u\" c:identifier=\"bench_func%u\">\n"
+                                "      <return-value transfer-ownership=\"none\">\n"
+                                "        <type name=\"Rec%u\" c:type=\"BenchRec%u*\"/>\n"
+                                "      </return-value>\n"
+                                "      <parameters>\n"
+                                "        <parameter name=\"thing\" transfer-ownership=\"none\">\n"
+                                "          <type name=\"Other.Thing%u\" c:type=\"OtherThing%u*\"/>\n"
+                                "        </parameter>\n"
+                                "      </parameters>\n"
+                                "    </function>\n",
+                                i, i, other & ~1, other & ~1, (i / 2) % 1000, (i / 2) % 1000);
+    }
+
+  g_string_append (gir, "  </namespace>\n</repository>\n");
+
+  return g_string_free (gir, FALSE);
+}
+
+int
+main(int argc, char **argv)
+{
+  GIrParser *parser;
+  GIrModule *module;
+  GITypelib *typelib;
+  GError *error = NULL;
+  GTimer *timer;
+  gdouble parse_time, build_time;
+  guint n_entries = DEFAULT_ENTRIES;
+  gchar *gir;
+
+  if (argc > 1)
+    n_entries = strtoul (argv[1], NULL, 10);
+
+  logged_levels = G_LOG_LEVEL_MASK & ~(G_LOG_LEVEL_MESSAGE|G_LOG_LEVEL_DEBUG);
+  g_log_set_default_handler (log_handler, NULL);
+
+  gir = generate_gir (n_entries);
+
+  timer = g_timer_new ();
+
+  parser = _g_ir_parser_new ();
+  module = _g_ir_parser_parse_string (parser, "Bench", NULL, gir, -1, &error);
+  g_assert_no_error (error);
+  g_assert (module != NULL);
+  g_assert_cmpuint (g_list_length (module->entries), ==, n_entries);
+
+  parse_time = g_timer_elapsed (timer, NULL);
+  g_timer_start (timer);
+
+  typelib = _g_ir_module_build_typelib (module);
+  g_assert (typelib != NULL);
+
+  build_time = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  g_assert (g_typelib_validate (typelib, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (((Header *)typelib->data)->n_local_entries, ==, n_entries);
+  /* One cross reference per distinct foreign type */
+  g_assert_cmpuint (((Header *)typelib->data)->n_entries, ==,
+                    n_entries + MIN (n_entries / 2, 1000));
+
+  g_print ("%u entries: parsed in %.3f s, built in %.3f s\n",
+           n_entries, parse_time, build_time);
+
+  g_typelib_free (typelib);
+  _g_ir_parser_free (parser);
+  g_free (gir);
+
+  exit(0);
+}
@@ -0,0 +1,145 @@
+#include "girepository.h"
+
+#include <stdlib.h>
+
+/* gitestinvoke is built from this file with only a few iterations */
+#ifndef DEFAULT_ITERATIONS
+#define DEFAULT_ITERATIONS 200000
+#endif
+
+static void
+report (const char *what, guint iterations, gdouble seconds)
+{
+  g_print ("%-32s %10.0f calls/sec\n", what,
+           seconds > 0 ? iterations / seconds : 0.0);
+}
+
+static void
+bench_invoke (GIFunctionInfo *info, guint iterations)
+{
+  GIArgument in_arg[1];
+  GIArgument ret_arg;
+  GError *error = NULL;
+  GTimer *timer;
+  guint i;
+
+  in_arg[0].v_int8 = '7';
+
+  timer = g_timer_new ();
+  for (i = 0; i < iterations; i++)
+    {
+      if (!g_function_info_invoke (info, in_arg, 1, NULL, 0, &ret_arg, &error))
+        g_error ("invoke failed: %s", error->message);
+      g_assert (ret_arg.v_int32 == 7);
+    }
+  g_timer_stop (timer);
+
+  report ("g_function_info_invoke", iterations, g_timer_elapsed (timer, NULL));
+  g_timer_destroy (timer);
+}
+
+static void
+bench_prepared (GIFunctionInfo *info, guint iterations)
+{
+  GIPreparedCallable *prepared;
+  GIArgument in_arg[1];
+  GIArgument ret_arg;
+  GError *error = NULL;
+  GTimer *timer;
+  guint i;
+
+  prepared = g_function_info_prepare (info, &error);
+  g_assert_no_error (error);
+  g_assert (prepared != NULL);
+
+  in_arg[0].v_int8 = '7';
+
+  timer = g_timer_new ();
+  for (i = 0; i < iterations; i++)
+    {
+      if (!g_prepared_callable_invoke (prepared, in_arg, 1, NULL, 0,
+                                       &ret_arg, &error))
+        g_error ("invoke failed: %s", error->message);
+      g_assert (ret_arg.v_int32 == 7);
+    }
+  g_timer_stop (timer);
+
+  report ("g_prepared_callable_invoke", iterations,
+          g_timer_elapsed (timer, NULL));
+  g_timer_destroy (timer);
+
+  g_prepared_callable_free (prepared);
+}
+
+static void
+test_prepared_errors (GIRepository *repo)
+{
+  GIBaseInfo *info;
+  GIPreparedCallable *prepared;
+  GIArgument in_arg[2];
+  GIArgument ret_arg;
+  GError *error = NULL;
+
+  /* Argument count mismatch */
+  info = g_irepository_find_by_name (repo, "GLib", "ascii_digit_value");
+  g_assert (info != NULL);
+  prepared = g_function_info_prepare ((GIFunctionInfo *)info, &error);
+  g_assert_no_error (error);
+
+  in_arg[0].v_int8 = '1';
+  in_arg[1].v_int8 = '2';
+  g_assert (!g_prepared_callable_invoke (prepared, in_arg, 2, NULL, 0,
+                                         &ret_arg, &error));
+  g_assert_error (error, G_INVOKE_ERROR, G_INVOKE_ERROR_ARGUMENT_MISMATCH);
+  g_clear_error (&error);
+
+  g_prepared_callable_free (prepared);
+  g_base_info_unref (info);
+
+  /* GError propagation through the throws slot */
+  info = g_irepository_find_by_name (repo, "GLib", "file_read_link");
+  g_assert (info != NULL);
+  prepared = g_function_info_prepare ((GIFunctionInfo *)info, &error);
+  g_assert_no_error (error);
+
+  in_arg[0].v_string = "non-existent-file/hope";
+  g_assert (!g_prepared_callable_invoke (prepared, in_arg, 1, NULL, 0,
+                                         &ret_arg, &error));
+  g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+  g_clear_error (&error);
+
+  g_prepared_callable_free (prepared);
+  g_base_info_unref (info);
+}
+
+int
+main(int argc, char **argv)
+{
+  GIRepository *repo;
+  GITypelib *ret;
+  GIBaseInfo *info;
+  GError *error = NULL;
+  guint iterations = DEFAULT_ITERATIONS;
+
+  if (argc > 1)
+    iterations = strtoul (argv[1], NULL, 10);
+
+  repo = g_irepository_get_default ();
+
+  ret = g_irepository_require (repo, "GLib", NULL, 0, &error);
+  g_assert (ret != NULL);
+  g_assert_no_error (error);
+
+  test_prepared_errors (repo);
+
+  info = g_irepository_find_by_name (repo, "GLib", "ascii_digit_value");
+  g_assert (info != NULL);
+  g_assert (g_base_info_get_type (info) == GI_INFO_TYPE_FUNCTION);
+
+  bench_invoke ((GIFunctionInfo *)info, iterations);
+  bench_prepared ((GIFunctionInfo *)info, iterations);
+
+  g_base_info_unref (info);
+
+  exit(0);
+}
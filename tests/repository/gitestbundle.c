@@ -0,0 +1,171 @@
+#include "girepository.h"
+#include "gitypelib-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+/* Built by the Makefile with g-ir-compiler --bundle */
+#define BUNDLE "Gio-2.0.bundle"
+
+static void
+test_load (void)
+{
+  GIRepository *repo;
+  GError *error = NULL;
+  GIBaseInfo *info;
+  GITypelib *typelib;
+
+  repo = g_object_new (G_TYPE_IREPOSITORY, NULL);
+
+  g_assert (g_irepository_load_bundle (repo, BUNDLE, 0, &error));
+  g_assert_no_error (error);
+
+  /* Dependencies are registered from the bundle as well */
+  g_assert (g_irepository_is_registered (repo, "GLib", "2.0"));
+  g_assert_cmpstr (g_irepository_get_typelib_path (repo, "GLib"), ==, BUNDLE);
+  g_assert_cmpstr (g_irepository_get_typelib_path (repo, "GObject"), ==, BUNDLE);
+  g_assert_cmpstr (g_irepository_get_typelib_path (repo, "Gio"), ==, BUNDLE);
+
+  typelib = g_irepository_require (repo, "GObject", NULL, 0, &error);
+  g_assert_no_error (error);
+  g_assert (typelib != NULL);
+  g_assert_cmpstr (g_irepository_get_version (repo, "GObject"), ==, "2.0");
+
+  info = g_irepository_find_by_name (repo, "Gio", "File");
+  g_assert (info != NULL);
+  g_assert_cmpint (g_base_info_get_type (info), ==, GI_INFO_TYPE_INTERFACE);
+  g_base_info_unref (info);
+
+  g_object_unref (repo);
+}
+
+typedef void (*CorruptFunc) (guint8 *data, gsize *len);
+
+static void
+truncate_half (guint8 *data, gsize *len)
+{
+  *len /= 2;
+}
+
+static void
+truncate_table (guint8 *data, gsize *len)
+{
+  BundleHeader *header = (BundleHeader *) data;
+
+  *len = header->entries + sizeof (BundleEntry);
+  header->size = *len;
+}
+
+static void
+break_magic (guint8 *data, gsize *len)
+{
+  data[0] = 'X';
+}
+
+static void
+break_entry_size (guint8 *data, gsize *len)
+{
+  BundleHeader *header = (BundleHeader *) data;
+  BundleEntry *entries = (BundleEntry *) (data + header->entries);
+
+  entries[header->n_entries - 1].size = header->size;
+}
+
+static void
+break_entry_name (guint8 *data, gsize *len)
+{
+  BundleHeader *header = (BundleHeader *) data;
+  BundleEntry *entries = (BundleEntry *) (data + header->entries);
+
+  entries[0].name = header->size;
+}
+
+static void
+break_order (guint8 *data, gsize *len)
+{
+  BundleHeader *header = (BundleHeader *) data;
+  BundleEntry *entries = (BundleEntry *) (data + header->entries);
+  BundleEntry tmp;
+
+  tmp = entries[0];
+  entries[0] = entries[1];
+  entries[1] = tmp;
+}
+
+/* Found only once the earlier typelibs were checked */
+static void
+break_last_typelib (guint8 *data, gsize *len)
+{
+  BundleHeader *header = (BundleHeader *) data;
+  BundleEntry *entries = (BundleEntry *) (data + header->entries);
+
+  data[entries[header->n_entries - 1].offset] = 'X';
+}
+
+static void
+check_rejected (const guint8 *contents,
+                gsize         length,
+                const gchar  *path,
+                CorruptFunc   corrupt)
+{
+  GIRepository *repo;
+  GError *error = NULL;
+  guint8 *data;
+  gsize len = length;
+
+  data = g_memdup (contents, length);
+  corrupt (data, &len);
+  g_assert (g_file_set_contents (path, (gchar *) data, len, &error));
+  g_assert_no_error (error);
+  g_free (data);
+
+  repo = g_object_new (G_TYPE_IREPOSITORY, NULL);
+  g_assert (!g_irepository_load_bundle (repo, path, 0, &error));
+  g_assert (error != NULL);
+  g_assert (error->domain == G_TYPELIB_ERROR);
+  g_clear_error (&error);
+  /* Nothing of a rejected bundle is registered */
+  g_assert (!g_irepository_is_registered (repo, "GLib", NULL));
+  g_object_unref (repo);
+}
+
+static void
+test_corrupt (void)
+{
+  static const CorruptFunc corruptions[] = {
+    truncate_half, truncate_table, break_magic,
+    break_entry_size, break_entry_name, break_order, break_last_typelib
+  };
+  GError *error = NULL;
+  gchar *contents, *tmpdir, *path;
+  gsize length;
+  guint i;
+
+  g_assert (g_file_get_contents (BUNDLE, &contents, &length, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (((BundleHeader *) contents)->n_entries, ==, 3);
+
+  tmpdir = g_dir_make_tmp ("gitestbundle-XXXXXX", &error);
+  g_assert_no_error (error);
+  path = g_build_filename (tmpdir, "corrupt.bundle", NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (corruptions); i++)
+    check_rejected ((guint8 *) contents, length, path, corruptions[i]);
+
+  g_unlink (path);
+  g_rmdir (tmpdir);
+  g_free (path);
+  g_free (tmpdir);
+  g_free (contents);
+}
+
+int
+main(int argc, char **argv)
+{
+  test_load ();
+  test_corrupt ();
+
+  exit(0);
+}
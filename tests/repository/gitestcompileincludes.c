@@ -0,0 +1,259 @@
+#include "girparser.h"
+#include "girmodule.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+/* Used by the parser, normally defined by g-ir-compiler */
+GLogLevelFlags logged_levels;
+
+#define GIR_HEADER \
+  "<?xml version=\"1.0\"?>\n" \
+  "<repository version=\"1.2\"\n" \
+  "            xmlns=\"http://www.gtk.org/introspection/core/1.0\"\n" \
+  "            xmlns:c=\"http://www.gtk.org/introspection/c/1.0\"\n" \
+  "            xmlns:glib=\"http://www.gtk.org/introspection/glib/1.0\">\n"
+
+/* Compiled to a typelib which is used in place of the GIR */
+static const gchar inc_gir[] =
+  GIR_HEADER
+  "  <include name=\"GObject\" version=\"2.0\"/>\n"
+  "  <namespace name=\"Inc\" version=\"1.0\"\n"
+  "             c:identifier-prefixes=\"Inc\" c:symbol-prefixes=\"inc\">\n"
+  "    <alias name=\"Size\" c:type=\"IncSize\">\n"
+  "      <type name=\"guint64\" c:type=\"guint64\"/>\n"
+  "    </alias>\n"
+  "    <alias name=\"PairAlias\" c:type=\"IncPairAlias\">\n"
+  "      <type name=\"Pair\" c:type=\"IncPair\"/>\n"
+  "    </alias>\n"
+  "    <record name=\"Pair\" c:type=\"IncPair\">\n"
+  "      <field name=\"a\" writable=\"1\">\n"
+  "        <type name=\"gint8\" c:type=\"gint8\"/>\n"
+  "      </field>\n"
+  "      <field name=\"b\" writable=\"1\">\n"
+  "        <type name=\"gdouble\" c:type=\"gdouble\"/>\n"
+  "      </field>\n"
+  "    </record>\n"
+  "    <record name=\"Holder\" c:type=\"IncHolder\">\n"
+  "      <field name=\"object\" writable=\"1\">\n"
+  "        <type name=\"GObject.Object\" c:type=\"GObject\"/>\n"
+  "      </field>\n"
+  "      <field name=\"flag\" writable=\"1\">\n"
+  "        <type name=\"gchar\" c:type=\"gchar\"/>\n"
+  "      </field>\n"
+  "    </record>\n"
+  "  </namespace>\n"
+  "</repository>\n";
+
+/* Compiled to a typelib without the alias section, so the GIR must be
+ * parsed instead */
+static const gchar bare_gir[] =
+  GIR_HEADER
+  "  <include name=\"GLib\" version=\"2.0\"/>\n"
+  "  <namespace name=\"Bare\" version=\"1.0\"\n"
+  "             c:identifier-prefixes=\"Bare\" c:symbol-prefixes=\"bare\">\n"
+  "    <alias name=\"Size\" c:type=\"BareSize\">\n"
+  "      <type name=\"guint16\" c:type=\"guint16\"/>\n"
+  "    </alias>\n"
+  "    <record name=\"Node\" c:type=\"BareNode\">\n"
+  "      <field name=\"list\" writable=\"1\">\n"
+  "        <type name=\"GLib.List\" c:type=\"GList\"/>\n"
+  "      </field>\n"
+  "      <field name=\"size\" writable=\"1\">\n"
+  "        <type name=\"Size\" c:type=\"BareSize\"/>\n"
+  "      </field>\n"
+  "    </record>\n"
+  "  </namespace>\n"
+  "</repository>\n";
+
+/* Embeds types of all of the above */
+static const gchar main_gir[] =
+  GIR_HEADER
+  "  <include name=\"GLib\" version=\"2.0\"/>\n"
+  "  <include name=\"GObject\" version=\"2.0\"/>\n"
+  "  <include name=\"Inc\" version=\"1.0\"/>\n"
+  "  <include name=\"Bare\" version=\"1.0\"/>\n"
+  "  <namespace name=\"Main\" version=\"1.0\"\n"
+  "             c:identifier-prefixes=\"Main\" c:symbol-prefixes=\"main\">\n"
+  "    <record name=\"Everything\" c:type=\"MainEverything\">\n"
+  "      <field name=\"tag\" writable=\"1\">\n"
+  "        <type name=\"gchar\" c:type=\"gchar\"/>\n"
+  "      </field>\n"
+  "      <field name=\"object\" writable=\"1\">\n"
+  "        <type name=\"GObject.Object\" c:type=\"GObject\"/>\n"
+  "      </field>\n"
+  "      <field name=\"value\" writable=\"1\">\n"
+  "        <type name=\"GObject.Value\" c:type=\"GValue\"/>\n"
+  "      </field>\n"
+  "      <field name=\"list\" writable=\"1\">\n"
+  "        <type name=\"GLib.List\" c:type=\"GList\"/>\n"
+  "      </field>\n"
+  "      <field name=\"small\" writable=\"1\">\n"
+  "        <type name=\"gint8\" c:type=\"gint8\"/>\n"
+  "      </field>\n"
+  "      <field name=\"pair\" writable=\"1\">\n"
+  "        <type name=\"Inc.PairAlias\" c:type=\"IncPairAlias\"/>\n"
+  "      </field>\n"
+  "      <field name=\"holder\" writable=\"1\">\n"
+  "        <type name=\"Inc.Holder\" c:type=\"IncHolder\"/>\n"
+  "      </field>\n"
+  "      <field name=\"inc_size\" writable=\"1\">\n"
+  "        <type name=\"Inc.Size\" c:type=\"IncSize\"/>\n"
+  "      </field>\n"
+  "      <field name=\"node\" writable=\"1\">\n"
+  "        <type name=\"Bare.Node\" c:type=\"BareNode\"/>\n"
+  "      </field>\n"
+  "      <field name=\"bare_size\" writable=\"1\">\n"
+  "        <type name=\"Bare.Size\" c:type=\"BareSize\"/>\n"
+  "      </field>\n"
+  "    </record>\n"
+  "    <function name=\"take\" c:identifier=\"main_take\">\n"
+  "      <return-value transfer-ownership=\"none\">\n"
+  "        <type name=\"Bare.Size\" c:type=\"BareSize\"/>\n"
+  "      </return-value>\n"
+  "      <parameters>\n"
+  "        <parameter name=\"size\" transfer-ownership=\"none\">\n"
+  "          <type name=\"Inc.Size\" c:type=\"IncSize\"/>\n"
+  "        </parameter>\n"
+  "      </parameters>\n"
+  "    </function>\n"
+  "  </namespace>\n"
+  "</repository>\n";
+
+static gchar *tmpdir;
+
+static GITypelib *
+compile (const gchar *namespace,
+         const gchar *gir,
+         gboolean     typelib_includes)
+{
+  const gchar *includes[] = { tmpdir, GIR_BUILDDIR, NULL };
+  GIrParser *parser;
+  GIrModule *module;
+  GITypelib *typelib;
+  GError *error = NULL;
+
+  parser = _g_ir_parser_new ();
+  _g_ir_parser_set_includes (parser, includes);
+  _g_ir_parser_set_typelib_includes (parser, typelib_includes);
+
+  module = _g_ir_parser_parse_string (parser, namespace, NULL, gir, -1, &error);
+  g_assert_no_error (error);
+  g_assert (module != NULL);
+
+  typelib = _g_ir_module_build_typelib (module);
+  g_assert (typelib != NULL);
+  g_assert (g_typelib_validate (typelib, &error));
+  g_assert_no_error (error);
+
+  _g_ir_parser_free (parser);
+
+  return typelib;
+}
+
+static void
+write_file (const gchar *name,
+            const gchar *contents,
+            gsize        length)
+{
+  GError *error = NULL;
+  gchar *path;
+
+  path = g_build_filename (tmpdir, name, NULL);
+  g_assert (g_file_set_contents (path, contents, length, &error));
+  g_assert_no_error (error);
+  g_free (path);
+}
+
+/* Turns @data into a typelib as written before the alias section
+ * existed */
+static void
+strip_aliases_section (guint8 *data)
+{
+  Header *header = (Header *) data;
+  Section *section = (Section *) &data[header->sections];
+
+  while (section->id != GI_SECTION_END && section->id != GI_SECTION_ALIASES)
+    section++;
+  g_assert_cmpint (section->id, ==, GI_SECTION_ALIASES);
+
+  /* The section table always ends with an unused entry */
+  for (; section->id != GI_SECTION_END; section++)
+    *section = *(section + 1);
+}
+
+static void
+write_include (const gchar *namespace,
+               const gchar *gir,
+               gboolean     with_aliases)
+{
+  GITypelib *typelib;
+  gchar *name;
+
+  name = g_strconcat (namespace, "-1.0.gir", NULL);
+  write_file (name, gir, strlen (gir));
+  g_free (name);
+
+  typelib = compile (namespace, gir, FALSE);
+  if (!with_aliases)
+    strip_aliases_section (typelib->data);
+  name = g_strconcat (namespace, "-1.0.typelib", NULL);
+  write_file (name, (gchar *) typelib->data, typelib->len);
+  g_free (name);
+  g_typelib_free (typelib);
+}
+
+static void
+remove_files (void)
+{
+  GDir *dir;
+  const gchar *name;
+
+  dir = g_dir_open (tmpdir, 0, NULL);
+  g_assert (dir != NULL);
+  while ((name = g_dir_read_name (dir)) != NULL)
+    {
+      gchar *path = g_build_filename (tmpdir, name, NULL);
+      g_unlink (path);
+      g_free (path);
+    }
+  g_dir_close (dir);
+  g_rmdir (tmpdir);
+}
+
+int
+main(int argc, char **argv)
+{
+  GITypelib *from_girs, *from_typelibs;
+  GError *error = NULL;
+
+  logged_levels = G_LOG_LEVEL_MASK & ~(G_LOG_LEVEL_MESSAGE|G_LOG_LEVEL_DEBUG);
+
+  tmpdir = g_dir_make_tmp ("gitestcompileincludes-XXXXXX", &error);
+  g_assert_no_error (error);
+
+  write_include ("Inc", inc_gir, TRUE);
+  write_include ("Bare", bare_gir, FALSE);
+  g_irepository_prepend_search_path (tmpdir);
+
+  from_girs = compile ("Main", main_gir, FALSE);
+  g_assert (!g_irepository_is_registered (NULL, "Inc", "1.0"));
+
+  from_typelibs = compile ("Main", main_gir, TRUE);
+  g_assert (g_irepository_is_registered (NULL, "Inc", "1.0"));
+  g_assert (g_irepository_is_registered (NULL, "GObject", "2.0"));
+  /* Loaded, but parsed from the GIR as its aliases are unknown */
+  g_assert (g_irepository_is_registered (NULL, "Bare", "1.0"));
+
+  g_assert_cmpuint (from_typelibs->len, ==, from_girs->len);
+  g_assert (memcmp (from_typelibs->data, from_girs->data, from_girs->len) == 0);
+
+  g_typelib_free (from_girs);
+  g_typelib_free (from_typelibs);
+  remove_files ();
+  g_free (tmpdir);
+
+  exit(0);
+}
@@ -0,0 +1,235 @@
+#include "girparser.h"
+#include "girmodule.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Used by the parser, normally defined by g-ir-compiler */
+GLogLevelFlags logged_levels;
+
+#define GIR_HEADER \
+  "<?xml version=\"1.0\"?>\n" \
+  "<repository version=\"1.2\"\n" \
+  "            xmlns=\"http://www.gtk.org/introspection/core/1.0\"\n" \
+  "            xmlns:c=\"http://www.gtk.org/introspection/c/1.0\">\n"
+
+#define INT_FIELD(name) \
+  "      <field name=\"" name "\" writable=\"1\">\n" \
+  "        <type name=\"gint\" c:type=\"gint\"/>\n" \
+  "      </field>\n"
+
+#define CALLBACK_FIELD(name) \
+  "      <field name=\"" name "\" writable=\"1\">\n" \
+  "        <callback name=\"" name "\">\n" \
+  "          <return-value transfer-ownership=\"none\">\n" \
+  "            <type name=\"none\" c:type=\"void\"/>\n" \
+  "          </return-value>\n" \
+  "          <parameters>\n" \
+  "            <parameter name=\"value\" transfer-ownership=\"none\">\n" \
+  "              <type name=\"gint\" c:type=\"gint\"/>\n" \
+  "            </parameter>\n" \
+  "          </parameters>\n" \
+  "        </callback>\n" \
+  "      </field>\n"
+
+#define METHOD(prefix) \
+  "      <method name=\"get\" c:identifier=\"" prefix "_rec_get\">\n" \
+  "        <return-value transfer-ownership=\"none\">\n" \
+  "          <type name=\"gint\" c:type=\"gint\"/>\n" \
+  "        </return-value>\n" \
+  "      </method>\n"
+
+static const gchar fixed_gir[] =
+  GIR_HEADER
+  "  <namespace name=\"Fixed\" version=\"1.0\"\n"
+  "             c:identifier-prefixes=\"Fixed\" c:symbol-prefixes=\"fixed\">\n"
+  "    <record name=\"Rec\" c:type=\"FixedRec\">\n"
+  INT_FIELD ("first")
+  INT_FIELD ("second")
+  INT_FIELD ("third")
+  METHOD ("fixed")
+  "    </record>\n"
+  "  </namespace>\n"
+  "</repository>\n";
+
+static const gchar embedded_gir[] =
+  GIR_HEADER
+  "  <namespace name=\"Embedded\" version=\"1.0\"\n"
+  "             c:identifier-prefixes=\"Embedded\" c:symbol-prefixes=\"embedded\">\n"
+  "    <record name=\"Rec\" c:type=\"EmbeddedRec\">\n"
+  INT_FIELD ("first")
+  CALLBACK_FIELD ("second")
+  INT_FIELD ("third")
+  METHOD ("embedded")
+  "    </record>\n"
+  "    <record name=\"Plain\" c:type=\"EmbeddedPlain\">\n"
+  INT_FIELD ("first")
+  INT_FIELD ("second")
+  "    </record>\n"
+  "  </namespace>\n"
+  "</repository>\n";
+
+static GITypelib *
+compile (const gchar *namespace,
+         const gchar *gir)
+{
+  GIrParser *parser;
+  GIrModule *module;
+  GITypelib *typelib;
+  GError *error = NULL;
+
+  parser = _g_ir_parser_new ();
+  module = _g_ir_parser_parse_string (parser, namespace, NULL, gir, -1, &error);
+  g_assert_no_error (error);
+  g_assert (module != NULL);
+
+  typelib = _g_ir_module_build_typelib (module);
+  g_assert (typelib != NULL);
+  _g_ir_parser_free (parser);
+
+  return typelib;
+}
+
+/* Returns the number of entries, followed by the entries */
+static guint32 *
+get_field_offsets (guint8 *data)
+{
+  Header *header = (Header *) data;
+  Section *section;
+
+  for (section = (Section *) &data[header->sections];
+       section->id != GI_SECTION_END;
+       section++)
+    if (section->id == GI_SECTION_FIELD_OFFSETS)
+      return (guint32 *) &data[section->offset];
+
+  return NULL;
+}
+
+static void
+check_rec (const gchar *namespace)
+{
+  static const gchar *field_names[] = { "first", "second", "third" };
+  GIStructInfo *info;
+  GIFieldInfo *field;
+  GIFunctionInfo *method;
+  gint i;
+
+  info = g_irepository_find_by_name (NULL, namespace, "Rec");
+  g_assert (info != NULL);
+
+  g_assert_cmpint (g_struct_info_get_n_fields (info), ==, G_N_ELEMENTS (field_names));
+  for (i = G_N_ELEMENTS (field_names) - 1; i >= 0; i--)
+    {
+      field = g_struct_info_get_field (info, i);
+      g_assert_cmpstr (g_base_info_get_name (field), ==, field_names[i]);
+      g_base_info_unref (field);
+    }
+
+  /* The methods follow the fields */
+  method = g_struct_info_get_method (info, 0);
+  g_assert_cmpstr (g_base_info_get_name (method), ==, "get");
+  g_base_info_unref (method);
+
+  g_base_info_unref (info);
+}
+
+static void
+check_invalid (const guint8 *data,
+               gsize         len)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+
+  typelib = g_typelib_new_from_memory (g_memdup (data, len), len, &error);
+  g_assert_no_error (error);
+  g_assert (!g_typelib_validate (typelib, &error));
+  g_assert_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID);
+  g_clear_error (&error);
+  g_typelib_free (typelib);
+}
+
+/* Without embedded types the section is empty, fields are found by
+ * their size */
+static void
+test_fixed (void)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+  guint32 *section;
+
+  typelib = compile ("Fixed", fixed_gir);
+  section = get_field_offsets (typelib->data);
+  g_assert (section != NULL);
+  g_assert_cmpuint (section[0], ==, 0);
+
+  g_assert (g_typelib_validate (typelib, &error));
+  g_assert_no_error (error);
+
+  g_assert (g_irepository_load_typelib (NULL, typelib, 0, &error) != NULL);
+  g_assert_no_error (error);
+  check_rec ("Fixed");
+}
+
+static void
+test_embedded (void)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+  guint8 *data;
+  guint32 *section;
+  FieldOffsetsEntry *entries;
+  guint32 *offsets;
+
+  typelib = compile ("Embedded", embedded_gir);
+  section = get_field_offsets (typelib->data);
+  g_assert (section != NULL);
+  /* Only Rec has a table */
+  g_assert_cmpuint (section[0], ==, 1);
+
+  g_assert (g_typelib_validate (typelib, &error));
+  g_assert_no_error (error);
+
+  /* A container with embedded types without a table */
+  data = g_memdup (typelib->data, typelib->len);
+  get_field_offsets (data)[0] = 0;
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* A table not matching the fields */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (FieldOffsetsEntry *) (get_field_offsets (data) + 1);
+  offsets = (guint32 *) &data[entries[0].offsets];
+  offsets[2] += sizeof (FieldBlob);
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* An entry for a blob out of bounds */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (FieldOffsetsEntry *) (get_field_offsets (data) + 1);
+  entries[0].blob = typelib->len;
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* A table out of bounds */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (FieldOffsetsEntry *) (get_field_offsets (data) + 1);
+  entries[0].offsets = typelib->len - sizeof (guint32);
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  g_assert (g_irepository_load_typelib (NULL, typelib, 0, &error) != NULL);
+  g_assert_no_error (error);
+  check_rec ("Embedded");
+}
+
+int
+main(int argc, char **argv)
+{
+  logged_levels = G_LOG_LEVEL_MASK & ~(G_LOG_LEVEL_MESSAGE|G_LOG_LEVEL_DEBUG);
+
+  test_fixed ();
+  test_embedded ();
+
+  exit(0);
+}
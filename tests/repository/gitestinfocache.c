@@ -0,0 +1,136 @@
+#include "girepository.h"
+
+#include <stdlib.h>
+
+#define DEFAULT_ITERATIONS 20
+
+/* Touches every method of every object, the way bindings do when
+ * they build their wrappers */
+static guint
+walk_objects (GIRepository *repo, const char *namespace)
+{
+  gint n_infos, i;
+  guint n_walked = 0;
+
+  n_infos = g_irepository_get_n_infos (repo, namespace);
+  for (i = 0; i < n_infos; i++)
+    {
+      GIBaseInfo *info = g_irepository_get_info (repo, namespace, i);
+      gint n_methods, j;
+
+      if (g_base_info_get_type (info) != GI_INFO_TYPE_OBJECT)
+        {
+          g_base_info_unref (info);
+          continue;
+        }
+
+      n_methods = g_object_info_get_n_methods ((GIObjectInfo *) info);
+      for (j = 0; j < n_methods; j++)
+        {
+          GIFunctionInfo *method;
+          GITypeInfo *return_type;
+
+          method = g_object_info_get_method ((GIObjectInfo *) info, j);
+          return_type = g_callable_info_get_return_type ((GICallableInfo *) method);
+          g_base_info_unref (return_type);
+          g_base_info_unref (method);
+          n_walked++;
+        }
+
+      g_base_info_unref (info);
+    }
+
+  return n_walked;
+}
+
+static gdouble
+bench_walk (GIRepository *repo, guint iterations)
+{
+  GTimer *timer;
+  gdouble elapsed;
+  guint i;
+
+  timer = g_timer_new ();
+  for (i = 0; i < iterations; i++)
+    g_assert (walk_objects (repo, "Gio") > 0);
+  elapsed = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  return elapsed;
+}
+
+int
+main(int argc, char **argv)
+{
+  GIRepository *repo;
+  GIBaseInfo *info, *info2;
+  GIFunctionInfo *method, *method2;
+  GError *error = NULL;
+  guint allocations, hits, evictions;
+  guint iterations = DEFAULT_ITERATIONS;
+  gdouble uncached_time, cached_time;
+
+  if (argc > 1)
+    iterations = strtoul (argv[1], NULL, 10);
+
+  repo = g_irepository_get_default ();
+
+  g_assert (g_irepository_require (repo, "Gio", NULL, 0, &error));
+  g_assert_no_error (error);
+
+  /* Disabled by default */
+  info = g_irepository_find_by_name (repo, "GObject", "Object");
+  info2 = g_irepository_find_by_name (repo, "GObject", "Object");
+  g_assert (info != NULL && info2 != NULL);
+  g_assert (info != info2);
+  g_base_info_unref (info);
+  g_base_info_unref (info2);
+
+  uncached_time = bench_walk (repo, iterations);
+
+  g_irepository_set_info_cache_size (repo, 100000);
+
+  info = g_irepository_find_by_name (repo, "GObject", "Object");
+  info2 = g_irepository_find_by_name (repo, "GObject", "Object");
+  g_assert (info == info2);
+  g_base_info_unref (info2);
+
+  /* Members of a canonical info are canonical too */
+  method = g_object_info_get_method ((GIObjectInfo *) info, 0);
+  method2 = g_object_info_get_method ((GIObjectInfo *) info, 0);
+  g_assert (method == method2);
+  g_assert (g_base_info_get_container (method) == info);
+  g_base_info_unref (method);
+  g_base_info_unref (method2);
+  g_base_info_unref (info);
+
+  g_irepository_get_info_cache_stats (repo, &allocations, &hits, &evictions);
+  g_assert_cmpuint (allocations, ==, 2);
+  g_assert_cmpuint (hits, ==, 2);
+  g_assert_cmpuint (evictions, ==, 0);
+
+  cached_time = bench_walk (repo, iterations);
+
+  g_irepository_get_info_cache_stats (repo, &allocations, &hits, &evictions);
+  g_assert_cmpuint (hits, >, allocations);
+  g_assert_cmpuint (evictions, ==, 0);
+
+  g_print ("walking Gio: %.3f s uncached, %.3f s cached, "
+           "%u infos allocated, %u hits\n",
+           uncached_time, cached_time, allocations, hits);
+
+  /* Shrinking the cache evicts the least recently used infos */
+  g_irepository_set_info_cache_size (repo, 10);
+  g_irepository_get_info_cache_stats (repo, NULL, NULL, &evictions);
+  g_assert_cmpuint (evictions, ==, allocations - 10);
+
+  walk_objects (repo, "Gio");
+  g_irepository_get_info_cache_stats (repo, &allocations, &hits, &evictions);
+  g_assert_cmpuint (evictions, ==, allocations - 10);
+
+  g_irepository_set_info_cache_size (repo, 0);
+  g_irepository_get_info_cache_stats (repo, &allocations, NULL, &evictions);
+  g_assert_cmpuint (evictions, ==, allocations);
+
+  exit(0);
+}
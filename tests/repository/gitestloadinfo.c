@@ -0,0 +1,257 @@
+#include "girepository.h"
+
+#include <stdlib.h>
+
+/* Checks that a stack allocated info initialized by one of the load
+ * functions describes the same thing as the one returned by the
+ * corresponding get function */
+static void
+check_same (GIBaseInfo *got, GIBaseInfo *loaded)
+{
+  g_assert (got != NULL);
+  g_assert_cmpint (g_base_info_get_type (got), ==, g_base_info_get_type (loaded));
+  g_assert_cmpstr (g_base_info_get_name (got), ==, g_base_info_get_name (loaded));
+  g_assert_cmpstr (g_base_info_get_namespace (got), ==, g_base_info_get_namespace (loaded));
+  if (g_base_info_get_type (got) != GI_INFO_TYPE_UNRESOLVED)
+    g_assert (g_base_info_equal (got, loaded));
+  g_base_info_unref (got);
+}
+
+static void
+check_type (GITypeInfo *type)
+{
+  GIBaseInfo loaded;
+  GITypeInfo loaded_type;
+  GIBaseInfo *iface;
+  GITypeInfo *param_type;
+
+  iface = g_type_info_get_interface (type);
+  g_assert (g_type_info_load_interface (type, &loaded) == (iface != NULL));
+  if (iface != NULL)
+    check_same (iface, &loaded);
+
+  param_type = g_type_info_get_param_type (type, 0);
+  g_assert (g_type_info_load_param_type (type, 0, &loaded_type) == (param_type != NULL));
+  if (param_type != NULL)
+    {
+      g_assert_cmpint (g_type_info_get_tag (param_type), ==, g_type_info_get_tag (&loaded_type));
+      g_base_info_unref (param_type);
+    }
+}
+
+static void
+check_callable (GICallableInfo *callable)
+{
+  GITypeInfo return_type;
+
+  g_callable_info_load_return_type (callable, &return_type);
+  check_type (&return_type);
+}
+
+static void
+check_object (GIObjectInfo *info)
+{
+  GIBaseInfo loaded;
+  gint i;
+
+  for (i = 0; i < g_object_info_get_n_interfaces (info); i++)
+    {
+      g_object_info_load_interface (info, i, (GIInterfaceInfo *) &loaded);
+      check_same (g_object_info_get_interface (info, i), &loaded);
+    }
+  for (i = 0; i < g_object_info_get_n_fields (info); i++)
+    {
+      GITypeInfo *type;
+
+      g_object_info_load_field (info, i, (GIFieldInfo *) &loaded);
+      check_same (g_object_info_get_field (info, i), &loaded);
+      type = g_field_info_get_type ((GIFieldInfo *) &loaded);
+      check_type (type);
+      g_base_info_unref (type);
+    }
+  for (i = 0; i < g_object_info_get_n_properties (info); i++)
+    {
+      g_object_info_load_property (info, i, (GIPropertyInfo *) &loaded);
+      check_same (g_object_info_get_property (info, i), &loaded);
+    }
+  for (i = 0; i < g_object_info_get_n_methods (info); i++)
+    {
+      g_object_info_load_method (info, i, (GIFunctionInfo *) &loaded);
+      check_same (g_object_info_get_method (info, i), &loaded);
+      check_callable ((GICallableInfo *) &loaded);
+    }
+  for (i = 0; i < g_object_info_get_n_signals (info); i++)
+    {
+      g_object_info_load_signal (info, i, (GISignalInfo *) &loaded);
+      check_same (g_object_info_get_signal (info, i), &loaded);
+    }
+  for (i = 0; i < g_object_info_get_n_vfuncs (info); i++)
+    {
+      g_object_info_load_vfunc (info, i, (GIVFuncInfo *) &loaded);
+      check_same (g_object_info_get_vfunc (info, i), &loaded);
+    }
+  for (i = 0; i < g_object_info_get_n_constants (info); i++)
+    {
+      g_object_info_load_constant (info, i, (GIConstantInfo *) &loaded);
+      check_same (g_object_info_get_constant (info, i), &loaded);
+    }
+}
+
+static void
+check_interface (GIInterfaceInfo *info)
+{
+  GIBaseInfo loaded;
+  gint i;
+
+  for (i = 0; i < g_interface_info_get_n_prerequisites (info); i++)
+    {
+      g_interface_info_load_prerequisite (info, i, &loaded);
+      check_same (g_interface_info_get_prerequisite (info, i), &loaded);
+    }
+  for (i = 0; i < g_interface_info_get_n_properties (info); i++)
+    {
+      g_interface_info_load_property (info, i, (GIPropertyInfo *) &loaded);
+      check_same (g_interface_info_get_property (info, i), &loaded);
+    }
+  for (i = 0; i < g_interface_info_get_n_methods (info); i++)
+    {
+      g_interface_info_load_method (info, i, (GIFunctionInfo *) &loaded);
+      check_same (g_interface_info_get_method (info, i), &loaded);
+      check_callable ((GICallableInfo *) &loaded);
+    }
+  for (i = 0; i < g_interface_info_get_n_signals (info); i++)
+    {
+      g_interface_info_load_signal (info, i, (GISignalInfo *) &loaded);
+      check_same (g_interface_info_get_signal (info, i), &loaded);
+    }
+  for (i = 0; i < g_interface_info_get_n_vfuncs (info); i++)
+    {
+      g_interface_info_load_vfunc (info, i, (GIVFuncInfo *) &loaded);
+      check_same (g_interface_info_get_vfunc (info, i), &loaded);
+    }
+  for (i = 0; i < g_interface_info_get_n_constants (info); i++)
+    {
+      g_interface_info_load_constant (info, i, (GIConstantInfo *) &loaded);
+      check_same (g_interface_info_get_constant (info, i), &loaded);
+    }
+}
+
+static void
+check_struct (GIStructInfo *info)
+{
+  GIBaseInfo loaded;
+  gint i;
+
+  for (i = 0; i < g_struct_info_get_n_fields (info); i++)
+    {
+      GITypeInfo *type;
+
+      g_struct_info_load_field (info, i, (GIFieldInfo *) &loaded);
+      check_same (g_struct_info_get_field (info, i), &loaded);
+      type = g_field_info_get_type ((GIFieldInfo *) &loaded);
+      check_type (type);
+      g_base_info_unref (type);
+    }
+  for (i = 0; i < g_struct_info_get_n_methods (info); i++)
+    {
+      g_struct_info_load_method (info, i, (GIFunctionInfo *) &loaded);
+      check_same (g_struct_info_get_method (info, i), &loaded);
+      check_callable ((GICallableInfo *) &loaded);
+    }
+}
+
+static void
+check_union (GIUnionInfo *info)
+{
+  GIBaseInfo loaded;
+  gint i;
+
+  for (i = 0; i < g_union_info_get_n_fields (info); i++)
+    {
+      g_union_info_load_field (info, i, (GIFieldInfo *) &loaded);
+      check_same (g_union_info_get_field (info, i), &loaded);
+    }
+  for (i = 0; i < g_union_info_get_n_methods (info); i++)
+    {
+      g_union_info_load_method (info, i, (GIFunctionInfo *) &loaded);
+      check_same (g_union_info_get_method (info, i), &loaded);
+    }
+}
+
+static void
+check_enum (GIEnumInfo *info)
+{
+  GIBaseInfo loaded;
+  gint i;
+
+  for (i = 0; i < g_enum_info_get_n_values (info); i++)
+    {
+      g_enum_info_load_value (info, i, (GIValueInfo *) &loaded);
+      check_same (g_enum_info_get_value (info, i), &loaded);
+    }
+  for (i = 0; i < g_enum_info_get_n_methods (info); i++)
+    {
+      g_enum_info_load_method (info, i, (GIFunctionInfo *) &loaded);
+      check_same (g_enum_info_get_method (info, i), &loaded);
+    }
+}
+
+static void
+check_namespace (GIRepository *repo, const char *namespace)
+{
+  gint n_infos, i;
+
+  n_infos = g_irepository_get_n_infos (repo, namespace);
+  g_assert (n_infos > 0);
+
+  for (i = 0; i < n_infos; i++)
+    {
+      GIBaseInfo *info = g_irepository_get_info (repo, namespace, i);
+
+      switch (g_base_info_get_type (info))
+        {
+        case GI_INFO_TYPE_OBJECT:
+          check_object ((GIObjectInfo *) info);
+          break;
+        case GI_INFO_TYPE_INTERFACE:
+          check_interface ((GIInterfaceInfo *) info);
+          break;
+        case GI_INFO_TYPE_STRUCT:
+          check_struct ((GIStructInfo *) info);
+          break;
+        case GI_INFO_TYPE_UNION:
+          check_union ((GIUnionInfo *) info);
+          break;
+        case GI_INFO_TYPE_ENUM:
+        case GI_INFO_TYPE_FLAGS:
+          check_enum ((GIEnumInfo *) info);
+          break;
+        case GI_INFO_TYPE_FUNCTION:
+          check_callable ((GICallableInfo *) info);
+          break;
+        default:
+          break;
+        }
+
+      g_base_info_unref (info);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  GIRepository *repo;
+  GError *error = NULL;
+
+  repo = g_irepository_get_default ();
+
+  g_assert (g_irepository_require (repo, "Gio", NULL, 0, &error));
+  g_assert_no_error (error);
+
+  /* Gio references GObject and GLib types, which exercises the
+   * resolution of entries of other namespaces */
+  check_namespace (repo, "Gio");
+  check_namespace (repo, "GObject");
+
+  exit(0);
+}
@@ -0,0 +1,179 @@
+#include "girepository.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static gdouble
+mixed_callback (gint         i,
+                gdouble      d,
+                const gchar *s,
+                gpointer     data)
+{
+  return i * 1000 + d + strlen (s) + GPOINTER_TO_INT (data);
+}
+
+static gint64
+int64_callback (gint64   a,
+                gint64   b,
+                gpointer data)
+{
+  return a * b + GPOINTER_TO_INT (data);
+}
+
+static gint
+object_callback (GObject  *object,
+                 gpointer  data)
+{
+  return GPOINTER_TO_INT (data) + (G_IS_INITIALLY_UNOWNED (object) ? 1 : 0);
+}
+
+static void
+init_mixed_params (GValue *params, gint i)
+{
+  g_value_init (&params[0], G_TYPE_INT);
+  g_value_set_int (&params[0], i);
+  g_value_init (&params[1], G_TYPE_DOUBLE);
+  g_value_set_double (&params[1], 0.25 * i);
+  g_value_init (&params[2], G_TYPE_STRING);
+  g_value_set_string (&params[2], i % 2 ? "odd" : "even");
+}
+
+static void
+init_int64_params (GValue *params, gint64 a)
+{
+  g_value_init (&params[0], G_TYPE_INT64);
+  g_value_set_int64 (&params[0], a);
+  g_value_init (&params[1], G_TYPE_INT64);
+  g_value_set_int64 (&params[1], a + G_GINT64_CONSTANT (0x100000000));
+}
+
+static void
+unset_params (GValue *params, guint n_params)
+{
+  guint i;
+
+  for (i = 0; i < n_params; i++)
+    g_value_unset (&params[i]);
+}
+
+/* Invokes closures using the signature cache, the pinned signature and
+ * the marshaller of GObject with the same arguments */
+static void
+test_mixed (void)
+{
+  GClosure *cached, *pinned, *reference;
+  gint i;
+
+  cached = g_cclosure_new (G_CALLBACK (mixed_callback), GINT_TO_POINTER (7), NULL);
+  g_closure_set_marshal (cached, gi_cclosure_marshal_generic);
+  pinned = g_cclosure_new (G_CALLBACK (mixed_callback), GINT_TO_POINTER (7), NULL);
+  gi_cclosure_pin_marshal_generic (pinned);
+  reference = g_cclosure_new (G_CALLBACK (mixed_callback), GINT_TO_POINTER (7), NULL);
+  g_closure_set_marshal (reference, g_cclosure_marshal_generic);
+
+  for (i = 0; i < 10; i++)
+    {
+      GValue params[3] = { G_VALUE_INIT, G_VALUE_INIT, G_VALUE_INIT };
+      GValue expected = G_VALUE_INIT, result = G_VALUE_INIT;
+
+      init_mixed_params (params, i);
+      g_value_init (&expected, G_TYPE_DOUBLE);
+      g_closure_invoke (reference, &expected, 3, params, NULL);
+
+      g_value_init (&result, G_TYPE_DOUBLE);
+      g_closure_invoke (cached, &result, 3, params, NULL);
+      g_assert_cmpfloat (g_value_get_double (&result), ==, g_value_get_double (&expected));
+
+      g_value_set_double (&result, 0);
+      g_closure_invoke (pinned, &result, 3, params, NULL);
+      g_assert_cmpfloat (g_value_get_double (&result), ==, g_value_get_double (&expected));
+
+      g_value_unset (&result);
+      g_value_unset (&expected);
+      unset_params (params, 3);
+    }
+
+  g_closure_unref (cached);
+  g_closure_unref (pinned);
+  g_closure_unref (reference);
+}
+
+/* A pinned closure first invoked without a return value must not keep
+ * using that signature once a return value is asked for */
+static void
+test_pinned_signature_change (void)
+{
+  GClosure *pinned, *reference;
+  GValue params[2] = { G_VALUE_INIT, G_VALUE_INIT };
+  GValue expected = G_VALUE_INIT, result = G_VALUE_INIT;
+
+  pinned = g_cclosure_new (G_CALLBACK (int64_callback), GINT_TO_POINTER (3), NULL);
+  gi_cclosure_pin_marshal_generic (pinned);
+  reference = g_cclosure_new (G_CALLBACK (int64_callback), GINT_TO_POINTER (3), NULL);
+  g_closure_set_marshal (reference, g_cclosure_marshal_generic);
+
+  init_int64_params (params, 5);
+  g_closure_invoke (pinned, NULL, 2, params, NULL);
+
+  g_value_init (&expected, G_TYPE_INT64);
+  g_closure_invoke (reference, &expected, 2, params, NULL);
+  g_value_init (&result, G_TYPE_INT64);
+  g_closure_invoke (pinned, &result, 2, params, NULL);
+  g_assert_cmpint (g_value_get_int64 (&result), ==, g_value_get_int64 (&expected));
+
+  g_value_unset (&result);
+  g_value_unset (&expected);
+  unset_params (params, 2);
+
+  g_closure_unref (pinned);
+  g_closure_unref (reference);
+}
+
+/* Values of another type with the same fundamental type miss the
+ * pinned types, and must still be passed correctly */
+static gint
+invoke_with_object (GClosure *closure,
+                    GType     type)
+{
+  GValue param = G_VALUE_INIT, result = G_VALUE_INIT;
+  GObject *object;
+  gint ret;
+
+  object = g_object_new (type, NULL);
+  g_value_init (&param, type);
+  g_value_set_object (&param, object);
+  g_value_init (&result, G_TYPE_INT);
+  g_closure_invoke (closure, &result, 1, &param, NULL);
+  ret = g_value_get_int (&result);
+
+  g_value_unset (&result);
+  g_value_unset (&param);
+  g_object_unref (g_object_ref_sink (object));
+
+  return ret;
+}
+
+static void
+test_pinned_derived_types (void)
+{
+  GClosure *pinned;
+
+  pinned = g_cclosure_new (G_CALLBACK (object_callback), GINT_TO_POINTER (3), NULL);
+  gi_cclosure_pin_marshal_generic (pinned);
+
+  g_assert_cmpint (invoke_with_object (pinned, G_TYPE_OBJECT), ==, 3);
+  g_assert_cmpint (invoke_with_object (pinned, G_TYPE_INITIALLY_UNOWNED), ==, 4);
+  g_assert_cmpint (invoke_with_object (pinned, G_TYPE_OBJECT), ==, 3);
+
+  g_closure_unref (pinned);
+}
+
+int
+main(int argc, char **argv)
+{
+  test_mixed ();
+  test_pinned_signature_change ();
+  test_pinned_derived_types ();
+
+  exit(0);
+}
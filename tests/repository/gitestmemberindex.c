@@ -0,0 +1,303 @@
+#include "girparser.h"
+#include "girmodule.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Used by the parser, normally defined by g-ir-compiler */
+GLogLevelFlags logged_levels;
+
+/* More than the compiler needs to index the members of a kind */
+#define N_MEMBERS 12
+
+static void
+append_methods (GString     *gir,
+                const gchar *prefix,
+                gint         n)
+{
+  gint i;
+
+  for (i = 0; i < n; i++)
+    g_string_append_printf (gir,
+                            "      <method name=\"method%d\" c:identifier=\"%s_method%d\">\n"
+                            "        <return-value transfer-ownership=\"none\">\n"
+                            "          <type name=\"none\" c:type=\"void\"/>\n"
+                            "        </return-value>\n"
+                            "      </method>\n",
+                            i, prefix, i);
+}
+
+static void
+append_signals_and_vfuncs (GString *gir)
+{
+  gint i;
+
+  for (i = 0; i < N_MEMBERS; i++)
+    g_string_append_printf (gir,
+                            "      <glib:signal name=\"signal%d\" when=\"last\">\n"
+                            "        <return-value transfer-ownership=\"none\">\n"
+                            "          <type name=\"none\" c:type=\"void\"/>\n"
+                            "        </return-value>\n"
+                            "      </glib:signal>\n"
+                            "      <virtual-method name=\"vfunc%d\">\n"
+                            "        <return-value transfer-ownership=\"none\">\n"
+                            "          <type name=\"none\" c:type=\"void\"/>\n"
+                            "        </return-value>\n"
+                            "      </virtual-method>\n",
+                            i, i);
+}
+
+/* An object, an interface, a record and a union with enough members
+ * to be indexed, and a record without */
+static gchar *
+build_gir (void)
+{
+  GString *gir = g_string_new (NULL);
+
+  g_string_append (gir,
+                   "<?xml version=\"1.0\"?>\n"
+                   "<repository version=\"1.2\"\n"
+                   "            xmlns=\"http://www.gtk.org/introspection/core/1.0\"\n"
+                   "            xmlns:c=\"http://www.gtk.org/introspection/c/1.0\"\n"
+                   "            xmlns:glib=\"http://www.gtk.org/introspection/glib/1.0\">\n"
+                   "  <namespace name=\"Members\" version=\"1.0\"\n"
+                   "             c:identifier-prefixes=\"Members\" c:symbol-prefixes=\"members\">\n");
+
+  g_string_append (gir,
+                   "    <class name=\"Obj\" c:type=\"MembersObj\"\n"
+                   "           glib:type-name=\"MembersObj\" glib:get-type=\"members_obj_get_type\">\n");
+  append_methods (gir, "members_obj", N_MEMBERS);
+  append_signals_and_vfuncs (gir);
+  g_string_append (gir, "    </class>\n");
+
+  g_string_append (gir,
+                   "    <interface name=\"Iface\" c:type=\"MembersIface\"\n"
+                   "               glib:type-name=\"MembersIface\" glib:get-type=\"members_iface_get_type\">\n");
+  append_methods (gir, "members_iface", N_MEMBERS);
+  append_signals_and_vfuncs (gir);
+  g_string_append (gir, "    </interface>\n");
+
+  g_string_append (gir, "    <record name=\"Rec\" c:type=\"MembersRec\">\n");
+  append_methods (gir, "members_rec", N_MEMBERS);
+  g_string_append (gir, "    </record>\n");
+
+  g_string_append (gir, "    <union name=\"Union\" c:type=\"MembersUnion\">\n");
+  append_methods (gir, "members_union", N_MEMBERS);
+  g_string_append (gir, "    </union>\n");
+
+  g_string_append (gir, "    <record name=\"Small\" c:type=\"MembersSmall\">\n");
+  append_methods (gir, "members_small", 2);
+  g_string_append (gir, "    </record>\n");
+
+  g_string_append (gir,
+                   "  </namespace>\n"
+                   "</repository>\n");
+
+  return g_string_free (gir, FALSE);
+}
+
+static GITypelib *
+compile (void)
+{
+  GIrParser *parser;
+  GIrModule *module;
+  GITypelib *typelib;
+  GError *error = NULL;
+  gchar *gir;
+
+  gir = build_gir ();
+  parser = _g_ir_parser_new ();
+  module = _g_ir_parser_parse_string (parser, "Members", NULL, gir, -1, &error);
+  g_assert_no_error (error);
+  g_assert (module != NULL);
+
+  typelib = _g_ir_module_build_typelib (module);
+  g_assert (typelib != NULL);
+  _g_ir_parser_free (parser);
+  g_free (gir);
+
+  return typelib;
+}
+
+/* Returns the number of entries, followed by the entries */
+static guint32 *
+get_member_index (guint8 *data)
+{
+  Header *header = (Header *) data;
+  Section *section;
+
+  for (section = (Section *) &data[header->sections];
+       section->id != GI_SECTION_END;
+       section++)
+    if (section->id == GI_SECTION_MEMBER_INDEX)
+      return (guint32 *) &data[section->offset];
+
+  return NULL;
+}
+
+static void
+check_invalid (const guint8 *data,
+               gsize         len)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+
+  typelib = g_typelib_new_from_memory (g_memdup (data, len), len, &error);
+  g_assert_no_error (error);
+  g_assert (!g_typelib_validate (typelib, &error));
+  g_assert_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID);
+  g_clear_error (&error);
+  g_typelib_free (typelib);
+}
+
+/* Every member must be found through the index, and only it */
+#define CHECK_FIND(info, get_n, get, find, format)              \
+  G_STMT_START {                                                \
+    gint i_, n_ = get_n (info);                                 \
+    g_assert_cmpint (n_, ==, N_MEMBERS);                        \
+    for (i_ = 0; i_ < n_; i_++)                                 \
+      {                                                         \
+        GIBaseInfo *member_, *found_;                           \
+        gchar *name_ = g_strdup_printf (format, i_);            \
+        member_ = (GIBaseInfo *) get (info, i_);                \
+        g_assert_cmpstr (g_base_info_get_name (member_), ==, name_); \
+        found_ = (GIBaseInfo *) find (info, name_);             \
+        g_assert (found_ != NULL);                              \
+        g_assert (g_base_info_equal (member_, found_));         \
+        g_base_info_unref (found_);                             \
+        g_base_info_unref (member_);                            \
+        g_free (name_);                                         \
+      }                                                         \
+    g_assert (find (info, "does_not_exist") == NULL);           \
+  } G_STMT_END
+
+static void
+check_lookups (void)
+{
+  GIBaseInfo *info;
+  GIFunctionInfo *method;
+
+  info = g_irepository_find_by_name (NULL, "Members", "Obj");
+  g_assert (info != NULL);
+  CHECK_FIND (info, g_object_info_get_n_methods, g_object_info_get_method,
+              g_object_info_find_method, "method%d");
+  CHECK_FIND (info, g_object_info_get_n_signals, g_object_info_get_signal,
+              g_object_info_find_signal, "signal%d");
+  CHECK_FIND (info, g_object_info_get_n_vfuncs, g_object_info_get_vfunc,
+              g_object_info_find_vfunc, "vfunc%d");
+  g_base_info_unref (info);
+
+  info = g_irepository_find_by_name (NULL, "Members", "Iface");
+  g_assert (info != NULL);
+  CHECK_FIND (info, g_interface_info_get_n_methods, g_interface_info_get_method,
+              g_interface_info_find_method, "method%d");
+  CHECK_FIND (info, g_interface_info_get_n_signals, g_interface_info_get_signal,
+              g_interface_info_find_signal, "signal%d");
+  CHECK_FIND (info, g_interface_info_get_n_vfuncs, g_interface_info_get_vfunc,
+              g_interface_info_find_vfunc, "vfunc%d");
+  g_base_info_unref (info);
+
+  info = g_irepository_find_by_name (NULL, "Members", "Rec");
+  g_assert (info != NULL);
+  CHECK_FIND (info, g_struct_info_get_n_methods, g_struct_info_get_method,
+              g_struct_info_find_method, "method%d");
+  g_base_info_unref (info);
+
+  info = g_irepository_find_by_name (NULL, "Members", "Union");
+  g_assert (info != NULL);
+  CHECK_FIND (info, g_union_info_get_n_methods, g_union_info_get_method,
+              g_union_info_find_method, "method%d");
+  g_base_info_unref (info);
+
+  /* Not indexed, found linearly */
+  info = g_irepository_find_by_name (NULL, "Members", "Small");
+  g_assert (info != NULL);
+  method = g_struct_info_find_method (info, "method1");
+  g_assert (method != NULL);
+  g_assert_cmpstr (g_base_info_get_name (method), ==, "method1");
+  g_base_info_unref (method);
+  g_assert (g_struct_info_find_method (info, "method2") == NULL);
+  g_base_info_unref (info);
+}
+
+int
+main(int argc, char **argv)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+  guint32 *section;
+  MemberIndexEntry *entries, swap;
+  guint8 *data;
+  gint i;
+
+  logged_levels = G_LOG_LEVEL_MASK & ~(G_LOG_LEVEL_MESSAGE|G_LOG_LEVEL_DEBUG);
+
+  typelib = compile ();
+  section = get_member_index (typelib->data);
+  g_assert (section != NULL);
+
+  /* Obj, Iface, Rec and Union, in directory order; not Small */
+  g_assert_cmpuint (section[0], ==, 4);
+  entries = (MemberIndexEntry *) (section + 1);
+  for (i = 0; i < 4; i++)
+    {
+      g_assert (entries[i].methods != 0);
+      if (i < 2)
+        {
+          g_assert (entries[i].signals != 0);
+          g_assert (entries[i].vfuncs != 0);
+        }
+      else
+        {
+          g_assert (entries[i].signals == 0);
+          g_assert (entries[i].vfuncs == 0);
+        }
+    }
+
+  g_assert (g_typelib_validate (typelib, &error));
+  g_assert_no_error (error);
+
+  /* Entries not sorted */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (MemberIndexEntry *) (get_member_index (data) + 1);
+  swap = entries[0];
+  entries[0] = entries[1];
+  entries[1] = swap;
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* An entry for a blob out of bounds */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (MemberIndexEntry *) (get_member_index (data) + 1);
+  entries[3].blob = typelib->len;
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* Signals of a record */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (MemberIndexEntry *) (get_member_index (data) + 1);
+  entries[2].signals = entries[0].signals;
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* A hash out of bounds */
+  data = g_memdup (typelib->data, typelib->len);
+  entries = (MemberIndexEntry *) (get_member_index (data) + 1);
+  entries[0].vfuncs = typelib->len - sizeof (guint32);
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  /* A hash overlapping the entries */
+  data = g_memdup (typelib->data, typelib->len);
+  section = get_member_index (data);
+  entries = (MemberIndexEntry *) (section + 1);
+  entries[1].methods = (guint8 *) section - data;
+  check_invalid (data, typelib->len);
+  g_free (data);
+
+  g_assert (g_irepository_load_typelib (NULL, typelib, 0, &error) != NULL);
+  g_assert_no_error (error);
+  check_lookups ();
+
+  exit(0);
+}
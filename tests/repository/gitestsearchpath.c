@@ -0,0 +1,58 @@
+#include "girepository.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+int
+main(int argc, char **argv)
+{
+  GIRepository *repo;
+  GError *error = NULL;
+  gchar *tmpdir, *contents, *copy;
+  const gchar *source;
+  gsize length;
+
+  /* Find a built typelib to copy */
+  g_assert (g_irepository_require (NULL, "Utility", "1.0", 0, &error));
+  g_assert_no_error (error);
+  source = g_irepository_get_typelib_path (NULL, "Utility");
+  g_assert (source != NULL);
+  g_assert (g_file_get_contents (source, &contents, &length, &error));
+  g_assert_no_error (error);
+
+  tmpdir = g_dir_make_tmp ("gitestsearchpath-XXXXXX", &error);
+  g_assert_no_error (error);
+  copy = g_build_filename (tmpdir, "Utility-1.0.typelib", NULL);
+
+  repo = g_object_new (G_TYPE_IREPOSITORY, NULL);
+
+  /* Lists the directory, which is still empty */
+  g_assert (g_irepository_require_private (repo, tmpdir, "Utility", NULL, 0, &error) == NULL);
+  g_assert_error (error, G_IREPOSITORY_ERROR, G_IREPOSITORY_ERROR_TYPELIB_NOT_FOUND);
+  g_clear_error (&error);
+
+  g_assert (g_file_set_contents (copy, contents, length, &error));
+  g_assert_no_error (error);
+
+  /* The listing is cached */
+  g_assert (g_irepository_require_private (repo, tmpdir, "Utility", NULL, 0, &error) == NULL);
+  g_assert_error (error, G_IREPOSITORY_ERROR, G_IREPOSITORY_ERROR_TYPELIB_NOT_FOUND);
+  g_clear_error (&error);
+
+  g_irepository_clear_search_path_cache (repo);
+
+  g_assert (g_irepository_require_private (repo, tmpdir, "Utility", NULL, 0, &error) != NULL);
+  g_assert_no_error (error);
+  g_assert_cmpstr (g_irepository_get_typelib_path (repo, "Utility"), ==, copy);
+
+  g_object_unref (repo);
+  g_unlink (copy);
+  g_rmdir (tmpdir);
+  g_free (copy);
+  g_free (tmpdir);
+  g_free (contents);
+
+  exit(0);
+}
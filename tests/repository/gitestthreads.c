@@ -0,0 +1,105 @@
+#include "girepository.h"
+
+#include <stdlib.h>
+
+#define N_READERS 8
+#define DEFAULT_ITERATIONS 20000
+
+static const char *requires[] = {
+  "Gio", "GIMarshallingTests", "Regress", "cairo", NULL
+};
+
+static guint iterations = DEFAULT_ITERATIONS;
+
+static gpointer
+reader_thread (gpointer data)
+{
+  GIRepository *repo = data;
+  gint n_glib_infos;
+  guint i;
+
+  n_glib_infos = g_irepository_get_n_infos (repo, "GLib");
+  g_assert (n_glib_infos > 0);
+
+  for (i = 0; i < iterations; i++)
+    {
+      GIBaseInfo *info;
+
+      g_assert (g_irepository_is_registered (repo, "GObject", NULL));
+
+      info = g_irepository_find_by_name (repo, "GObject", "Object");
+      g_assert (info != NULL);
+      g_base_info_unref (info);
+
+      info = g_irepository_find_by_gtype (repo, G_TYPE_OBJECT);
+      g_assert (info != NULL);
+      g_assert (g_base_info_get_type (info) == GI_INFO_TYPE_OBJECT);
+      g_base_info_unref (info);
+
+      info = g_irepository_get_info (repo, "GLib", i % n_glib_infos);
+      g_assert (info != NULL);
+      g_base_info_unref (info);
+    }
+
+  return NULL;
+}
+
+static gpointer
+require_thread (gpointer data)
+{
+  GIRepository *repo = data;
+  GError *error = NULL;
+  guint i;
+
+  /* Compete with the other require threads and the readers */
+  for (i = 0; requires[i] != NULL; i++)
+    {
+      if (!g_irepository_require (repo, requires[i], NULL, 0, &error))
+        g_error ("failed to require %s: %s", requires[i], error->message);
+    }
+
+  return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+  GIRepository *repo;
+  GThread *readers[N_READERS];
+  GThread *writers[2];
+  GError *error = NULL;
+  GTimer *timer;
+  gdouble elapsed;
+  guint i;
+
+  if (argc > 1)
+    iterations = strtoul (argv[1], NULL, 10);
+
+  repo = g_irepository_get_default ();
+
+  g_assert (g_irepository_require (repo, "GObject", NULL, 0, &error));
+  g_assert_no_error (error);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (writers); i++)
+    writers[i] = g_thread_new ("require", require_thread, repo);
+  for (i = 0; i < N_READERS; i++)
+    readers[i] = g_thread_new ("reader", reader_thread, repo);
+
+  for (i = 0; i < N_READERS; i++)
+    g_thread_join (readers[i]);
+  for (i = 0; i < G_N_ELEMENTS (writers); i++)
+    g_thread_join (writers[i]);
+
+  elapsed = g_timer_elapsed (timer, NULL);
+  g_timer_destroy (timer);
+
+  for (i = 0; requires[i] != NULL; i++)
+    g_assert (g_irepository_is_registered (repo, requires[i], NULL));
+
+  g_print ("%d threads: %.0f lookups/sec\n", N_READERS,
+           elapsed > 0 ? (N_READERS * iterations * 4) / elapsed : 0.0);
+
+  exit(0);
+}
@@ -0,0 +1,223 @@
+#include "girepository.h"
+#include "gitypelib-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+static gchar *cache_dir;
+static guint8 *valid_data;
+static gsize valid_len;
+
+static DirEntry *
+get_entry (guint8 *data, guint16 index)
+{
+  Header *header = (Header *) data;
+
+  return (DirEntry *) &data[header->directory + (index - 1) * header->entry_blob_size];
+}
+
+static GITypelib *
+new_typelib (const guint8 *data)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+
+  typelib = g_typelib_new_from_memory (g_memdup (data, valid_len), valid_len, &error);
+  g_assert_no_error (error);
+
+  return typelib;
+}
+
+/* Returns the path of the stamp of @data, which only exists once the
+ * stamp directory was created */
+static gchar *
+get_stamp_path (const guint8 *data)
+{
+  gchar *base, *checksum, *path = NULL;
+  const gchar *name;
+  GDir *dir;
+
+  base = g_build_filename (cache_dir, "gobject-introspection", NULL);
+  dir = g_dir_open (base, 0, NULL);
+  g_assert (dir != NULL);
+  while ((name = g_dir_read_name (dir)) != NULL)
+    if (g_str_has_prefix (name, "validated-"))
+      break;
+  g_assert (name != NULL);
+
+  checksum = g_compute_checksum_for_data (G_CHECKSUM_SHA256, data, valid_len);
+  path = g_build_filename (base, name, checksum, NULL);
+
+  g_free (checksum);
+  g_dir_close (dir);
+  g_free (base);
+
+  return path;
+}
+
+static void
+check_validate_same (const guint8 *data)
+{
+  GITypelib *serial, *parallel;
+  GError *serial_error = NULL, *parallel_error = NULL;
+
+  serial = new_typelib (data);
+  parallel = new_typelib (data);
+
+  g_assert (!g_typelib_validate_full (serial, 0, &serial_error));
+  g_assert (!g_typelib_validate_full (parallel, G_TYPELIB_VALIDATE_PARALLEL, &parallel_error));
+  g_assert (serial_error != NULL && parallel_error != NULL);
+  g_assert_cmpint (serial_error->code, ==, parallel_error->code);
+  g_assert_cmpstr (serial_error->message, ==, parallel_error->message);
+
+  g_error_free (serial_error);
+  g_error_free (parallel_error);
+  g_typelib_free (serial);
+  g_typelib_free (parallel);
+}
+
+/* The first error in directory order is reported either way */
+static void
+test_parallel (void)
+{
+  Header *header = (Header *) valid_data;
+  guint8 *data;
+  guint16 last = header->n_local_entries;
+
+  g_assert_cmpuint (last, >=, 256);
+
+  data = g_memdup (valid_data, valid_len);
+  get_entry (data, last)->offset += 2;
+  check_validate_same (data);
+
+  get_entry (data, last / 2)->blob_type = BLOB_TYPE_UNION + 1;
+  check_validate_same (data);
+
+  get_entry (data, 2)->offset += 2;
+  check_validate_same (data);
+  g_free (data);
+}
+
+/* Must run before the stamp directory exists */
+static void
+test_stamp_write_failure (void)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+  gchar *blocker;
+
+  /* A file where the stamp directory should be created */
+  blocker = g_build_filename (cache_dir, "gobject-introspection", NULL);
+  g_assert (g_file_set_contents (blocker, "", 0, &error));
+  g_assert_no_error (error);
+
+  typelib = new_typelib (valid_data);
+  g_assert (g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_STAMP, &error));
+  g_assert_no_error (error);
+  g_typelib_free (typelib);
+
+  g_assert (g_file_test (blocker, G_FILE_TEST_IS_REGULAR));
+  g_unlink (blocker);
+  g_free (blocker);
+}
+
+static void
+test_stamp (void)
+{
+  GITypelib *typelib;
+  GError *error = NULL;
+  guint8 *data;
+  gchar *stamp, *corrupt_stamp;
+
+  typelib = new_typelib (valid_data);
+  g_assert (g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_STAMP, &error));
+  g_assert_no_error (error);
+  g_typelib_free (typelib);
+
+  stamp = get_stamp_path (valid_data);
+  g_assert (g_file_test (stamp, G_FILE_TEST_IS_REGULAR));
+
+  /* Once the file changed, the stamp does not apply */
+  data = g_memdup (valid_data, valid_len);
+  get_entry (data, 2)->offset += 2;
+  typelib = new_typelib (data);
+  g_assert (!g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_STAMP, &error));
+  g_assert_error (error, G_TYPELIB_ERROR, G_TYPELIB_ERROR_INVALID_DIRECTORY);
+  g_clear_error (&error);
+  g_typelib_free (typelib);
+
+  corrupt_stamp = get_stamp_path (data);
+  g_assert (!g_file_test (corrupt_stamp, G_FILE_TEST_EXISTS));
+
+  /* A stamp is trusted without validating again, which shows that it
+   * is used */
+  g_assert (g_file_set_contents (corrupt_stamp, "", 0, &error));
+  g_assert_no_error (error);
+  typelib = new_typelib (data);
+  g_assert (g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_STAMP, &error));
+  g_assert_no_error (error);
+  g_assert (!g_typelib_validate_full (typelib, 0, &error));
+  g_clear_error (&error);
+  g_typelib_free (typelib);
+
+  g_unlink (corrupt_stamp);
+  g_unlink (stamp);
+  g_free (corrupt_stamp);
+  g_free (stamp);
+  g_free (data);
+}
+
+static void
+remove_tree (const gchar *path)
+{
+  GDir *dir;
+  const gchar *name;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (dir != NULL)
+    {
+      while ((name = g_dir_read_name (dir)) != NULL)
+        {
+          gchar *child = g_build_filename (path, name, NULL);
+          remove_tree (child);
+          g_free (child);
+        }
+      g_dir_close (dir);
+      g_rmdir (path);
+    }
+  else
+    g_unlink (path);
+}
+
+int
+main(int argc, char **argv)
+{
+  GError *error = NULL;
+  const gchar *path;
+  gchar *contents;
+
+  /* Before anything looks up the cache directory */
+  cache_dir = g_dir_make_tmp ("gitestvalidate-XXXXXX", &error);
+  g_assert_no_error (error);
+  g_setenv ("XDG_CACHE_HOME", cache_dir, TRUE);
+
+  /* Gio has enough entries to be validated in parallel */
+  g_assert (g_irepository_require (NULL, "Gio", "2.0", 0, &error));
+  g_assert_no_error (error);
+  path = g_irepository_get_typelib_path (NULL, "Gio");
+  g_assert (g_file_get_contents (path, &contents, &valid_len, &error));
+  g_assert_no_error (error);
+  valid_data = (guint8 *) contents;
+
+  test_parallel ();
+  test_stamp_write_failure ();
+  test_stamp ();
+
+  remove_tree (cache_dir);
+  g_free (cache_dir);
+  g_free (valid_data);
+
+  exit(0);
+}
@@ -0,0 +1,77 @@
+#include "girepository.h"
+#include "girwriter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+/* The typelibs built in the tree */
+static const char *namespaces[] = {
+  "GLib", "GObject", "Gio", "Utility", "Regress",
+  "Everything", "GIMarshallingTests"
+};
+
+static gchar *
+write_gir (const gchar *tmpdir,
+           const gchar *namespace,
+           gboolean     show_all)
+{
+  GError *error = NULL;
+  gchar *path, *contents;
+
+  path = g_build_filename (tmpdir, "output.gir", NULL);
+  gir_writer_write (path, namespace, FALSE, show_all);
+  g_assert (g_file_get_contents (path, &contents, NULL, &error));
+  g_assert_no_error (error);
+  g_unlink (path);
+  g_free (path);
+
+  return contents;
+}
+
+/* The output must be the same as when every fragment was formatted
+ * with g_markup_vprintf_escaped() */
+static void
+check_namespace (const gchar *tmpdir,
+                 const gchar *namespace,
+                 gboolean     show_all)
+{
+  gchar *expected, *output;
+
+  _gir_writer_set_markup_printf (TRUE);
+  expected = write_gir (tmpdir, namespace, show_all);
+  _gir_writer_set_markup_printf (FALSE);
+  output = write_gir (tmpdir, namespace, show_all);
+
+  g_assert (strlen (output) > 0);
+  g_assert_cmpstr (output, ==, expected);
+
+  g_free (expected);
+  g_free (output);
+}
+
+int
+main(int argc, char **argv)
+{
+  GError *error = NULL;
+  gchar *tmpdir;
+  guint i;
+
+  tmpdir = g_dir_make_tmp ("gitestwriter-XXXXXX", &error);
+  g_assert_no_error (error);
+
+  for (i = 0; i < G_N_ELEMENTS (namespaces); i++)
+    {
+      g_assert (g_irepository_require (NULL, namespaces[i], NULL, 0, &error));
+      g_assert_no_error (error);
+
+      check_namespace (tmpdir, namespaces[i], FALSE);
+      check_namespace (tmpdir, namespaces[i], TRUE);
+    }
+
+  g_rmdir (tmpdir);
+  g_free (tmpdir);
+
+  exit(0);
+}
@@ -303,6 +303,317 @@ test_instance_transfer_ownership (GIRepository * repo)
   g_base_info_unref (testobj_info);
 }
 
+static void
+test_find_by_gtype (GIRepository * repo)
+{
+  GITypelib *ret;
+  GError *error = NULL;
+  gint n_infos, i;
+
+  ret = g_irepository_require (repo, "GIMarshallingTests", NULL, 0, &error);
+  if (!ret)
+    g_error ("%s", error->message);
+
+  n_infos = g_irepository_get_n_infos (repo, "GIMarshallingTests");
+
+  for (i = 0; i < n_infos; i++)
+    {
+      GIBaseInfo *info;
+      GIBaseInfo *found;
+      GType gtype;
+
+      info = g_irepository_get_info (repo, "GIMarshallingTests", i);
+      if (!GI_IS_REGISTERED_TYPE_INFO (info))
+        {
+          g_base_info_unref (info);
+          continue;
+        }
+
+      gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
+      if (gtype == G_TYPE_NONE)
+        {
+          g_base_info_unref (info);
+          continue;
+        }
+
+      found = g_irepository_find_by_gtype (repo, gtype);
+      if (found == NULL)
+        g_error ("Could not find GIMarshallingTests.%s by GType %s",
+                 g_base_info_get_name (info), g_type_name (gtype));
+      g_assert (g_base_info_equal (info, found));
+
+      g_base_info_unref (found);
+      g_base_info_unref (info);
+    }
+}
+
+static void
+test_find_members (GIRepository * repo)
+{
+  GIObjectInfo *testobj_info;
+  gint n, i;
+
+  g_assert (g_irepository_require (repo, "Regress", NULL, 0, NULL));
+  testobj_info = g_irepository_find_by_name (repo, "Regress", "TestObj");
+  g_assert (testobj_info != NULL);
+
+  /* Indexed or not, lookups must agree with the accessors; the index
+   * itself is covered by gitestmemberindex */
+  n = g_object_info_get_n_methods (testobj_info);
+  for (i = 0; i < n; i++)
+    {
+      GIFunctionInfo *method, *found;
+
+      method = g_object_info_get_method (testobj_info, i);
+      found = g_object_info_find_method (testobj_info, g_base_info_get_name (method));
+      g_assert (found != NULL);
+      g_assert (g_base_info_equal (method, found));
+      g_base_info_unref (found);
+      g_base_info_unref (method);
+    }
+
+  n = g_object_info_get_n_signals (testobj_info);
+  for (i = 0; i < n; i++)
+    {
+      GISignalInfo *signal, *found;
+
+      signal = g_object_info_get_signal (testobj_info, i);
+      found = g_object_info_find_signal (testobj_info, g_base_info_get_name (signal));
+      g_assert (found != NULL);
+      g_assert (g_base_info_equal (signal, found));
+      g_base_info_unref (found);
+      g_base_info_unref (signal);
+    }
+
+  n = g_object_info_get_n_vfuncs (testobj_info);
+  for (i = 0; i < n; i++)
+    {
+      GIVFuncInfo *vfunc, *found;
+
+      vfunc = g_object_info_get_vfunc (testobj_info, i);
+      found = g_object_info_find_vfunc (testobj_info, g_base_info_get_name (vfunc));
+      g_assert (found != NULL);
+      g_assert (g_base_info_equal (vfunc, found));
+      g_base_info_unref (found);
+      g_base_info_unref (vfunc);
+    }
+
+  g_assert (g_object_info_find_method (testobj_info, "this_does_not_exist") == NULL);
+  g_assert (g_object_info_find_signal (testobj_info, "this-does-not-exist") == NULL);
+  g_assert (g_object_info_find_vfunc (testobj_info, "this_does_not_exist") == NULL);
+
+  g_base_info_unref (testobj_info);
+}
+
+static void
+test_resolve_gtypes (GIRepository * repo)
+{
+  GIBaseInfo *info;
+  GThread *thread;
+  guint n_resolved, n_registered;
+  gint i, n_infos;
+
+  g_assert (g_irepository_require (repo, "GObject", NULL, 0, NULL));
+  g_assert (g_irepository_require (repo, "Regress", NULL, 0, NULL));
+
+  /* Racing the lookups below must be harmless */
+  thread = g_irepository_resolve_gtypes_in_thread (repo, "Regress");
+  g_assert (thread != NULL);
+
+  n_resolved = g_irepository_resolve_gtypes (repo, "GObject");
+  g_assert_cmpuint (n_resolved, >, 0);
+  /* Everything is cached now, and resolves the same */
+  g_assert_cmpuint (g_irepository_resolve_gtypes (repo, "GObject"), ==, n_resolved);
+
+  info = g_irepository_find_by_name (repo, "GObject", "Object");
+  g_assert (info != NULL);
+  g_assert (g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info) == G_TYPE_OBJECT);
+  g_assert (g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info) == G_TYPE_OBJECT);
+  g_base_info_unref (info);
+
+  /* The thread ran every type_init function of Regress */
+  n_resolved = GPOINTER_TO_UINT (g_thread_join (thread));
+  g_assert_cmpuint (n_resolved, >, 0);
+  g_assert_cmpuint (g_irepository_resolve_gtypes (repo, "Regress"), ==, n_resolved);
+
+  n_registered = 0;
+  n_infos = g_irepository_get_n_infos (repo, "Regress");
+  for (i = 0; i < n_infos; i++)
+    {
+      info = g_irepository_get_info (repo, "Regress", i);
+      if (GI_IS_REGISTERED_TYPE_INFO (info) &&
+          g_registered_type_info_get_type_init ((GIRegisteredTypeInfo *) info) != NULL)
+        {
+          const gchar *type_name = g_registered_type_info_get_type_name ((GIRegisteredTypeInfo *) info);
+
+          g_assert (g_type_from_name (type_name) != G_TYPE_INVALID);
+          n_registered++;
+        }
+      g_base_info_unref (info);
+    }
+  g_assert_cmpuint (n_registered, ==, n_resolved);
+
+  info = g_irepository_find_by_name (repo, "Regress", "TestObj");
+  g_assert (info != NULL);
+  g_assert_cmpstr (g_type_name (g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info)),
+                   ==, "RegressTestObj");
+  g_base_info_unref (info);
+}
+
+static void
+test_resolve_symbols (GIRepository * repo)
+{
+  GIBaseInfo *info;
+  GIArgument in_arg, return_value;
+  GITypelib *typelib;
+  gpointer address;
+  guint n_resolved;
+  GError *error = NULL;
+
+  typelib = g_irepository_require (repo, "Regress", NULL, 0, NULL);
+  g_assert (typelib != NULL);
+
+  n_resolved = g_irepository_resolve_symbols (repo, "Regress");
+  g_assert_cmpuint (n_resolved, >, 0);
+  g_assert_cmpuint (g_irepository_resolve_symbols (repo, "Regress"), ==, n_resolved);
+
+  info = g_irepository_find_by_name (repo, "Regress", "test_int");
+  g_assert (info != NULL);
+  in_arg.v_int = 42;
+  g_assert (g_function_info_invoke ((GIFunctionInfo *) info, &in_arg, 1,
+                                    NULL, 0, &return_value, &error));
+  g_assert_no_error (error);
+  g_assert_cmpint (return_value.v_int, ==, 42);
+  g_base_info_unref (info);
+
+  info = g_irepository_find_by_name (repo, "Regress", "TestFundamentalObject");
+  g_assert (info != NULL);
+  g_assert (g_typelib_symbol (typelib, "regress_test_fundamental_object_ref", &address));
+  g_assert (g_object_info_get_ref_function_pointer ((GIObjectInfo *) info) == address);
+  g_base_info_unref (info);
+
+  /* Unknown symbols still fail */
+  g_assert (!g_typelib_symbol (typelib, "regress_no_such_symbol", &address));
+  g_assert (!g_typelib_symbol (typelib, "regress_no_such_symbol", &address));
+}
+
+static void
+test_field_offsets (GIRepository * repo)
+{
+  static const gchar *field_names[] = {
+    "parent_class", "matrix", "allow_none_vfunc", "test_signal",
+    "test_signal_with_static_scope_arg", "complex_vfunc",
+    "_regress_reserved1", "_regress_reserved2"
+  };
+  GIStructInfo *class_info;
+  gint n, i;
+
+  g_assert (g_irepository_require (repo, "Regress", NULL, 0, NULL));
+  class_info = g_irepository_find_by_name (repo, "Regress", "TestObjClass");
+  g_assert (class_info != NULL);
+
+  /* The vfunc fields embed their callback type, so the fields following
+   * them are found through the field offset table */
+  n = g_struct_info_get_n_fields (class_info);
+  g_assert_cmpint (n, ==, G_N_ELEMENTS (field_names));
+  for (i = n - 1; i >= 0; i--)
+    {
+      GIFieldInfo *field;
+
+      field = g_struct_info_get_field (class_info, i);
+      g_assert_cmpstr (g_base_info_get_name (field), ==, field_names[i]);
+      g_base_info_unref (field);
+    }
+
+  g_base_info_unref (class_info);
+}
+
+static void
+check_gtype_namespace (GIRepository *repo,
+                       GType         gtype,
+                       const gchar  *namespace,
+                       const gchar  *name)
+{
+  GIBaseInfo *info;
+
+  info = g_irepository_find_by_gtype (repo, gtype);
+  if (info == NULL)
+    g_error ("Could not find %s by GType", g_type_name (gtype));
+  g_assert_cmpstr (g_base_info_get_namespace (info), ==, namespace);
+  g_assert_cmpstr (g_base_info_get_name (info), ==, name);
+  g_base_info_unref (info);
+}
+
+static void
+test_find_by_gtype_prefixes (GIRepository *repo)
+{
+  GIBaseInfo *info;
+  GType gtype;
+
+  g_assert (g_irepository_require (repo, "Gio", NULL, 0, NULL));
+  g_assert (g_irepository_require (repo, "GIMarshallingTests", NULL, 0, NULL));
+
+  /* GLib, GObject and Gio all use the "G" prefix */
+  check_gtype_namespace (repo, G_TYPE_OBJECT, "GObject", "Object");
+  check_gtype_namespace (repo, G_TYPE_MAIN_LOOP, "GLib", "MainLoop");
+  info = g_irepository_find_by_name (repo, "Gio", "File");
+  g_assert (info != NULL);
+  gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
+  g_base_info_unref (info);
+  check_gtype_namespace (repo, gtype, "Gio", "File");
+
+  /* "GIMarshallingTests" extends "G", the longer prefix must be found too */
+  info = g_irepository_find_by_name (repo, "GIMarshallingTests", "Object");
+  g_assert (info != NULL);
+  gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
+  g_base_info_unref (info);
+  g_assert_cmpstr (g_type_name (gtype), ==, "GIMarshallingTestsObject");
+  check_gtype_namespace (repo, gtype, "GIMarshallingTests", "Object");
+
+  /* No loaded namespace has a matching prefix */
+  gtype = g_pointer_type_register_static ("XyzzyTypelibTestPointer");
+  g_assert (g_irepository_find_by_gtype (repo, gtype) == NULL);
+  g_assert (g_irepository_find_by_gtype (repo, gtype) == NULL);
+
+  /* A prefix only matches at a word boundary */
+  gtype = g_pointer_type_register_static ("Gtypelibtestpointer");
+  g_assert (g_irepository_find_by_gtype (repo, gtype) == NULL);
+}
+
+static void
+test_find_by_gtype_negative_cache (GIRepository *repo)
+{
+  GType gtype;
+  guint hits, negative_hits, misses;
+  guint negative_hits_before, misses_before;
+
+  g_assert (g_irepository_require (repo, "GIMarshallingTests", NULL, 0, NULL));
+
+  /* A type which is not part of any typelib */
+  gtype = g_pointer_type_register_static ("GITypelibTestPrivatePointer");
+
+  g_irepository_get_gtype_cache_stats (repo, NULL, &negative_hits_before, &misses_before);
+
+  g_assert (g_irepository_find_by_gtype (repo, gtype) == NULL);
+  g_irepository_get_gtype_cache_stats (repo, &hits, &negative_hits, &misses);
+  g_assert_cmpuint (misses, ==, misses_before + 1);
+  g_assert_cmpuint (negative_hits, ==, negative_hits_before);
+
+  g_assert (g_irepository_find_by_gtype (repo, gtype) == NULL);
+  g_irepository_get_gtype_cache_stats (repo, &hits, &negative_hits, &misses);
+  g_assert_cmpuint (misses, ==, misses_before + 1);
+  g_assert_cmpuint (negative_hits, ==, negative_hits_before + 1);
+
+  /* Loading a namespace forgets the types which weren't found */
+  if (!g_irepository_is_registered (repo, "GModule", NULL))
+    {
+      g_assert (g_irepository_require (repo, "GModule", NULL, 0, NULL));
+      g_assert (g_irepository_find_by_gtype (repo, gtype) == NULL);
+      g_irepository_get_gtype_cache_stats (repo, &hits, &negative_hits, &misses);
+      g_assert_cmpuint (misses, ==, misses_before + 2);
+    }
+}
+
 int
 main (int argc, char **argv)
 {
@@ -320,6 +631,13 @@ main (int argc, char **argv)
   test_char_types (repo);
   test_signal_array_len (repo);
   test_instance_transfer_ownership (repo);
+  test_find_by_gtype (repo);
+  test_find_by_gtype_prefixes (repo);
+  test_find_members (repo);
+  test_field_offsets (repo);
+  test_resolve_gtypes (repo);
+  test_resolve_symbols (repo);
+  test_find_by_gtype_negative_cache (repo);
 
   exit (0);
 }
@@ -0,0 +1,85 @@
+# Compares loading included namespaces from the pickle cache with the
+# memory mapped format of giscanner.namespacecache.
+#
+# Usage: bench_namespacecache.py [GIR...]
+# Defaults to the GLib, GObject and Gio GIRs of $top_builddir.
+
+import os
+import sys
+import mmap
+import time
+import cPickle
+import tempfile
+
+path = os.getenv('UNINSTALLED_INTROSPECTION_SRCDIR', None)
+assert path is not None
+sys.path.insert(0, path)
+
+from giscanner.girparser import GIRParser
+from giscanner.namespacecache import CachedNamespace, write_namespace
+
+ITERATIONS = 20
+
+
+def load_pickle(filename):
+    fp = open(filename, 'rb')
+    parser = cPickle.load(fp)
+    fp.close()
+    return parser.get_namespace()
+
+
+def load_cached(filename):
+    fp = open(filename, 'rb')
+    namespace = CachedNamespace(mmap.mmap(fp.fileno(), 0, access=mmap.ACCESS_READ))
+    fp.close()
+    return namespace
+
+
+def bench(load, filename, lookups):
+    start = time.time()
+    for i in xrange(ITERATIONS):
+        namespace = load(filename)
+        for name in lookups:
+            namespace.get(name)
+    return (time.time() - start) / ITERATIONS
+
+
+def main(args):
+    if not args:
+        builddir = os.environ.get('top_builddir', '.')
+        args = [os.path.join(builddir, gir)
+                for gir in ['GLib-2.0.gir', 'GObject-2.0.gir', 'Gio-2.0.gir']]
+
+    print '%-24s %8s %12s %12s %12s' % ('GIR', 'nodes', 'pickle',
+                                        'cached', 'cached+all')
+    for gir in args:
+        parser = GIRParser(types_only=True)
+        parser.parse(gir)
+        namespace = parser.get_namespace()
+        names = list(namespace)
+        # What a typical scanner run touches: a few dozen types
+        lookups = names[::max(1, len(names) // 50)]
+
+        pickle_fd, pickle_name = tempfile.mkstemp()
+        fp = os.fdopen(pickle_fd, 'wb')
+        cPickle.dump(parser, fp)
+        fp.close()
+
+        cached_fd, cached_name = tempfile.mkstemp()
+        fp = os.fdopen(cached_fd, 'wb')
+        write_namespace(namespace, fp)
+        fp.close()
+
+        try:
+            print '%-24s %8d %10.2fms %10.2fms %10.2fms' % (
+                os.path.basename(gir), len(names),
+                bench(load_pickle, pickle_name, lookups) * 1000,
+                bench(load_cached, cached_name, lookups) * 1000,
+                bench(load_cached, cached_name, names) * 1000)
+        finally:
+            os.unlink(pickle_name)
+            os.unlink(cached_name)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
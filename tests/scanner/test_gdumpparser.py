@@ -0,0 +1,181 @@
+import unittest
+import os
+import shutil
+import struct
+import sys
+import tempfile
+from cStringIO import StringIO
+from xml.etree.cElementTree import parse
+
+path = os.getenv('UNINSTALLED_INTROSPECTION_SRCDIR', None)
+assert path is not None
+sys.path.insert(0, path)
+
+from giscanner import utils
+from giscanner.gdumpparser import (DUMP_BINARY_MAGIC, GDumpParser,
+                                   IntrospectionBinary, parse_binary_dump,
+                                   _get_dump_cache_key)
+
+
+XML_DUMP = """<?xml version="1.0"?>
+<dump>
+  <class name="FooObject" get-type="foo_object_get_type" parents="GObject" abstract="1">
+    <implements name="FooInterface"/>
+    <property name="string" type="gchararray" flags="3"/>
+    <signal name="signal" return="void" when="last" detailed="1">
+      <param type="gint"/>
+    </signal>
+  </class>
+  <enum name="FooEnum" get-type="foo_enum_get_type">
+    <member name="FOO_ENUM_ALPHA" nick="alpha" value="0"/>
+    <member name="FOO_ENUM_BETA" nick="&lt;beta&gt;" value="-1"/>
+  </enum>
+  <error-quark function="foo_error_quark" domain="foo-error"/>
+</dump>
+"""
+
+
+def _string(string):
+    return struct.pack('<I', len(string)) + string
+
+
+def _encode(element):
+    # What g_irepository_dump() writes in binary mode
+    data = '<' + _string(element.tag)
+    for name, value in element.attrib.items():
+        data += '=' + _string(name) + _string(value)
+    for child in element:
+        data += _encode(child)
+    return data + '>'
+
+
+def _flatten(element):
+    return (element.tag, sorted(element.attrib.items()),
+            [_flatten(child) for child in element])
+
+
+class TestBinaryDump(unittest.TestCase):
+    def setUp(self):
+        self.xml_root = parse(StringIO(XML_DUMP)).getroot()
+        self.data = DUMP_BINARY_MAGIC + _encode(self.xml_root)
+
+    def test_same_tree(self):
+        root = parse_binary_dump(self.data).getroot()
+        self.assertEqual(_flatten(root), _flatten(self.xml_root))
+        self.assertEqual(root.findall('enum')[0].findall('member')[1].attrib['nick'],
+                         '<beta>')
+
+    def test_bad_magic(self):
+        self.assertRaises(ValueError, parse_binary_dump, XML_DUMP)
+
+    def test_truncated(self):
+        for length in (len(self.data) - 1, len(self.data) // 2,
+                       len(DUMP_BINARY_MAGIC) + 3):
+            self.assertRaises(ValueError, parse_binary_dump, self.data[:length])
+
+    def test_trailing_data(self):
+        self.assertRaises(ValueError, parse_binary_dump, self.data + '<')
+
+
+class TestDumpCacheKey(unittest.TestCase):
+    def setUp(self):
+        self.tmpdir = tempfile.mkdtemp()
+        self.dumper = self.write('g-ir-dumper', 'dumper')
+        self.library = self.write('libfoo.so', 'foo')
+        self.dependency = self.write('libbar.so', 'bar')
+
+    def tearDown(self):
+        shutil.rmtree(self.tmpdir)
+
+    def write(self, name, contents):
+        filename = os.path.join(self.tmpdir, name)
+        f = open(filename, 'w')
+        f.write(contents)
+        f.close()
+        return filename
+
+    def get_key(self):
+        binary = IntrospectionBinary([self.dumper, self.library], self.tmpdir,
+                                     libraries=[self.library],
+                                     dependencies=[self.dependency])
+        return _get_dump_cache_key(binary, 'get-type:foo_object_get_type\n')
+
+    def test_unchanged(self):
+        self.assertEqual(self.get_key(), self.get_key())
+
+    def test_changed_library(self):
+        key = self.get_key()
+        self.write('libfoo.so', 'FOO')
+        self.assertNotEqual(self.get_key(), key)
+
+    def test_changed_dependency(self):
+        key = self.get_key()
+        self.write('libbar.so', 'barbar')
+        self.assertNotEqual(self.get_key(), key)
+
+
+# Writes the XML dump to the output file of --introspect-dump, like a
+# program linked to a libgirepository without the binary dump format:
+# anything after the input file is the output file
+DUMPER = """import sys
+arg = [a for a in sys.argv if a.startswith('--introspect-dump=')][0]
+out_path = arg.split('=', 1)[1].split(',', 1)[1]
+f = open(out_path, 'w')
+f.write(%r)
+f.close()
+""" % (XML_DUMP, )
+
+
+class FakeTransformer(object):
+    namespace = None
+
+
+class TestExecuteBinary(unittest.TestCase):
+    def setUp(self):
+        self.saved_debug = os.environ.get('GI_SCANNER_DEBUG')
+        self.tmpdir = tempfile.mkdtemp()
+        self.dumper = os.path.join(self.tmpdir, 'dumper.py')
+        f = open(self.dumper, 'w')
+        f.write(DUMPER)
+        f.close()
+
+    def tearDown(self):
+        if self.saved_debug is None:
+            os.environ.pop('GI_SCANNER_DEBUG', None)
+        else:
+            os.environ['GI_SCANNER_DEBUG'] = self.saved_debug
+        utils._debugflags = None
+        shutil.rmtree(self.tmpdir)
+
+    def set_debug_flags(self, flags):
+        os.environ['GI_SCANNER_DEBUG'] = flags
+        utils._debugflags = None
+
+    def get_tree(self, binary):
+        parser = GDumpParser(FakeTransformer())
+        parser.set_introspection_binary(binary)
+        return parser._execute_binary_get_tree()
+
+    def get_failing_binary(self):
+        def fallback():
+            return IntrospectionBinary([sys.executable, self.dumper])
+        return IntrospectionBinary([sys.executable, '-c', 'raise SystemExit(1)'],
+                                   fallback=fallback)
+
+    def test_program(self):
+        tree = self.get_tree(IntrospectionBinary([sys.executable, self.dumper]))
+        self.assertEqual(_flatten(tree.getroot()),
+                         _flatten(parse(StringIO(XML_DUMP)).getroot()))
+
+    def test_fallback(self):
+        tree = self.get_tree(self.get_failing_binary())
+        self.assertEqual(_flatten(tree.getroot()),
+                         _flatten(parse(StringIO(XML_DUMP)).getroot()))
+
+    def test_no_fallback(self):
+        self.set_debug_flags('no-dumper-fallback')
+        self.assertRaises(SystemExit, self.get_tree, self.get_failing_binary())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,111 @@
+import unittest
+import tempfile
+import os
+import sys
+import mmap
+import shutil
+
+path = os.getenv('UNINSTALLED_INTROSPECTION_SRCDIR', None)
+assert path is not None
+sys.path.insert(0, path)
+
+from giscanner.cachestore import CacheStore
+from giscanner.girparser import GIRParser
+from giscanner.namespacecache import CachedNamespace, write_namespace
+
+
+class TestNamespaceCache(unittest.TestCase):
+    def setUp(self):
+        srcdir = os.environ.get('srcdir', os.path.dirname(__file__))
+        parser = GIRParser(types_only=True)
+        parser.parse(os.path.join(srcdir, 'Regress-1.0-expected.gir'))
+        self.namespace = parser.get_namespace()
+
+        tmp_fd, self.tmp_name = tempfile.mkstemp()
+        fp = os.fdopen(tmp_fd, 'wb')
+        write_namespace(self.namespace, fp)
+        fp.close()
+
+        fp = open(self.tmp_name, 'rb')
+        self.cached = CachedNamespace(mmap.mmap(fp.fileno(), 0,
+                                                access=mmap.ACCESS_READ))
+        fp.close()
+
+    def tearDown(self):
+        os.unlink(self.tmp_name)
+
+    def test_metadata(self):
+        self.assertEqual(self.cached.name, self.namespace.name)
+        self.assertEqual(self.cached.version, self.namespace.version)
+        self.assertEqual(self.cached.identifier_prefixes,
+                         self.namespace.identifier_prefixes)
+        self.assertEqual(self.cached.symbol_prefixes,
+                         self.namespace.symbol_prefixes)
+        self.assertEqual(sorted(str(i) for i in self.cached.includes),
+                         sorted(str(i) for i in self.namespace.includes))
+
+    def test_names(self):
+        self.assertEqual(list(self.cached), list(self.namespace))
+        for name, node in self.namespace.iteritems():
+            cached_node = self.cached.get(name)
+            self.assertEqual(type(cached_node), type(node))
+            self.assertEqual(cached_node.name, node.name)
+            self.assertTrue(cached_node.namespace is self.cached)
+            # Materialized once
+            self.assertTrue(self.cached.get(name) is cached_node)
+        self.assertTrue(self.cached.get('DoesNotExist') is None)
+        self.assertFalse('DoesNotExist' in self.cached)
+
+    def test_ctypes_and_gtypes(self):
+        for ctype, node in self.namespace.ctypes.iteritems():
+            if ctype is not None:
+                self.assertEqual(self.cached.get_by_ctype(ctype).name, node.name)
+        for gtype_name, node in self.namespace.type_names.iteritems():
+            self.assertEqual(self.cached.type_names.get(gtype_name).name, node.name)
+        self.assertTrue(self.cached.get_by_ctype(None) is None)
+
+
+class TestStoreNamespace(unittest.TestCase):
+    def setUp(self):
+        # Keep the cache entries and temporary files to ourselves
+        self.tmpdir = tempfile.mkdtemp()
+        self.environ = dict((name, os.environ.get(name))
+                            for name in ['HOME', 'GI_SCANNER_DISABLE_CACHE'])
+        os.environ['HOME'] = self.tmpdir
+        os.environ.pop('GI_SCANNER_DISABLE_CACHE', None)
+        self.tempdir = tempfile.tempdir
+        tempfile.tempdir = self.tmpdir
+
+        srcdir = os.environ.get('srcdir', os.path.dirname(__file__))
+        self.filename = os.path.join(srcdir, 'Regress-1.0-expected.gir')
+
+    def tearDown(self):
+        tempfile.tempdir = self.tempdir
+        for name, value in self.environ.items():
+            if value is None:
+                os.environ.pop(name, None)
+            else:
+                os.environ[name] = value
+        shutil.rmtree(self.tmpdir)
+
+    def store(self, types_only):
+        parser = GIRParser(types_only=types_only)
+        parser.parse(self.filename)
+        cachestore = CacheStore()
+        cachestore.store_namespace(self.filename, parser.get_namespace())
+        return cachestore.load_namespace(self.filename)
+
+    def test_types_only(self):
+        cached = self.store(True)
+        self.assertTrue(cached is not None)
+        self.assertEqual(cached.name, 'Regress')
+
+    def test_with_symbols(self):
+        # Not cached, and nothing left behind
+        self.assertTrue(self.store(False) is None)
+        self.assertEqual([name for name in os.listdir(self.tmpdir)
+                          if name.startswith('g-ir-scanner-cache-')], [])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,8 +1,10 @@
 import unittest
 import tempfile
 import os
+import shutil
 
-from giscanner.sourcescanner import SourceScanner
+from giscanner import utils
+from giscanner.sourcescanner import SourceScanner, CSYMBOL_TYPE_CONST
 
 
 two_typedefs_source = """
@@ -17,6 +19,30 @@ typedef struct _spam Spam;
 typedef struct _eggs Eggs;
 """
 
+macros_header = """
+#define HAVE_EXTRA 1
+#ifdef HAVE_EXTRA
+#include "extra.h"
+#endif
+#define REDEFINED_VALUE 2
+#undef REDEFINED_VALUE
+#define REDEFINED_VALUE 3
+#define UNDEFINED_VALUE 4
+#undef UNDEFINED_VALUE
+"""
+
+macros_extra_header = """
+#define EXTRA_VALUE 5
+"""
+
+
+def restore_environ(saved):
+    for name, value in saved.items():
+        if value is None:
+            os.environ.pop(name, None)
+        else:
+            os.environ[name] = value
+
 
 class Test(unittest.TestCase):
     def setUp(self):
@@ -37,5 +63,116 @@ class Test(unittest.TestCase):
         self.assertEqual(len(list(self.ss.get_comments())), 2)
 
 
+class TestSymbolCache(unittest.TestCase):
+    def setUp(self):
+        # Keep the cache entries away from the real home directory
+        self.tmpdir = tempfile.mkdtemp()
+        self.environ = dict((name, os.environ.get(name))
+                            for name in ['HOME', 'GI_SCANNER_DISABLE_CACHE'])
+        os.environ['HOME'] = self.tmpdir
+        os.environ.pop('GI_SCANNER_DISABLE_CACHE', None)
+
+        tmp_fd, self.header = tempfile.mkstemp(suffix='.h', dir=self.tmpdir)
+        file = os.fdopen(tmp_fd, 'wt')
+        file.write(two_typedefs_source)
+        file.write('#define SPAM_VALUE 42\n')
+        file.close()
+
+    def tearDown(self):
+        restore_environ(self.environ)
+        shutil.rmtree(self.tmpdir)
+
+    def scan(self):
+        ss = SourceScanner()
+        ss.parse_files([self.header])
+        return ss
+
+    def test_unchanged_header(self):
+        first = self.scan()
+        self.assertEqual(first._cached_symbols, [])
+        second = self.scan()
+        self.assertNotEqual(second._cached_symbols, [])
+
+        self.assertEqual([(s.ident, s.type) for s in first.get_symbols()],
+                         [(s.ident, s.type) for s in second.get_symbols()])
+        self.assertTrue('SPAM_VALUE' in [s.ident for s in second.get_symbols()])
+        self.assertEqual(first.get_comments(), second.get_comments())
+
+    def test_modified_header(self):
+        self.scan()
+        file = open(self.header, 'at')
+        file.write('typedef int Ham;\n')
+        file.close()
+
+        ss = self.scan()
+        self.assertEqual(ss._cached_symbols, [])
+        self.assertTrue('Ham' in [s.ident for s in ss.get_symbols()])
+
+    def test_disabled(self):
+        os.environ['GI_SCANNER_DISABLE_CACHE'] = '1'
+
+        def store_cache(*args):
+            self.fail('Entry built with the cache disabled')
+
+        for i in range(2):
+            ss = SourceScanner()
+            ss._store_cache = store_cache
+            ss.parse_files([self.header])
+            self.assertEqual(ss._cached_symbols, [])
+            self.assertTrue('SPAM_VALUE' in [s.ident for s in ss.get_symbols()])
+
+
+class TestCapturedMacros(unittest.TestCase):
+    def setUp(self):
+        self.tmpdir = tempfile.mkdtemp()
+        self.environ = {'GI_SCANNER_DISABLE_CACHE':
+                        os.environ.get('GI_SCANNER_DISABLE_CACHE')}
+        os.environ['GI_SCANNER_DISABLE_CACHE'] = '1'
+        self.debug = os.environ.get('GI_SCANNER_DEBUG')
+
+        self.headers = []
+        for name, contents in [('macros.h', macros_header),
+                               ('extra.h', macros_extra_header)]:
+            filename = os.path.join(self.tmpdir, name)
+            file = open(filename, 'wt')
+            file.write(contents)
+            file.close()
+            self.headers.append(filename)
+
+    def tearDown(self):
+        restore_environ(self.environ)
+        self.set_debug(self.debug)
+        shutil.rmtree(self.tmpdir)
+
+    def set_debug(self, value):
+        if value is None:
+            os.environ.pop('GI_SCANNER_DEBUG', None)
+        else:
+            os.environ['GI_SCANNER_DEBUG'] = value
+        # Read again by the next have_debug_flag()
+        utils._debugflags = None
+
+    def scan_macros(self):
+        ss = SourceScanner()
+        ss.set_cpp_options([self.tmpdir], [], [])
+        ss.parse_files(self.headers)
+        ss.parse_macros(self.headers)
+        return sorted((s.ident, s.const_int, s.source_filename, s.line)
+                      for s in ss.get_symbols()
+                      if s.type == CSYMBOL_TYPE_CONST)
+
+    def test_same_as_rescan(self):
+        self.set_debug(None)
+        captured = self.scan_macros()
+        self.set_debug('macro-rescan')
+        rescanned = self.scan_macros()
+
+        self.assertEqual(captured, rescanned)
+        idents = [macro[0] for macro in captured]
+        for ident in ['HAVE_EXTRA', 'EXTRA_VALUE', 'REDEFINED_VALUE',
+                      'UNDEFINED_VALUE']:
+            self.assertTrue(ident in idents)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -42,27 +42,30 @@ gchar *output = NULL;
 gchar *mname = NULL;
 gchar *shlib = NULL;
 gboolean include_cwd = FALSE;
+gboolean bundle = FALSE;
+gboolean typelib_includes = FALSE;
+gboolean batch = FALSE;
 gboolean debug = FALSE;
 gboolean verbose = FALSE;
 
+/* Writes to @filename, or to stdout if it is %NULL */
 static gboolean
-write_out_typelib (gchar *prefix,
-		   GITypelib *typelib)
+write_out_file (const gchar  *filename,
+		const guint8 *data,
+		gsize         len)
 {
   FILE *file;
   gsize written;
   GFile *file_obj;
-  gchar *filename;
   GFile *tmp_file_obj;
   gchar *tmp_filename;
   GError *error = NULL;
   gboolean success = FALSE;
 
-  if (output == NULL)
+  if (filename == NULL)
     {
       file = stdout;
       file_obj = NULL;
-      filename = NULL;
       tmp_filename = NULL;
       tmp_file_obj = NULL;
 #ifdef G_OS_WIN32
@@ -71,10 +74,6 @@ write_out_typelib (gchar *prefix,
     }
   else
     {
-      if (prefix)
-	filename = g_strdup_printf ("%s-%s", prefix, output);  
-      else
-	filename = g_strdup (output);
       file_obj = g_file_new_for_path (filename);
       tmp_filename = g_strdup_printf ("%s.tmp", filename);
       tmp_file_obj = g_file_new_for_path (tmp_filename);
@@ -88,14 +87,14 @@ write_out_typelib (gchar *prefix,
 	}
     }
 
-  written = fwrite (typelib->data, 1, typelib->len, file);
-  if (written < typelib->len) {
+  written = fwrite (data, 1, len, file);
+  if (written < len) {
     g_fprintf (stderr, "ERROR: Could not write the whole output: %s",
 	       strerror(errno));
     goto out;
   }
 
-  if (output != NULL)
+  if (filename != NULL)
     fclose (file);
   if (tmp_filename != NULL)
     {
@@ -108,12 +107,321 @@ write_out_typelib (gchar *prefix,
     }
   success = TRUE;
 out:
-  g_free (filename);
   g_free (tmp_filename);
 
   return success;
 }
 
+static gboolean
+write_out_data (gchar        *prefix,
+		const guint8 *data,
+		gsize         len)
+{
+  gchar *filename;
+  gboolean success;
+
+  if (output == NULL)
+    filename = NULL;
+  else if (prefix)
+    filename = g_strdup_printf ("%s-%s", prefix, output);
+  else
+    filename = g_strdup (output);
+
+  success = write_out_file (filename, data, len);
+
+  g_free (filename);
+
+  return success;
+}
+
+static gboolean
+write_out_typelib (gchar *prefix,
+		   GITypelib *typelib)
+{
+  return write_out_data (prefix, typelib->data, typelib->len);
+}
+
+static gint
+compare_bundle_names (gconstpointer a,
+		      gconstpointer b)
+{
+  return strcmp (*(const char **) a, *(const char **) b);
+}
+
+static void
+align_byte_array (GByteArray *array)
+{
+  static const guint8 zeros[8] = { 0, };
+
+  if (array->len % 8 != 0)
+    g_byte_array_append (array, zeros, 8 - array->len % 8);
+}
+
+/* Packs the typelibs given as input into a single bundle, checking that
+ * every dependency of every typelib is part of it.
+ */
+static gboolean
+write_out_bundle (void)
+{
+  GHashTable *typelibs; /* namespace-version -> GITypelib */
+  GPtrArray *names;
+  GByteArray *out;
+  BundleHeader *header;
+  BundleEntry *entries;
+  GHashTableIter iter;
+  gpointer key, value;
+  gboolean success = FALSE;
+  guint i;
+
+  typelibs = g_hash_table_new_full (g_str_hash, g_str_equal,
+				    g_free, (GDestroyNotify) g_typelib_free);
+
+  for (i = 0; input[i]; i++)
+    {
+      GError *error = NULL;
+      gchar *contents;
+      gsize len;
+      GITypelib *typelib;
+      Header *typelib_header;
+      gchar *name;
+
+      if (!g_file_get_contents (input[i], &contents, &len, &error))
+	{
+	  g_fprintf (stderr, "ERROR: %s\n", error->message);
+	  g_clear_error (&error);
+	  goto out;
+	}
+
+      typelib = g_typelib_new_from_memory ((guint8 *) contents, len, &error);
+      if (typelib == NULL ||
+	  !g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_PARALLEL, &error))
+	{
+	  g_fprintf (stderr, "ERROR: invalid typelib %s: %s\n",
+		     input[i], error->message);
+	  g_clear_error (&error);
+	  if (typelib)
+	    g_typelib_free (typelib);
+	  else
+	    g_free (contents);
+	  goto out;
+	}
+
+      typelib_header = (Header *) typelib->data;
+      name = g_strdup_printf ("%s-%s",
+			      g_typelib_get_string (typelib, typelib_header->namespace),
+			      g_typelib_get_string (typelib, typelib_header->nsversion));
+      if (g_hash_table_lookup (typelibs, name) != NULL)
+	{
+	  g_fprintf (stderr, "ERROR: %s is given more than once\n", name);
+	  g_free (name);
+	  g_typelib_free (typelib);
+	  goto out;
+	}
+      g_hash_table_insert (typelibs, name, typelib);
+    }
+
+  /* The bundle must be closed under dependencies */
+  g_hash_table_iter_init (&iter, typelibs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      GITypelib *typelib = value;
+      Header *typelib_header = (Header *) typelib->data;
+      gchar **dependencies;
+      gint j;
+
+      if (typelib_header->dependencies == 0)
+	continue;
+
+      dependencies = g_strsplit (g_typelib_get_string (typelib, typelib_header->dependencies), "|", 0);
+      for (j = 0; dependencies[j]; j++)
+	{
+	  if (g_hash_table_lookup (typelibs, dependencies[j]) == NULL)
+	    {
+	      g_fprintf (stderr, "ERROR: %s requires %s, which is not part of the bundle\n",
+			 (char *) key, dependencies[j]);
+	      g_strfreev (dependencies);
+	      goto out;
+	    }
+	}
+      g_strfreev (dependencies);
+    }
+
+  names = g_ptr_array_new ();
+  g_hash_table_iter_init (&iter, typelibs);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    g_ptr_array_add (names, key);
+  g_ptr_array_sort (names, compare_bundle_names);
+
+  /* Header and namespace table, then the names, then the typelibs */
+  out = g_byte_array_new ();
+  g_byte_array_set_size (out, sizeof (BundleHeader) + names->len * sizeof (BundleEntry));
+  memset (out->data, 0, out->len);
+
+  for (i = 0; i < names->len; i++)
+    {
+      const char *name = g_ptr_array_index (names, i);
+
+      entries = (BundleEntry *) (out->data + sizeof (BundleHeader));
+      entries[i].name = out->len;
+      g_byte_array_append (out, (const guint8 *) name, strlen (name) + 1);
+    }
+
+  for (i = 0; i < names->len; i++)
+    {
+      GITypelib *typelib = g_hash_table_lookup (typelibs, g_ptr_array_index (names, i));
+
+      align_byte_array (out);
+      entries = (BundleEntry *) (out->data + sizeof (BundleHeader));
+      entries[i].offset = out->len;
+      entries[i].size = typelib->len;
+      g_byte_array_append (out, typelib->data, typelib->len);
+    }
+
+  header = (BundleHeader *) out->data;
+  memcpy (header->magic, G_IR_BUNDLE_MAGIC, sizeof (header->magic));
+  header->size = out->len;
+  header->n_entries = names->len;
+  header->entries = sizeof (BundleHeader);
+
+  g_debug ("[bundle] %u typelibs, %u bytes", names->len, out->len);
+
+  success = write_out_data (NULL, out->data, out->len);
+
+  g_byte_array_free (out, TRUE);
+  g_ptr_array_free (names, TRUE);
+ out:
+  g_hash_table_destroy (typelibs);
+  return success;
+}
+
+typedef struct {
+  const gchar *input;
+  gchar *output;
+  GIrModule *module;
+  gboolean success;
+} BatchJob;
+
+static void
+build_batch_job (gpointer data,
+		 gpointer user_data)
+{
+  BatchJob *job = data;
+  GError *error = NULL;
+  GITypelib *typelib;
+
+  g_debug ("[building] module %s", job->module->name);
+
+  typelib = _g_ir_module_build_typelib (job->module);
+  if (typelib == NULL)
+    {
+      g_fprintf (stderr, "Failed to build typelib for module '%s'\n",
+		 job->module->name);
+      return;
+    }
+
+  if (!g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_PARALLEL, &error))
+    {
+      g_fprintf (stderr, "Invalid typelib for module '%s': %s\n",
+		 job->module->name, error->message);
+      g_clear_error (&error);
+    }
+  else
+    job->success = write_out_file (job->output, typelib->data, typelib->len);
+
+  g_typelib_free (typelib);
+}
+
+/* Name-Version.gir is compiled to Name-Version.typelib, in the output
+ * directory if one is given and next to the GIR otherwise. */
+static gchar *
+get_batch_output (const gchar *filename)
+{
+  gchar *basename, *dirname, *typelib_name, *result;
+
+  basename = g_path_get_basename (filename);
+  if (g_str_has_suffix (basename, ".gir"))
+    basename[strlen (basename) - strlen (".gir")] = '\0';
+  typelib_name = g_strconcat (basename, ".typelib", NULL);
+
+  dirname = output ? g_strdup (output) : g_path_get_dirname (filename);
+  result = g_build_filename (dirname, typelib_name, NULL);
+
+  g_free (basename);
+  g_free (dirname);
+  g_free (typelib_name);
+
+  return result;
+}
+
+/* Compiles every input with a single parser, so that the modules
+ * included by several inputs are only parsed once.  Parsing is not
+ * thread-safe, but the typelibs are built on a thread pool while the
+ * next inputs are parsed.
+ */
+static gboolean
+compile_batch (void)
+{
+  GIrParser *parser;
+  GThreadPool *pool;
+  BatchJob *jobs;
+  guint n_inputs, i;
+  gboolean success = TRUE;
+
+  n_inputs = g_strv_length (input);
+  jobs = g_new0 (BatchJob, n_inputs);
+
+  parser = _g_ir_parser_new ();
+  _g_ir_parser_set_includes (parser, (const char*const*) includedirs);
+  _g_ir_parser_set_typelib_includes (parser, typelib_includes);
+
+  pool = g_thread_pool_new (build_batch_job, NULL, g_get_num_processors (),
+			    FALSE, NULL);
+
+  for (i = 0; i < n_inputs; i++)
+    {
+      GError *error = NULL;
+
+      jobs[i].input = input[i];
+      jobs[i].output = get_batch_output (input[i]);
+
+      g_debug ("[parsing] %s", input[i]);
+
+      jobs[i].module = _g_ir_parser_parse_file (parser, input[i], &error);
+      if (jobs[i].module == NULL)
+	{
+	  g_fprintf (stderr, "error parsing file %s: %s\n",
+		     input[i], error->message);
+	  g_clear_error (&error);
+	  success = FALSE;
+	  continue;
+	}
+
+      /* Building adds entries to the module, it can't serve as an
+       * include of the next inputs. */
+      _g_ir_parser_take_module (parser, jobs[i].module);
+
+      g_thread_pool_push (pool, &jobs[i], NULL);
+    }
+
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  for (i = 0; i < n_inputs; i++)
+    {
+      if (jobs[i].module != NULL)
+	{
+	  if (!jobs[i].success)
+	    success = FALSE;
+	  _g_ir_module_free (jobs[i].module);
+	}
+      g_free (jobs[i].output);
+    }
+  g_free (jobs);
+
+  _g_ir_parser_free (parser);
+
+  return success;
+}
+
 GLogLevelFlags logged_levels;
 
 static void log_handler (const gchar *log_domain,
@@ -132,6 +440,9 @@ static GOptionEntry options[] =
   { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "output file", "FILE" }, 
   { "module", 'm', 0, G_OPTION_ARG_STRING, &mname, "module to compile", "NAME" }, 
   { "shared-library", 'l', 0, G_OPTION_ARG_FILENAME, &shlib, "shared library", "FILE" }, 
+  { "bundle", 0, 0, G_OPTION_ARG_NONE, &bundle, "pack the input typelibs into a bundle", NULL }, 
+  { "typelib-includes", 0, 0, G_OPTION_ARG_NONE, &typelib_includes, "load included namespaces from typelibs when available", NULL },
+  { "batch", 0, 0, G_OPTION_ARG_NONE, &batch, "compile every input, to the output directory if any", NULL }, 
   { "debug", 0, 0, G_OPTION_ARG_NONE, &debug, "show debug messages", NULL }, 
   { "verbose", 0, 0, G_OPTION_ARG_NONE, &verbose, "show verbose messages", NULL }, 
   { G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &input, NULL, NULL },
@@ -169,6 +480,24 @@ main (int argc, char ** argv)
       return 1;
     }
 
+  if (bundle)
+    return write_out_bundle () ? 0 : 1;
+
+  if (batch)
+    {
+      if (shlib)
+	{
+	  g_fprintf (stderr, "--shared-library can't be used with --batch\n");
+	  return 1;
+	}
+
+      if (includedirs != NULL)
+	for (i = 0; includedirs[i]; i++)
+	  g_irepository_prepend_search_path (includedirs[i]);
+
+      return compile_batch () ? 0 : 1;
+    }
+
   g_debug ("[parsing] start, %d includes", 
 	   includedirs ? g_strv_length (includedirs) : 0);
 
@@ -179,6 +508,7 @@ main (int argc, char ** argv)
   parser = _g_ir_parser_new ();
 
   _g_ir_parser_set_includes (parser, (const char*const*) includedirs);
+  _g_ir_parser_set_typelib_includes (parser, typelib_includes);
 
   module = _g_ir_parser_parse_file (parser, input[0], &error);
   if (module == NULL) 
@@ -208,7 +538,7 @@ main (int argc, char ** argv)
       typelib = _g_ir_module_build_typelib (module);
       if (typelib == NULL)
 	g_error ("Failed to build typelib for module '%s'\n", module->name);
-      if (!g_typelib_validate (typelib, &error))
+      if (!g_typelib_validate_full (typelib, G_TYPELIB_VALIDATE_PARALLEL, &error))
 	g_error ("Invalid typelib for module '%s': %s", 
 		 module->name, error->message);
 
@@ -0,0 +1,92 @@
+/* -*- mode: C; c-file-style: "gnu"; indent-tabs-mode: nil; -*-
+ * GObject introspection: Generic GType dumper
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Loads the shared libraries given on the command line and dumps
+ * their types, like the program g-ir-scanner otherwise compiles and
+ * links against the library on every run:
+ *
+ *   g-ir-dumper LIBRARY... --introspect-dump=input,output[,binary]
+ *
+ * The libraries are opened without G_MODULE_BIND_LOCAL, so that
+ * g_irepository_dump() finds their get_type and error quark functions
+ * when it looks them up in the program itself.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <gmodule.h>
+
+#include "girepository.h"
+
+static const char introspect_dump_prefix[] = "--introspect-dump=";
+
+static void
+usage (const char *prgname)
+{
+  g_printerr ("Usage: %s LIBRARY... --introspect-dump=input,output[,binary]\n", prgname);
+  exit (1);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *error = NULL;
+  const char *dump_arg = NULL;
+  int i;
+
+#if !GLIB_CHECK_VERSION(2,35,0)
+  g_type_init ();
+#endif
+
+  if (!g_module_supported ())
+    {
+      g_printerr ("%s: dynamic loading is not supported\n", argv[0]);
+      return 1;
+    }
+
+  for (i = 1; i < argc; i++)
+    {
+      if (g_str_has_prefix (argv[i], introspect_dump_prefix))
+        {
+          dump_arg = argv[i] + strlen (introspect_dump_prefix);
+          continue;
+        }
+
+      /* Never closed, the types stay registered until we exit */
+      if (g_module_open (argv[i], 0) == NULL)
+        {
+          g_printerr ("%s: %s\n", argv[0], g_module_error ());
+          return 1;
+        }
+    }
+
+  if (dump_arg == NULL)
+    usage (argv[0]);
+
+  if (!g_irepository_dump (dump_arg, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return 1;
+    }
+
+  return 0;
+}
@@ -28,6 +28,21 @@
 #include "girepository.h"
 #include "gitypelib-internal.h"
 
+typedef struct {
+  const gchar *output;
+  gboolean show_all;
+} WriteOptions;
+
+static void
+write_namespace (gpointer data,
+		 gpointer user_data)
+{
+  const char *namespace = data;
+  WriteOptions *options = user_data;
+
+  gir_writer_write (options->output, namespace, TRUE, options->show_all);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -38,7 +53,7 @@ main (int argc, char *argv[])
   gchar **input = NULL;
   GOptionContext *context;
   GError *error = NULL;
-  gboolean needs_prefix;
+  GPtrArray *namespaces;
   gint i;
   GOptionEntry options[] =
     {
@@ -69,6 +84,8 @@ main (int argc, char *argv[])
     for (i = 0; includedirs[i]; i++)
       g_irepository_prepend_search_path (includedirs[i]);
 
+  namespaces = g_ptr_array_new ();
+
   for (i = 0; input[i]; i++)
     {
       GError *error = NULL;
@@ -80,11 +97,6 @@ main (int argc, char *argv[])
       if (!mfile)
 	g_error ("failed to read '%s': %s", input[i], error->message);
 
-      if (input[i + 1] && output)
-	needs_prefix = TRUE;
-      else
-	needs_prefix = FALSE;
-
       typelib = g_typelib_new_from_mapped_file (mfile, &error);
       if (!typelib)
 	g_error ("failed to create typelib '%s': %s", input[i], error->message);
@@ -93,8 +105,8 @@ main (int argc, char *argv[])
 					      &error);
       if (namespace == NULL)
 	g_error ("failed to load typelib: %s", error->message);
-      
-      gir_writer_write (output, namespace, needs_prefix, show_all);
+
+      g_ptr_array_add (namespaces, (gpointer) namespace);
 
       /* when writing to stdout, stop after the first module */
       if (input[i + 1] && !output)
@@ -106,5 +118,28 @@ main (int argc, char *argv[])
 	}
     }
 
+  if (namespaces->len == 1)
+    {
+      gir_writer_write (output, namespaces->pdata[0], FALSE, show_all);
+    }
+  else
+    {
+      WriteOptions options;
+      GThreadPool *pool;
+      guint j;
+
+      /* Each namespace goes to its own Namespace-output file */
+      options.output = output;
+      options.show_all = show_all;
+
+      pool = g_thread_pool_new (write_namespace, &options,
+				g_get_num_processors (), FALSE, NULL);
+      for (j = 0; j < namespaces->len; j++)
+	g_thread_pool_push (pool, namespaces->pdata[j], NULL);
+      g_thread_pool_free (pool, FALSE, TRUE);
+    }
+
+  g_ptr_array_free (namespaces, TRUE);
+
   return 0;
 }